@@ -626,6 +626,36 @@ FT_BEGIN_HEADER
 #define TT_CONFIG_CMAP_FORMAT_14
 
 
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_CMAP_PAGES` to make CMap formats 4, 12, and 13 build
+   * a two-level lookup table of 256-entry pages for frequently used
+   * charmaps.  A page gets filled once 32 lookups have hit its block of
+   * 256 character codes, which makes `FT_Get_Char_Index` a constant time
+   * operation for text in a few scripts; sparsely used blocks are still
+   * searched.  Each page needs 512 bytes, plus 2kByte for each Unicode
+   * plane in use.  A charmap compiles at most 64 pages, so it needs at
+   * most 66kByte.
+   *
+   * Note that with this option, `FT_Get_Char_Index` modifies the face
+   * object; as with all other functions taking an `FT_Face`, calls for
+   * the same face must not run concurrently.
+   */
+#define TT_CONFIG_CMAP_PAGES
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_KERN_HASH` to make the first `FT_Get_Kerning` call
+   * on a face with a 'kern' table build a hash table of all kerning pairs,
+   * so that further lookups don't have to search every subtable.  The
+   * table needs at most 32 bytes per pair, plus 4 bytes per pair while it
+   * is being built; fonts with more than 65536 pairs are not hashed and
+   * get searched as before.
+   */
+#define TT_CONFIG_KERN_HASH
+
+
   /*************************************************************************/
   /*************************************************************************/
   /****                                                                 ****/
@@ -753,6 +753,18 @@
 #define FT_GASP_H  <freetype/ftgasp.h>
 
 
+  /**************************************************************************
+   *
+   * @macro:
+   *   FT_COVERAGE_H
+   *
+   * @description:
+   *   A macro used in `#include` statements to name the file containing the
+   *   FreeType~2 API which builds and queries character coverage sets.
+   */
+#define FT_COVERAGE_H  <freetype/ftcover.h>
+
+
   /**************************************************************************
    *
    * @macro:
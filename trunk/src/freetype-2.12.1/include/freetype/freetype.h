@@ -213,6 +213,7 @@ FT_BEGIN_HEADER
    *   FT_Get_Transform
    *   FT_Load_Glyph
    *   FT_Get_Char_Index
+   *   FT_Get_Char_Indices
    *   FT_Get_First_Char
    *   FT_Get_Next_Char
    *   FT_Get_Name_Index
@@ -252,6 +253,7 @@ FT_BEGIN_HEADER
    *   FT_Render_Glyph
    *   FT_Render_Mode
    *   FT_Get_Kerning
+   *   FT_Get_Kerning_Run
    *   FT_Kerning_Mode
    *   FT_Get_Track_Kerning
    *   FT_Get_Glyph_Name
@@ -3797,6 +3799,57 @@ FT_BEGIN_HEADER
                   FT_Vector  *akerning );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Get_Kerning_Run
+   *
+   * @description:
+   *   Return the kerning vectors between all adjacent glyphs of a glyph
+   *   run.  This is equivalent to calling @FT_Get_Kerning for each pair.
+   *   For SFNT-based fonts, the 'kern' table lookup and the scaling values
+   *   are set up only once for the whole run, which is noticeably faster
+   *   than separate calls; other font formats use the per-pair code.
+   *
+   * @input:
+   *   face ::
+   *     A handle to a source face object.
+   *
+   *   glyph_indices ::
+   *     An array of glyph indices in logical order.
+   *
+   *   count ::
+   *     The number of elements in `glyph_indices`.
+   *
+   *   kern_mode ::
+   *     See @FT_Kerning_Mode for more information.
+   *
+   * @output:
+   *   akernings ::
+   *     An array of `count` elements.  Element~i receives the kerning
+   *     vector between glyphs~i and~i+1, exactly as returned by
+   *     @FT_Get_Kerning; the last element is always set to zero.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   If the driver reports an error, the elements it couldn't determine
+   *   are set to zero and the error is returned.
+   *
+   *   Like @FT_Get_Kerning, this function does not support 'GPOS' kerning.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Get_Kerning_Run( FT_Face         face,
+                      const FT_UInt*  glyph_indices,
+                      FT_UInt         count,
+                      FT_UInt         kern_mode,
+                      FT_Vector      *akernings );
+
+
   /**************************************************************************
    *
    * @function:
@@ -4046,6 +4099,51 @@ FT_BEGIN_HEADER
                      FT_ULong  charcode );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Get_Char_Indices
+   *
+   * @description:
+   *   Return the glyph indices of an array of character codes, using the
+   *   currently selected charmap.  This is equivalent to calling
+   *   @FT_Get_Char_Index for each element but avoids the per-call overhead,
+   *   and some charmap formats map consecutive codes in bulk.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the source face object.
+   *
+   *   charcodes ::
+   *     An array of character codes.
+   *
+   *   count ::
+   *     The number of elements in `charcodes`.
+   *
+   * @output:
+   *   gindices ::
+   *     An array of `count` elements that receives the glyph indices.
+   *     0~means 'undefined character code'.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   If no charmap is selected, all glyph indices are set to~0.
+   *
+   *   `charcodes` and `gindices` may point to the same memory if
+   *   `FT_UInt` and `FT_UInt32` have the same size.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Get_Char_Indices( FT_Face           face,
+                       const FT_UInt32*  charcodes,
+                       FT_UInt           count,
+                       FT_UInt*          gindices );
+
+
   /**************************************************************************
    *
    * @function:
@@ -96,6 +96,11 @@ FT_BEGIN_HEADER
    *   directly.  (A small bitmap is one whose metrics and dimensions all fit
    *   into 8-bit integers).
    *
+   *   If the bitmaps end up in textures anyway, call @FTC_AtlasCache_New
+   *   followed by @FTC_AtlasCache_Lookup.  This renders glyphs directly
+   *   into a few large, shared @FTC_AtlasPageRec bitmaps and returns the
+   *   rectangle of each glyph within its page.
+   *
    *   We hope to also provide a kerning cache in the near future.
    *
    *
@@ -105,6 +110,24 @@ FT_BEGIN_HEADER
    *   FTC_Face_Requester
    *
    *   FTC_Manager_New
+   *   FTC_Lock_NewFunc
+   *   FTC_Lock_DoneFunc
+   *   FTC_Lock_Func
+   *   FTC_LockFuncsRec
+   *   FTC_Manager_SetLockFuncs
+   *   FTC_Store_FontKeyFunc
+   *   FTC_Store_WriteFunc
+   *   FTC_Manager_SetGlyphStore
+   *   FTC_Manager_SaveGlyphStore
+   *   FTC_ListStatsRec
+   *   FTC_CacheStatsRec
+   *   FTC_CacheStats
+   *   FTC_ManagerStatsRec
+   *   FTC_ManagerStats
+   *   FTC_Manager_GetStats
+   *   FTC_EvictionPolicy
+   *   FTC_Manager_SetEvictionPolicy
+   *   FTC_Manager_SetCacheMaxBytes
    *   FTC_Manager_Reset
    *   FTC_Manager_Done
    *   FTC_Manager_LookupFace
@@ -123,9 +146,18 @@ FT_BEGIN_HEADER
    *   FTC_SBitCache_New
    *   FTC_SBitCache_Lookup
    *
+   *   FTC_AtlasPage
+   *   FTC_AtlasPageRec
+   *   FTC_AtlasGlyph
+   *   FTC_AtlasGlyphRec
+   *   FTC_AtlasCache
+   *   FTC_AtlasCache_New
+   *   FTC_AtlasCache_Lookup
+   *
    *   FTC_CMapCache
    *   FTC_CMapCache_New
    *   FTC_CMapCache_Lookup
+   *   FTC_CMapCache_LookupMany
    *
    *************************************************************************/
 
@@ -320,6 +352,629 @@ FT_BEGIN_HEADER
                    FTC_Manager        *amanager );
 
 
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_Lock_NewFunc
+   *
+   * @description:
+   *   A callback function provided by client applications to create a new
+   *   lock object, for example a mutex.  See @FTC_LockFuncsRec.
+   *
+   * @input:
+   *   lock_data ::
+   *     The `lock_data` field of @FTC_LockFuncsRec.
+   *
+   * @output:
+   *   alock ::
+   *     A handle to the new lock, which must not be~0.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   */
+  typedef FT_Error
+  (*FTC_Lock_NewFunc)( FT_Pointer   lock_data,
+                       FT_Pointer  *alock );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_Lock_DoneFunc
+   *
+   * @description:
+   *   A callback function provided by client applications to destroy a
+   *   lock object created by @FTC_Lock_NewFunc.
+   *
+   * @input:
+   *   lock_data ::
+   *     The `lock_data` field of @FTC_LockFuncsRec.
+   *
+   *   lock ::
+   *     The lock to destroy.  It is not held.
+   */
+  typedef void
+  (*FTC_Lock_DoneFunc)( FT_Pointer  lock_data,
+                        FT_Pointer  lock );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_Lock_Func
+   *
+   * @description:
+   *   A callback function provided by client applications to acquire or
+   *   release a lock object created by @FTC_Lock_NewFunc.  Locks are never
+   *   acquired recursively by the same thread.
+   *
+   * @input:
+   *   lock ::
+   *     The lock to acquire or release.
+   */
+  typedef void
+  (*FTC_Lock_Func)( FT_Pointer  lock );
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_LockFuncsRec
+   *
+   * @description:
+   *   A structure used to make a cache manager safe for concurrent lookups
+   *   from several threads; see @FTC_Manager_SetLockFuncs.  FreeType does
+   *   not depend on any threading library; all locks are created and
+   *   operated through these callbacks.
+   *
+   * @fields:
+   *   lock_new ::
+   *     Create a new lock.
+   *
+   *   lock_done ::
+   *     Destroy a lock.
+   *
+   *   lock_acquire ::
+   *     Acquire a lock, blocking until it is available.
+   *
+   *   lock_release ::
+   *     Release a lock.
+   *
+   *   lock_data ::
+   *     A generic pointer passed to `lock_new` and `lock_done`.
+   */
+  typedef struct  FTC_LockFuncsRec_
+  {
+    FTC_Lock_NewFunc   lock_new;
+    FTC_Lock_DoneFunc  lock_done;
+    FTC_Lock_Func      lock_acquire;
+    FTC_Lock_Func      lock_release;
+    FT_Pointer         lock_data;
+
+  } FTC_LockFuncsRec;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SetLockFuncs
+   *
+   * @description:
+   *   Allow the lookup functions of all caches of a given manager to be
+   *   called concurrently from several threads.
+   *
+   *   The cache nodes are split into `num_shards` shards by their hash
+   *   value.  Each shard has its own lock, hash tables, and
+   *   most-recently-used list, so that lookups finding their node in the
+   *   cache only hold the lock of its shard for a short time.  Lookups
+   *   that must create or complete a node, and thus use an @FT_Face, are
+   *   serialized by an additional manager lock.  Nodes are evicted from
+   *   the least recently used end of each shard in turn, keeping the
+   *   total memory usage below the `max_bytes` limit shared by all shards.
+   *
+   * @inout:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   * @input:
+   *   funcs ::
+   *     The lock functions to use.  The structure is copied.
+   *
+   *   num_shards ::
+   *     The number of shards, between~1 and~64.  Use~0 for a default of~16.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   This function must be called before any cache is created with the
+   *   manager; it can be called only once.
+   *
+   *   Cache nodes can be flushed by another thread at any time unless
+   *   they are referenced.  A thread using a glyph image or small bitmap
+   *   returned by @FTC_ImageCache_Lookup or @FTC_SBitCache_Lookup must
+   *   therefore pass a non-NULL `anode` argument, and call
+   *   @FTC_Node_Unref when done with the data.
+   *
+   *   @FTC_Manager_LookupFace, @FTC_Manager_LookupSize,
+   *   @FTC_Manager_Reset, and @FTC_Manager_RemoveFaceID acquire the
+   *   manager lock.  However, the @FT_Face and @FT_Size objects returned by
+   *   the first two functions are also used by cache lookups in other
+   *   threads; accessing them is not synchronized.  @FTC_Manager_Done must
+   *   not be called concurrently with any other function.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_SetLockFuncs( FTC_Manager              manager,
+                            const FTC_LockFuncsRec*  funcs,
+                            FT_UInt                  num_shards );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_Store_FontKeyFunc
+   *
+   * @description:
+   *   A callback function provided by client applications to identify the
+   *   font file of a face in a glyph store; see
+   *   @FTC_Manager_SetGlyphStore.
+   *
+   * @input:
+   *   face_id ::
+   *     The face ID to identify.
+   *
+   *   key_data ::
+   *     The `key_data` argument passed to @FTC_Manager_SetGlyphStore.
+   *
+   * @output:
+   *   akey ::
+   *     A 128-bit key that changes whenever the glyphs of the face may
+   *     change, for example, a hash of the font file's path, size, and
+   *     modification time (or of its contents), together with the face
+   *     index.  If the client changes any driver property that affects
+   *     rendering, it must be part of the key, too.
+   *
+   * @return:
+   *   FreeType error code.  If non-zero, the glyphs of the face are neither
+   *   looked up in nor added to the store.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef FT_Error
+  (*FTC_Store_FontKeyFunc)( FTC_FaceID  face_id,
+                            FT_Pointer  key_data,
+                            FT_UInt32   akey[4] );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_Store_WriteFunc
+   *
+   * @description:
+   *   A callback function provided by client applications to write the
+   *   bytes of a glyph store; see @FTC_Manager_SaveGlyphStore.
+   *
+   * @input:
+   *   write_data ::
+   *     The `write_data` argument passed to @FTC_Manager_SaveGlyphStore.
+   *
+   *   bytes ::
+   *     The bytes to append to the output.
+   *
+   *   count ::
+   *     The number of bytes.
+   *
+   * @return:
+   *   FreeType error code.  0~means success; any other value aborts the
+   *   operation.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef FT_Error
+  (*FTC_Store_WriteFunc)( FT_Pointer      write_data,
+                          const FT_Byte*  bytes,
+                          FT_ULong        count );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SetGlyphStore
+   *
+   * @description:
+   *   Attach a persistent glyph store to a cache manager.  The store is a
+   *   block of memory, typically a memory-mapped file written by
+   *   @FTC_Manager_SaveGlyphStore in an earlier process, holding the
+   *   metrics and pixels of small glyph bitmaps.
+   *
+   *   When @FTC_SBitCache_Lookup or @FTC_SBitCache_LookupScaler miss, the
+   *   glyph is first searched in the store, keyed by the font key, the
+   *   scaler, the load flags, and the glyph index.  If found, the
+   *   returned @FTC_SBitRec points directly into the store and the glyph
+   *   is neither loaded nor rendered.  Otherwise, the glyph is rendered as
+   *   usual and remembered for the next @FTC_Manager_SaveGlyphStore call.
+   *
+   * @inout:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   * @input:
+   *   base ::
+   *     The store's bytes, aligned to a 32-bit boundary.  Can be `NULL` to
+   *     start with an empty store.  The memory must stay valid and
+   *     unchanged until @FTC_Manager_Done is called.
+   *
+   *   size ::
+   *     The size of the store in bytes.
+   *
+   *   key_func ::
+   *     The callback to identify font files.
+   *
+   *   key_data ::
+   *     A generic pointer passed to `key_func`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  If the store is not valid,
+   *   e.g., if it was written by a different FreeType version or on a
+   *   platform with a different byte order, `FT_Err_Invalid_File_Format`
+   *   or `FT_Err_Invalid_Version` is returned and no store is attached;
+   *   the client should then call this function again with an empty
+   *   store.
+   *
+   * @note:
+   *   This function can be called only once per manager.
+   *
+   *   The store is validated when attached, without reading the glyph
+   *   pixels, so that only the pages of glyphs actually used are read
+   *   from a memory-mapped file.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_SetGlyphStore( FTC_Manager            manager,
+                             const FT_Byte*         base,
+                             FT_ULong               size,
+                             FTC_Store_FontKeyFunc  key_func,
+                             FT_Pointer             key_data );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SaveGlyphStore
+   *
+   * @description:
+   *   Write a new glyph store, containing the glyphs of the attached store
+   *   and those rendered since, to be used with @FTC_Manager_SetGlyphStore
+   *   in a later process.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   *   write_func ::
+   *     The callback to write the bytes of the new store, in order.
+   *
+   *   write_data ::
+   *     A generic pointer passed to `write_func`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The output must not overwrite the memory of the attached store
+   *   while the manager exists; write a new file and rename it.
+   *
+   *   At most 4MByte of new bitmaps are remembered during the lifetime of
+   *   the manager.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_SaveGlyphStore( FTC_Manager          manager,
+                              FTC_Store_WriteFunc  write_func,
+                              FT_Pointer           write_data );
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_ListStatsRec
+   *
+   * @description:
+   *   Statistics of the face or size list of a cache manager; see
+   *   @FTC_ManagerStatsRec.
+   *
+   * @fields:
+   *   num_nodes ::
+   *     The number of faces or sizes currently opened.
+   *
+   *   max_nodes ::
+   *     The maximum number of faces or sizes, as passed to
+   *     @FTC_Manager_New.
+   *
+   *   hits ::
+   *     The number of lookups that found an opened face or size.
+   *
+   *   misses ::
+   *     The number of lookups that had to open a face or size.
+   *
+   *   evictions ::
+   *     The number of faces or sizes closed (or, for sizes, reused) to
+   *     make room for another one.  If this value grows along with
+   *     `misses`, `max_nodes` is probably too small for the workload.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct  FTC_ListStatsRec_
+  {
+    FT_UInt   num_nodes;
+    FT_UInt   max_nodes;
+    FT_ULong  hits;
+    FT_ULong  misses;
+    FT_ULong  evictions;
+
+  } FTC_ListStatsRec;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_CacheStatsRec
+   *
+   * @description:
+   *   Statistics of a single cache; see @FTC_Manager_GetStats.
+   *
+   * @fields:
+   *   hits ::
+   *     The number of lookups that found their node in the cache.  For
+   *     the small bitmap cache, a node holds several glyphs, and glyphs
+   *     that are not loaded yet are still counted as hits.
+   *
+   *   misses ::
+   *     The number of lookups that created a new node.
+   *
+   *   evictions ::
+   *     The number of nodes flushed to keep the total memory usage below
+   *     the manager's `max_bytes` limit, to make room after an
+   *     out-of-memory error, or by @FTC_Manager_Reset.  Nodes removed by
+   *     @FTC_Manager_RemoveFaceID are not counted.
+   *
+   *   num_nodes ::
+   *     The number of nodes currently in the cache.
+   *
+   *   num_bytes ::
+   *     The memory currently used by these nodes, as accounted against
+   *     the manager's `max_bytes` limit.
+   *
+   *   num_buckets ::
+   *     The current number of hash table buckets (summed over all shards
+   *     if @FTC_Manager_SetLockFuncs is used).  Tables grow when they hold
+   *     more than two nodes per bucket on average.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct  FTC_CacheStatsRec_
+  {
+    FT_ULong  hits;
+    FT_ULong  misses;
+    FT_ULong  evictions;
+    FT_ULong  num_nodes;
+    FT_ULong  num_bytes;
+    FT_ULong  num_buckets;
+
+  } FTC_CacheStatsRec, *FTC_CacheStats;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_ManagerStatsRec
+   *
+   * @description:
+   *   Statistics of a cache manager; see @FTC_Manager_GetStats.
+   *
+   * @fields:
+   *   max_bytes ::
+   *     The maximum memory usage of all cache nodes, as passed to
+   *     @FTC_Manager_New.
+   *
+   *   cur_bytes ::
+   *     The memory currently used by all cache nodes.
+   *
+   *   num_nodes ::
+   *     The current number of nodes in all caches.
+   *
+   *   faces ::
+   *     Statistics of the list of opened faces.
+   *
+   *   sizes ::
+   *     Statistics of the list of opened sizes.
+   *
+   *   num_caches ::
+   *     The number of caches created with the manager.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct  FTC_ManagerStatsRec_
+  {
+    FT_ULong          max_bytes;
+    FT_ULong          cur_bytes;
+    FT_ULong          num_nodes;
+
+    FTC_ListStatsRec  faces;
+    FTC_ListStatsRec  sizes;
+
+    FT_UInt           num_caches;
+
+  } FTC_ManagerStatsRec, *FTC_ManagerStats;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_GetStats
+   *
+   * @description:
+   *   Retrieve usage statistics of a cache manager and its caches, for
+   *   example to choose the `max_faces`, `max_sizes`, and `max_bytes`
+   *   arguments of @FTC_Manager_New.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   *   max_caches ::
+   *     The number of elements in `acaches`.
+   *
+   * @output:
+   *   astats ::
+   *     The statistics of the manager.
+   *
+   *   acaches ::
+   *     An array receiving the statistics of the manager's first
+   *     `max_caches` caches, in the order of their creation.  Can be
+   *     `NULL` if `max_caches` is zero.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The `hits`, `misses`, and `evictions` counters start at zero when
+   *   the manager (or the cache) is created and are never reset; compare
+   *   two calls to measure a given workload.
+   *
+   *   This function walks all cache nodes and should not be called in a
+   *   tight loop.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_GetStats( FTC_Manager       manager,
+                        FTC_ManagerStats  astats,
+                        FTC_CacheStats    acaches,
+                        FT_UInt           max_caches );
+
+
+  /**************************************************************************
+   *
+   * @enum:
+   *   FTC_EvictionPolicy
+   *
+   * @description:
+   *   An enumeration of the policies used by a cache manager to choose
+   *   the cache nodes to flush; see @FTC_Manager_SetEvictionPolicy.
+   *
+   * @values:
+   *   FTC_EVICTION_POLICY_LRU ::
+   *     Flush the least recently used nodes first.  This is the default.
+   *
+   *   FTC_EVICTION_POLICY_2Q ::
+   *     Keep new nodes on probation until they are used a second time.
+   *     Nodes on probation are flushed first, in least recently used
+   *     order; when nodes must be flushed, the least recently used nodes
+   *     are also put back on probation so that it holds at least a quarter
+   *     of them.
+   *     Lookups of many glyphs that are used only once, for example, when
+   *     rendering a character map or a document in a rare script, thus
+   *     don't flush the glyphs used repeatedly by a user interface.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef enum  FTC_EvictionPolicy_
+  {
+    FTC_EVICTION_POLICY_LRU = 0,
+    FTC_EVICTION_POLICY_2Q
+
+  } FTC_EvictionPolicy;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SetEvictionPolicy
+   *
+   * @description:
+   *   Select the policy used to flush cache nodes when the memory limits
+   *   of a manager or of one of its caches are reached.
+   *
+   * @inout:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   * @input:
+   *   policy ::
+   *     The eviction policy.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   This function must be called before any cache is created with the
+   *   manager.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_SetEvictionPolicy( FTC_Manager         manager,
+                                 FTC_EvictionPolicy  policy );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SetCacheMaxBytes
+   *
+   * @description:
+   *   Limit the memory used by the nodes of a single cache, in addition
+   *   to the `max_bytes` limit of the manager shared by all caches.  This
+   *   prevents, for example, a large image cache from flushing the nodes
+   *   of a small bitmap cache.
+   *
+   * @inout:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   * @input:
+   *   cache_index ::
+   *     The index of the cache in the order of creation, as in
+   *     @FTC_Manager_GetStats.
+   *
+   *   max_bytes ::
+   *     The maximum memory used by the cache's nodes.  Use~0 to only apply
+   *     the manager's limit, which is the default.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Nodes of the cache are flushed immediately if it exceeds the new
+   *   limit.  A cache can exceed its limit while all its nodes are
+   *   referenced.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_Manager_SetCacheMaxBytes( FTC_Manager  manager,
+                                FT_UInt      cache_index,
+                                FT_ULong     max_bytes );
+
+
   /**************************************************************************
    *
    * @function:
@@ -636,6 +1291,59 @@ FT_BEGIN_HEADER
                         FT_UInt32      char_code );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_CMapCache_LookupMany
+   *
+   * @description:
+   *   Translate an array of character codes into glyph indices, using the
+   *   charmap cache.
+   *
+   * @input:
+   *   cache ::
+   *     A charmap cache handle.
+   *
+   *   face_id ::
+   *     The source face ID.
+   *
+   *   cmap_index ::
+   *     The index of the charmap in the source face.  Any negative value
+   *     means to use the cache @FT_Face's default charmap.
+   *
+   *   char_codes ::
+   *     An array of character codes (in the corresponding charmap).
+   *
+   *   count ::
+   *     The number of elements in `char_codes`.
+   *
+   * @output:
+   *   gindices ::
+   *     An array of `count` elements that receives the glyph indices.
+   *     0~means 'no glyph'.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  In case of error, the
+   *   remaining elements of `gindices` are set to~0.
+   *
+   * @note:
+   *   The result is the same as calling @FTC_CMapCache_Lookup for each
+   *   element, but consecutive character codes that fall into the same
+   *   cache node are handled with a single node lookup.  Text in scripts
+   *   with large blocks, such as CJK ideographs, benefits most.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_CMapCache_LookupMany( FTC_CMapCache     cache,
+                            FTC_FaceID        face_id,
+                            FT_Int            cmap_index,
+                            const FT_UInt32*  char_codes,
+                            FT_UInt           count,
+                            FT_UInt*          gindices );
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*************************************************************************/
@@ -1076,6 +1784,258 @@ FT_BEGIN_HEADER
                               FTC_SBit      *sbit,
                               FTC_Node      *anode );
 
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_AtlasPage
+   *
+   * @description:
+   *   A handle to an atlas page.  See the @FTC_AtlasPageRec structure for
+   *   details.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct FTC_AtlasPageRec_*  FTC_AtlasPage;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_AtlasPageRec
+   *
+   * @description:
+   *   A page of an atlas cache, i.e., a bitmap shared by many glyphs,
+   *   typically mirrored by a texture of the same size.
+   *
+   * @fields:
+   *   bitmap ::
+   *     The page's pixels, using @FT_PIXEL_MODE_GRAY with 256~levels and a
+   *     positive pitch.  Pixels not covered by a glyph are zero.
+   *
+   *   index ::
+   *     The page index, in the range 0 to `max_pages`-1 (see
+   *     @FTC_AtlasCache_New).  Page handles and their indices are stable
+   *     during the lifetime of the cache.
+   *
+   *   serial ::
+   *     A counter incremented whenever the page's pixels change, i.e., if a
+   *     glyph is added or the page is cleared for reuse.  Compare it with
+   *     the value seen at the last upload to find out whether the texture
+   *     must be updated.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct  FTC_AtlasPageRec_
+  {
+    FT_Bitmap  bitmap;
+    FT_UInt    index;
+    FT_ULong   serial;
+
+  } FTC_AtlasPageRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_AtlasGlyph
+   *
+   * @description:
+   *   A handle to an atlas glyph descriptor.  See the @FTC_AtlasGlyphRec
+   *   structure for details.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct FTC_AtlasGlyphRec_*  FTC_AtlasGlyph;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_AtlasGlyphRec
+   *
+   * @description:
+   *   The location and metrics of a glyph bitmap stored in an atlas cache.
+   *
+   * @fields:
+   *   page ::
+   *     The page holding the glyph's pixels.  `NULL` for glyphs without
+   *     pixels, like spaces.
+   *
+   *   x ::
+   *     The horizontal position of the glyph's bitmap within the page.
+   *
+   *   y ::
+   *     The vertical position of the glyph's bitmap within the page,
+   *     counted from the top row.
+   *
+   *   width ::
+   *     The bitmap width in pixels.
+   *
+   *   height ::
+   *     The bitmap height in pixels.
+   *
+   *   left ::
+   *     The horizontal distance from the pen position to the left bitmap
+   *     border.
+   *
+   *   top ::
+   *     The vertical distance from the pen position (on the baseline) to the
+   *     upper bitmap border.  The distance is positive for upwards
+   *     y~coordinates.
+   *
+   *   xadvance ::
+   *     The horizontal advance width in 26.6 pixel format.
+   *
+   *   yadvance ::
+   *     The vertical advance height in 26.6 pixel format.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct  FTC_AtlasGlyphRec_
+  {
+    FTC_AtlasPage  page;
+    FT_UInt        x;
+    FT_UInt        y;
+    FT_UInt        width;
+    FT_UInt        height;
+    FT_Int         left;
+    FT_Int         top;
+    FT_Pos         xadvance;
+    FT_Pos         yadvance;
+
+  } FTC_AtlasGlyphRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_AtlasCache
+   *
+   * @description:
+   *   A handle to an atlas cache.  These are special cache objects that
+   *   store rendered glyphs side by side in a limited number of large
+   *   pages, so that the pages can be uploaded to textures as a whole.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef struct FTC_AtlasCacheRec_*  FTC_AtlasCache;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_AtlasCache_New
+   *
+   * @description:
+   *   Create a new cache to pack rendered glyph bitmaps into pages.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the source cache manager.
+   *
+   *   page_width ::
+   *     The width of each page in pixels.
+   *
+   *   page_height ::
+   *     The height of each page in pixels.
+   *
+   *   max_pages ::
+   *     The maximum number of pages.  Pages are allocated on demand.
+   *
+   * @output:
+   *   acache ::
+   *     A handle to the new atlas cache.  `NULL` in case of error.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Glyphs are placed on shelves, i.e., rows of glyphs with similar
+   *   heights, leaving a blank pixel to the right of and below each glyph.
+   *   Space is reclaimed page by page: when all glyphs of a page have been
+   *   flushed, the page is cleared and reused.  If no page has room for a
+   *   new glyph, the glyphs of the least recently used page are flushed
+   *   unless they are referenced by an @FTC_Node.
+   *
+   *   The pages themselves are not counted in the manager's `max_bytes`
+   *   limit, while each glyph counts with the area of its rectangle.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_AtlasCache_New( FTC_Manager      manager,
+                      FT_UInt          page_width,
+                      FT_UInt          page_height,
+                      FT_UInt          max_pages,
+                      FTC_AtlasCache  *acache );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_AtlasCache_Lookup
+   *
+   * @description:
+   *   Look up a given glyph in an atlas cache, rendering it into a page if
+   *   necessary, and 'lock' it to prevent its flushing from the cache until
+   *   needed.
+   *
+   * @input:
+   *   cache ::
+   *     A handle to the source atlas cache.
+   *
+   *   type ::
+   *     A pointer to the glyph image type descriptor.  @FT_LOAD_RENDER is
+   *     implied.
+   *
+   *   gindex ::
+   *     The glyph index.
+   *
+   * @output:
+   *   aglyph ::
+   *     A handle to the glyph's descriptor.
+   *
+   *   anode ::
+   *     Used to return the address of the corresponding cache node after
+   *     incrementing its reference count (see note below).
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   *   Glyphs that cannot be stored in a page (larger than a page or not
+   *   rendered to @FT_PIXEL_MODE_GRAY or @FT_PIXEL_MODE_MONO, like color
+   *   glyphs) return an error, so that the caller can use another cache
+   *   for them.
+   *
+   * @note:
+   *   Monochrome glyphs are stored with the values 0 and~255.
+   *
+   *   The glyph descriptor is owned by the cache.  If `anode` is _not_
+   *   `NULL`, it receives the address of the cache node containing the
+   *   glyph, after increasing its reference count.  This ensures that the
+   *   glyph keeps its place in the page until you call @FTC_Node_Unref to
+   *   'release' it.
+   *
+   *   If `anode` is `NULL`, the glyph may be flushed and its rectangle
+   *   overwritten on the next call to one of the caching sub-system APIs.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FTC_AtlasCache_Lookup( FTC_AtlasCache   cache,
+                         FTC_ImageType    type,
+                         FT_UInt          gindex,
+                         FTC_AtlasGlyph  *aglyph,
+                         FTC_Node        *anode );
+
   /* */
 
 
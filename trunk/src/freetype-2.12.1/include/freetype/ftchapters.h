@@ -118,6 +118,7 @@
    *   list_processing
    *   outline_processing
    *   quick_advance
+   *   character_coverage
    *   bitmap_handling
    *   raster
    *   glyph_stroker
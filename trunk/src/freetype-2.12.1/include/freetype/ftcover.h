@@ -0,0 +1,426 @@
+/****************************************************************************
+ *
+ * ftcover.h
+ *
+ *   FreeType character coverage sets (specification).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#ifndef FTCOVER_H_
+#define FTCOVER_H_
+
+#include <freetype/freetype.h>
+
+#ifdef FREETYPE_H
+#error "freetype.h of FreeType 1 has been loaded!"
+#error "Please fix the directory search order for header files"
+#error "so that freetype.h of FreeType 2 is found first."
+#endif
+
+
+FT_BEGIN_HEADER
+
+
+  /**************************************************************************
+   *
+   * @section:
+   *   character_coverage
+   *
+   * @title:
+   *   Character Coverage
+   *
+   * @abstract:
+   *   Compact sets of the character codes supported by a face.
+   *
+   * @description:
+   *   A coverage set records which character codes a face's charmap maps
+   *   to a glyph.  It is built once with @FT_Coverage_New and can then be
+   *   queried, combined with other sets, and serialized without touching
+   *   the face again.  This is mainly useful for font fallback, where a
+   *   client must find a face that supports a given code point among many
+   *   candidates: the sets of all candidates can be computed once and
+   *   stored on disk, and queries need neither open faces nor charmap
+   *   lookups.
+   *
+   *   Internally, character codes are grouped into blocks of 65536 codes.
+   *   A block with few entries is stored as a sorted array of 16-bit
+   *   values; a dense block is stored as a bitmap, so that set operations
+   *   can work on whole words.
+   */
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FT_Coverage
+   *
+   * @description:
+   *   A handle to a character coverage set.
+   */
+  typedef struct FT_CoverageRec_*  FT_Coverage;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_New
+   *
+   * @description:
+   *   Create a coverage set holding all character codes that the face's
+   *   current charmap maps to a valid glyph index.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the source face object.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The set contains exactly the character codes enumerated by
+   *   @FT_Get_First_Char and @FT_Get_Next_Char.  If the face has no
+   *   charmap selected, the set is empty.
+   *
+   *   The set does not depend on the face after creation; it can outlive
+   *   it.  It must be destroyed with @FT_Coverage_Done before the library
+   *   is destroyed, though.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_New( FT_Face       face,
+                   FT_Coverage  *acoverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_New_From_Chars
+   *
+   * @description:
+   *   Create a coverage set from an array of character codes.  This is
+   *   typically used to hold the code points of a query string for
+   *   @FT_Coverage_Count_Common.
+   *
+   * @input:
+   *   library ::
+   *     A handle to the library resource.
+   *
+   *   char_codes ::
+   *     An array of character codes, in any order.  Duplicates are allowed.
+   *
+   *   count ::
+   *     The number of elements in `char_codes`.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_New_From_Chars( FT_Library        library,
+                              const FT_UInt32*  char_codes,
+                              FT_UInt           count,
+                              FT_Coverage      *acoverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Done
+   *
+   * @description:
+   *   Destroy a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.  Can be NULL.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( void )
+  FT_Coverage_Done( FT_Coverage  coverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Get_Count
+   *
+   * @description:
+   *   Return the number of character codes in a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   * @return:
+   *   The number of character codes.  0~if `coverage` is NULL.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_ULong )
+  FT_Coverage_Get_Count( FT_Coverage  coverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Has_Char
+   *
+   * @description:
+   *   Check whether a character code is in a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   *   char_code ::
+   *     The character code.
+   *
+   * @return:
+   *   1~if the character code is in the set, 0~otherwise.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Bool )
+  FT_Coverage_Has_Char( FT_Coverage  coverage,
+                        FT_UInt32    char_code );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Check_Chars
+   *
+   * @description:
+   *   Check an array of character codes against a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   *   char_codes ::
+   *     An array of character codes.
+   *
+   *   count ::
+   *     The number of elements in `char_codes`.
+   *
+   * @output:
+   *   flags ::
+   *     If not NULL, an array of `count` elements that receives~1 for each
+   *     character code in the set and~0 otherwise.
+   *
+   * @return:
+   *   The number of elements of `char_codes` that are in the set.  The
+   *   face covers the whole array if this equals `count`.
+   *
+   * @note:
+   *   Lookups are fastest if `char_codes` is sorted, since the block of
+   *   the previous code is tried first.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_UInt )
+  FT_Coverage_Check_Chars( FT_Coverage       coverage,
+                           const FT_UInt32*  char_codes,
+                           FT_UInt           count,
+                           FT_Byte*          flags );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Count_Common
+   *
+   * @description:
+   *   Return the number of character codes contained in both of two
+   *   coverage sets.
+   *
+   * @input:
+   *   coverage1 ::
+   *     A handle to the first coverage set.
+   *
+   *   coverage2 ::
+   *     A handle to the second coverage set.
+   *
+   * @return:
+   *   The size of the intersection.  In particular, `coverage1` contains
+   *   all of `coverage2` if the result equals
+   *   @FT_Coverage_Get_Count(`coverage2`).
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_ULong )
+  FT_Coverage_Count_Common( FT_Coverage  coverage1,
+                            FT_Coverage  coverage2 );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Merge
+   *
+   * @description:
+   *   Add all character codes of a coverage set to another one.
+   *
+   * @inout:
+   *   target ::
+   *     A handle to the coverage set to be modified.
+   *
+   * @input:
+   *   source ::
+   *     A handle to the coverage set to be added.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   `target` is left unchanged in case of error.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_Merge( FT_Coverage  target,
+                     FT_Coverage  source );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Intersect
+   *
+   * @description:
+   *   Remove all character codes from a coverage set that are not in
+   *   another one.
+   *
+   * @inout:
+   *   target ::
+   *     A handle to the coverage set to be modified.
+   *
+   * @input:
+   *   source ::
+   *     A handle to the coverage set to be intersected with.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   `target` is left unchanged in case of error.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_Intersect( FT_Coverage  target,
+                         FT_Coverage  source );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Save
+   *
+   * @description:
+   *   Serialize a coverage set into a buffer.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   *   buffer ::
+   *     The target buffer.  If NULL, only the required size is computed.
+   *
+   * @inout:
+   *   alength ::
+   *     On input, the size of `buffer` in bytes (ignored if `buffer` is
+   *     NULL).  On output, the size of the serialized data.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  If `buffer` is too small,
+   *   `FT_Err_Invalid_Argument` is returned and `*alength` is set to the
+   *   required size.
+   *
+   * @note:
+   *   The format is independent of the platform's endianness and word
+   *   size; all numbers are stored in big-endian order.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_Save( FT_Coverage  coverage,
+                    FT_Byte*     buffer,
+                    FT_ULong    *alength );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_Coverage_Load
+   *
+   * @description:
+   *   Create a coverage set from data written by @FT_Coverage_Save.
+   *
+   * @input:
+   *   library ::
+   *     A handle to the library resource.
+   *
+   *   buffer ::
+   *     The serialized data.
+   *
+   *   length ::
+   *     The size of `buffer` in bytes.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  Malformed data is rejected
+   *   with `FT_Err_Invalid_File_Format`.
+   *
+   * @since:
+   *   2.13
+   */
+  FT_EXPORT( FT_Error )
+  FT_Coverage_Load( FT_Library      library,
+                    const FT_Byte*  buffer,
+                    FT_ULong        length,
+                    FT_Coverage    *acoverage );
+
+  /* */
+
+
+FT_END_HEADER
+
+#endif /* FTCOVER_H_ */
+
+
+/* END */
@@ -214,9 +214,10 @@ FT_BEGIN_HEADER
    *   itself, it is possible to control its behaviour with @FT_Property_Set
    *   and @FT_Property_Get.
    *
-   *   The TrueType driver's module name is 'truetype'; a single property
-   *   @interpreter-version is available, as documented in the @properties
-   *   section.
+   *   The TrueType driver's module name is 'truetype'; the properties
+   *   @interpreter-version, @hinted-cache-size, @interpreter-profiling, and
+   *   @interpreter-profile are available, as documented in the
+   *   @properties section.
    *
    *   To help understand the differences between interpreter versions, we
    *   introduce a list of definitions, kindly provided by Greg Hitchcock.
@@ -1213,6 +1214,508 @@ FT_BEGIN_HEADER
   } FT_Prop_IncreaseXHeight;
 
 
+  /**************************************************************************
+   *
+   * @property:
+   *   cell-pool-budget
+   *
+   * @description:
+   *   The smooth renderer converts outlines into a list of cells held in a
+   *   fixed-size pool on the stack.  If a glyph needs more cells than the
+   *   pool can hold, the rendering band is bisected and the outline is
+   *   decomposed once again for every band, which gets expensive for
+   *   complex outlines at large sizes.
+   *
+   *   Setting `cell-pool-budget` to a non-zero value makes the renderer use
+   *   a heap-allocated pool instead, which is kept and reused across calls.
+   *   It grows as needed up to the given number of bytes, so that most
+   *   glyphs are rendered in a single band.  Band bisection is only used
+   *   once the budget is exhausted.  The default value~0 disables the heap
+   *   pool; so does any budget smaller than the stack pool.
+   *
+   *   The value is an `FT_ULong`.
+   *
+   * @note:
+   *   This property can be used with @FT_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using values 0 or larger).
+   *
+   * @example:
+   *   ```
+   *     FT_Library  library;
+   *     FT_ULong    budget = 1024 * 1024;
+   *
+   *
+   *     FT_Init_FreeType( &library );
+   *
+   *     FT_Property_Set( library, "smooth",
+   *                               "cell-pool-budget", &budget );
+   *   ```
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   cell-pool-stats
+   *
+   * @description:
+   *   Read the counters of the smooth renderer's cell pool with
+   *   @FT_Property_Get, passing a pointer to an @FT_Prop_CellPoolStats
+   *   structure.  Setting this property with @FT_Property_Set resets all
+   *   counters; the value is ignored.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_Prop_CellPoolStats
+   *
+   * @description:
+   *   The data exchange structure for the @cell-pool-stats property.
+   *
+   * @fields:
+   *   renders ::
+   *     The number of outlines rendered.
+   *
+   *   bands ::
+   *     The number of bands rendered.  Each band needs its own
+   *     decomposition of the outline.
+   *
+   *   band_splits ::
+   *     The number of bands bisected because the cell pool overflowed.
+   *
+   *   pool_grows ::
+   *     The number of times the heap-allocated cell pool has been
+   *     (re)allocated.
+   *
+   *   pool_size ::
+   *     The current size of the heap-allocated cell pool in bytes.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+  typedef struct  FT_Prop_CellPoolStats_
+  {
+    FT_ULong  renders;
+    FT_ULong  bands;
+    FT_ULong  band_splits;
+    FT_ULong  pool_grows;
+    FT_ULong  pool_size;
+
+  } FT_Prop_CellPoolStats;
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FT_Parallel_JobFunc
+   *
+   * @description:
+   *   A function, provided by FreeType, that renders a single band of a
+   *   glyph.  It is handed to an @FT_Parallel_RunFunc executor.
+   *
+   * @input:
+   *   job_data ::
+   *     The `job_data` argument of the executor.
+   *
+   *   index ::
+   *     The index of the band, ranging from~0 to `count - 1`.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef void
+  (*FT_Parallel_JobFunc)( void*    job_data,
+                          FT_UInt  index );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FT_Parallel_RunFunc
+   *
+   * @description:
+   *   A function, provided by the client, that calls `job( job_data, i )`
+   *   for every index~`i` from~0 to `count - 1`, possibly concurrently on
+   *   different threads.  It must not return before all jobs have
+   *   completed.
+   *
+   * @input:
+   *   executor_data ::
+   *     The `executor_data` field of @FT_Prop_ParallelRaster.
+   *
+   *   count ::
+   *     The number of jobs.
+   *
+   *   job ::
+   *     The job function.
+   *
+   *   job_data ::
+   *     The data to pass to the job function.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef void
+  (*FT_Parallel_RunFunc)( void*                executor_data,
+                          FT_UInt              count,
+                          FT_Parallel_JobFunc  job,
+                          void*                job_data );
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   parallel-raster
+   *
+   * @description:
+   *   Let the smooth renderer split large glyphs into horizontal bands
+   *   that are rasterized concurrently by a client-provided executor,
+   *   typically a thread pool.  FreeType itself does not create threads.
+   *   Each band is converted with its own cell pool and writes a disjoint
+   *   set of bitmap rows, so the result is identical to serial rendering.
+   *
+   *   The value is a pointer to an @FT_Prop_ParallelRaster structure,
+   *   which gets copied.  Setting the `run` field to NULL, which is the
+   *   default, disables parallel rendering.
+   *
+   *   This affects @FT_Render_Glyph as well as @FT_Outline_Render and
+   *   @FT_Outline_Get_Bitmap with the smooth renderer, but only when
+   *   rendering into a bitmap; direct rendering with span callbacks stays
+   *   serial.
+   *
+   * @note:
+   *   This property can be used with @FT_Property_Get also.
+   *
+   * @example:
+   *   ```
+   *     FT_Library              library;
+   *     FT_Prop_ParallelRaster  prop;
+   *
+   *
+   *     FT_Init_FreeType( &library );
+   *
+   *     prop.run           = my_thread_pool_run;
+   *     prop.executor_data = my_thread_pool;
+   *     prop.max_jobs      = 4;
+   *     prop.min_rows      = 256;
+   *
+   *     FT_Property_Set( library, "smooth",
+   *                               "parallel-raster", &prop );
+   *   ```
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_Prop_ParallelRaster
+   *
+   * @description:
+   *   The data exchange structure for the @parallel-raster property.
+   *
+   * @fields:
+   *   run ::
+   *     The executor function; NULL disables parallel rendering.
+   *
+   *   executor_data ::
+   *     The first argument of `run`.
+   *
+   *   max_jobs ::
+   *     The maximum number of bands a glyph is split into.  Values below~2
+   *     disable parallel rendering.
+   *
+   *   min_rows ::
+   *     Glyphs with fewer rows are rendered serially.  Every band has at
+   *     least 64~rows anyway.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+  typedef struct  FT_Prop_ParallelRaster_
+  {
+    FT_Parallel_RunFunc  run;
+    void*                executor_data;
+    FT_UInt              max_jobs;
+    FT_UInt              min_rows;
+
+  } FT_Prop_ParallelRaster;
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   hinted-cache-size
+   *
+   * @description:
+   *   Let the TrueType driver keep the outlines produced by the bytecode
+   *   interpreter so that loading the same glyph again with the same size,
+   *   variation instance, interpreter version, and load flags doesn't run
+   *   the glyph's instructions again.  This is useful if hinted outlines
+   *   get rendered more than once, for example, at several subpixel
+   *   offsets or with different transformations.
+   *
+   *   The value is an `FT_ULong`, giving the maximum number of bytes used
+   *   for cached outlines per @FT_Size object; the least recently used
+   *   outlines are discarded first.  The default value~0 disables the
+   *   cache.
+   *
+   *   The cache of a size gets emptied whenever the size's hinting state
+   *   is reset, for example, by @FT_Set_Char_Size.
+   *
+   * @note:
+   *   This property can be used with @FT_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using values like '1048576').
+   *
+   * @example:
+   *   ```
+   *     FT_Library  library;
+   *     FT_ULong    cache_size = 1024 * 1024;
+   *
+   *
+   *     FT_Init_FreeType( &library );
+   *
+   *     FT_Property_Set( library, "truetype",
+   *                               "hinted-cache-size", &cache_size );
+   *   ```
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FT_Profile_ClockFunc
+   *
+   * @description:
+   *   A function, provided by the client, that returns the current time in
+   *   arbitrary but fixed units (for example, microseconds).  The values
+   *   must not decrease between two calls.
+   *
+   * @input:
+   *   clock_data ::
+   *     The `clock_data` field of @FT_Prop_InterpreterProfiling.
+   *
+   * @return:
+   *   The current time.
+   *
+   * @since:
+   *   2.13
+   */
+  typedef FT_ULong
+  (*FT_Profile_ClockFunc)( void*  clock_data );
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   interpreter-profiling
+   *
+   * @description:
+   *   Make the TrueType bytecode interpreter count the instructions it
+   *   executes, to be retrieved with the @interpreter-profile property.
+   *   This helps finding fonts whose hinting is expensive.
+   *
+   *   The value is a pointer to an @FT_Prop_InterpreterProfiling
+   *   structure, which gets copied.  Enabling profiling resets all
+   *   counters; disabling it discards them.  Profiling is off by default.
+   *
+   *   The counters are shared by all TrueType faces of the library and
+   *   are not protected against concurrent access; profile one font at a
+   *   time and from a single thread to get meaningful numbers.
+   *
+   * @note:
+   *   This property can be used with @FT_Property_Get also.
+   *
+   * @example:
+   *   ```
+   *     FT_Library                    library;
+   *     FT_Prop_InterpreterProfiling  prop;
+   *
+   *
+   *     FT_Init_FreeType( &library );
+   *
+   *     prop.enable     = 1;
+   *     prop.clock      = my_clock;
+   *     prop.clock_data = NULL;
+   *
+   *     FT_Property_Set( library, "truetype",
+   *                               "interpreter-profiling", &prop );
+   *   ```
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_Prop_InterpreterProfiling
+   *
+   * @description:
+   *   The data exchange structure for the @interpreter-profiling property.
+   *
+   * @fields:
+   *   enable ::
+   *     Set to~1 to switch profiling on, to~0 to switch it off.
+   *
+   *   clock ::
+   *     An optional clock function.  If set, the time spent in each
+   *     program run gets measured also.
+   *
+   *   clock_data ::
+   *     The argument of `clock`.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+  typedef struct  FT_Prop_InterpreterProfiling_
+  {
+    FT_Bool               enable;
+    FT_Profile_ClockFunc  clock;
+    void*                 clock_data;
+
+  } FT_Prop_InterpreterProfiling;
+
+
+  /**************************************************************************
+   *
+   * @enum:
+   *   TT_PROFILE_PROGRAM_XXX
+   *
+   * @description:
+   *   Indices into the per-program arrays of @FT_Prop_InterpreterProfile.
+   *
+   * @values:
+   *   TT_PROFILE_PROGRAM_FPGM ::
+   *     The font program ('fpgm' table), run once per face and size.
+   *
+   *   TT_PROFILE_PROGRAM_PREP ::
+   *     The control value program ('prep' table), run whenever a size
+   *     changes.
+   *
+   *   TT_PROFILE_PROGRAM_GLYPH ::
+   *     The glyph programs, run for every hinted glyph (and for every
+   *     component of a composite glyph).
+   *
+   * @since:
+   *   2.13
+   */
+#define TT_PROFILE_PROGRAM_FPGM   0
+#define TT_PROFILE_PROGRAM_PREP   1
+#define TT_PROFILE_PROGRAM_GLYPH  2
+
+#define TT_PROFILE_PROGRAM_MAX    3
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   interpreter-profile
+   *
+   * @description:
+   *   Read the counters collected while @interpreter-profiling is
+   *   enabled, passing a pointer to an @FT_Prop_InterpreterProfile
+   *   structure to @FT_Property_Get.  All fields are zero if profiling is
+   *   off.  Setting this property with @FT_Property_Set resets all
+   *   counters; the value is ignored.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_Prop_InterpreterProfile
+   *
+   * @description:
+   *   The data exchange structure for the @interpreter-profile property.
+   *
+   * @fields:
+   *   opcode_counts ::
+   *     The number of executed instructions for each opcode.  Opcodes
+   *     defined with the `IDEF` instruction are counted here also.
+   *
+   *   program_runs ::
+   *     The number of interpreter runs for each program type, indexed by
+   *     @TT_PROFILE_PROGRAM_XXX.
+   *
+   *   program_counts ::
+   *     The number of executed instructions for each program type,
+   *     including the instructions of called functions.
+   *
+   *   program_times ::
+   *     The time spent in each program type, as returned by the `clock`
+   *     function of @FT_Prop_InterpreterProfiling.  Zero if there is no
+   *     clock.  Divide the value for @TT_PROFILE_PROGRAM_GLYPH by its
+   *     run count to get the average time per glyph program.
+   *
+   *   max_glyph_time ::
+   *     The longest time spent in a single glyph program.
+   *
+   *   num_functions ::
+   *     The number of elements in `function_counts`.
+   *
+   *   function_counts ::
+   *     The number of instructions executed directly within each function,
+   *     indexed by the function number given to `FDEF`; instructions of
+   *     nested calls are attributed to the called function.  This array
+   *     is owned by the driver and stays valid until the counters are
+   *     reset or profiling is disabled.
+   *
+   *   max_stack_depth ::
+   *     The maximum number of stack elements seen during execution.
+   *
+   *   max_call_depth ::
+   *     The maximum depth of nested function calls.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+  typedef struct  FT_Prop_InterpreterProfile_
+  {
+    FT_ULong         opcode_counts[256];
+    FT_ULong         program_runs[TT_PROFILE_PROGRAM_MAX];
+    FT_ULong         program_counts[TT_PROFILE_PROGRAM_MAX];
+    FT_ULong         program_times[TT_PROFILE_PROGRAM_MAX];
+    FT_ULong         max_glyph_time;
+    FT_UInt          num_functions;
+    const FT_ULong*  function_counts;
+    FT_UInt          max_stack_depth;
+    FT_UInt          max_call_depth;
+
+  } FT_Prop_InterpreterProfile;
+
+
   /**************************************************************************
    *
    * @property:
@@ -127,6 +127,61 @@ FT_BEGIN_HEADER
           FT_MAKE_TAG( 'i', 's', 'b', 'x' )
 
 
+  /**************************************************************************
+   *
+   * @enum:
+   *   FT_PARAM_TAG_LAZY_TABLES
+   *
+   * @description:
+   *   A tag for @FT_Parameter to make @FT_Open_Face defer the loading of
+   *   rarely used optional SFNT tables until they are accessed for the
+   *   first time.  This reduces face creation time and memory footprint if
+   *   many faces are opened, for example, while enumerating fonts.
+   *
+   *   Currently, this affects the 'kern', 'gasp', and 'PCLT' tables, which
+   *   get loaded by @FT_Get_Kerning, @FT_Get_Gasp, and @FT_Get_Sfnt_Table,
+   *   respectively.  With this parameter, @FT_FACE_FLAG_KERNING only
+   *   indicates the presence of a 'kern' table, not that it contains
+   *   usable data.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+#define FT_PARAM_TAG_LAZY_TABLES \
+          FT_MAKE_TAG( 'l', 'a', 'z', 'y' )
+
+
+  /**************************************************************************
+   *
+   * @enum:
+   *   FT_PARAM_TAG_METADATA_ONLY
+   *
+   * @description:
+   *   A tag for @FT_Parameter to make @FT_Open_Face set up a face for
+   *   reading metadata only, for example, while building a font catalog.
+   *   Names, face and style flags, global metrics, charmaps, available
+   *   bitmap strikes, and SFNT tables are accessible as usual, but the
+   *   driver skips everything that is needed for glyph loading only.  This
+   *   parameter implies @FT_PARAM_TAG_LAZY_TABLES.
+   *
+   *   Loading a glyph from such a face fails with error
+   *   `FT_Err_Invalid_Argument`; open the face again without this
+   *   parameter to render glyphs.
+   *
+   *   Currently, only the TrueType driver makes use of this parameter; for
+   *   the TrueType driver it skips the 'loca', 'hdmx', 'cvt~', 'fpgm', and
+   *   'prep' tables.  As a consequence, @FT_FACE_FLAG_SCALABLE stays set
+   *   for bitmap fonts that contain only an empty '.notdef' outline.
+   *
+   * @since:
+   *   2.13
+   *
+   */
+#define FT_PARAM_TAG_METADATA_ONLY \
+          FT_MAKE_TAG( 'm', 'e', 't', 'a' )
+
+
   /**************************************************************************
    *
    * @enum:
@@ -204,6 +204,12 @@ FT_BEGIN_HEADER
                                   FT_Memory  mem,
                                   FT_UInt32  variant_selector );
 
+  typedef void
+  (*FT_CMap_CharIndicesFunc)( FT_CMap           cmap,
+                              const FT_UInt32*  char_codes,
+                              FT_UInt           count,
+                              FT_UInt*          gindices );
+
 
   typedef struct  FT_CMap_ClassRec_
   {
@@ -223,6 +229,11 @@ FT_BEGIN_HEADER
     FT_CMap_CharVariantListFunc   charvariant_list;
     FT_CMap_VariantCharListFunc   variantchar_list;
 
+    /* Optional batch version of `char_index'; if not set, */
+    /* `FT_Get_Char_Indices' calls `char_index' repeatedly */
+
+    FT_CMap_CharIndicesFunc       char_indices;
+
   } FT_CMap_ClassRec;
 
 
@@ -240,7 +251,8 @@ FT_BEGIN_HEADER
           char_var_default_,        \
           variant_list_,            \
           charvariant_list_,        \
-          variantchar_list_ )       \
+          variantchar_list_,        \
+          char_indices_ )           \
   FT_CALLBACK_TABLE_DEF             \
   const FT_CMap_ClassRec  class_ =  \
   {                                 \
@@ -253,7 +265,8 @@ FT_BEGIN_HEADER
     char_var_default_,              \
     variant_list_,                  \
     charvariant_list_,              \
-    variantchar_list_               \
+    variantchar_list_,              \
+    char_indices_                   \
   };
 
 
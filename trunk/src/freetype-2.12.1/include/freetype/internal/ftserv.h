@@ -394,6 +394,7 @@ FT_BEGIN_HEADER
     FT_Pointer  service_GLYPH_DICT;
     FT_Pointer  service_PFR_METRICS;
     FT_Pointer  service_WINFNT;
+    FT_Pointer  service_KERNING;
 
   } FT_ServiceCacheRec, *FT_ServiceCache;
 
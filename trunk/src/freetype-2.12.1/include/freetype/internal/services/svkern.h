@@ -34,9 +34,19 @@ FT_BEGIN_HEADER
                               FT_Int     degree,
                               FT_Fixed*  akerning );
 
+  /* Return the kerning of all adjacent pairs in `glyph_indices', in */
+  /* font units and with exactly the same values as the driver's      */
+  /* `get_kerning' method; the last element of `akernings' is zero.   */
+  typedef FT_Error
+  (*FT_Kerning_PairsGetFunc)( FT_Face         face,
+                              const FT_UInt*  glyph_indices,
+                              FT_UInt         count,
+                              FT_Vector*      akernings );
+
   FT_DEFINE_SERVICE( Kerning )
   {
-    FT_Kerning_TrackGetFunc  get_track;
+    FT_Kerning_TrackGetFunc  get_track;    /* may be NULL */
+    FT_Kerning_PairsGetFunc  get_pairs;    /* may be NULL */
   };
 
   /* */
@@ -338,6 +338,31 @@ FT_BEGIN_HEADER
                            FT_UInt       glyph_index );
 
 
+  /**************************************************************************
+   *
+   * @functype:
+   *   TT_Load_Lazy_Func
+   *
+   * @description:
+   *   Load optional tables whose loading has been deferred at face
+   *   creation time.  Each table is tried only once; a missing or broken
+   *   table is treated as if it had been ignored by `load_face`.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the target face object.
+   *
+   *   tables ::
+   *     A set of `TT_LAZY_TABLE_XXX` bits.
+   *
+   * @return:
+   *   FreeType error code.  0 means success.
+   */
+  typedef FT_Error
+  (*TT_Load_Lazy_Func)( TT_Face  face,
+                        FT_UInt  tables );
+
+
   /**************************************************************************
    *
    * @functype:
@@ -978,9 +1003,20 @@ FT_BEGIN_HEADER
     TT_Free_Table_Func    free_svg;
     TT_Load_Svg_Doc_Func  load_svg_doc;
 
+    /* deferred loading of optional tables */
+    TT_Load_Lazy_Func  load_lazy;
+
   } SFNT_Interface;
 
 
+  /* make sure that deferred tables given by `tables' are available */
+#define TT_FACE_LOAD_LAZY( face, tables )                              \
+          ( ( (face)->lazy_tables & (tables) )                         \
+              ? ( (SFNT_Service)(face)->sfnt )->load_lazy( (face),     \
+                                                           (tables) )  \
+              : FT_Err_Ok )
+
+
   /* transitional */
   typedef SFNT_Interface*   SFNT_Service;
 
@@ -1032,7 +1068,8 @@ FT_BEGIN_HEADER
           get_name_id_,                  \
           load_svg_,                     \
           free_svg_,                     \
-          load_svg_doc_ )                \
+          load_svg_doc_,                 \
+          load_lazy_ )                   \
   static const SFNT_Interface  class_ =  \
   {                                      \
     goto_table_,                         \
@@ -1080,7 +1117,8 @@ FT_BEGIN_HEADER
     get_name_id_,                        \
     load_svg_,                           \
     free_svg_,                           \
-    load_svg_doc_                        \
+    load_svg_doc_,                       \
+    load_lazy_                           \
   };
 
 
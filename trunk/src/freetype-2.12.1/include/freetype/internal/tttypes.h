@@ -1146,6 +1146,17 @@ FT_BEGIN_HEADER
 #define TT_FACE_FLAG_VAR_MVAR  ( 1 << 8 )
 
 
+  /* Optional tables whose loading can be deferred until first access; */
+  /* see `FT_PARAM_TAG_LAZY_TABLES' and field `lazy_tables'.           */
+#define TT_LAZY_TABLE_KERN  ( 1U << 0 )
+#define TT_LAZY_TABLE_GASP  ( 1U << 1 )
+#define TT_LAZY_TABLE_PCLT  ( 1U << 2 )
+
+#define TT_LAZY_TABLES_ALL  ( TT_LAZY_TABLE_KERN | \
+                              TT_LAZY_TABLE_GASP | \
+                              TT_LAZY_TABLE_PCLT )
+
+
   /**************************************************************************
    *
    *                        TrueType Face Type
@@ -1175,6 +1186,10 @@ FT_BEGIN_HEADER
    *   dir_tables ::
    *     The directory of TrueType tables for this font file.
    *
+   *   dir_index ::
+   *     Indices into `dir_tables`, sorted by table tag.  Used for binary
+   *     search in table lookups.
+   *
    *   header ::
    *     The font's font header ('head' table).  Read on font opening.
    *
@@ -1458,6 +1473,23 @@ FT_BEGIN_HEADER
    *
    *   ebdt_size ::
    *     The size of the sbit data table.
+   *
+   *   lazy_tables ::
+   *     A set of `TT_LAZY_TABLE_XXX` bits, identifying optional tables
+   *     whose loading has been deferred and is still pending.  Use
+   *     `TT_FACE_LOAD_LAZY` before accessing them.
+   *
+   *   metadata_only ::
+   *     Set if the face was opened with `FT_PARAM_TAG_METADATA_ONLY`;
+   *     glyph loading is not possible then.
+   *
+   *   kern_hash ::
+   *     A hash table of all kerning pairs in the 'kern' table, built on
+   *     first use if `TT_CONFIG_KERN_HASH` is defined.  The layout is
+   *     private to the 'kern' table loader.
+   *
+   *   kern_hash_done ::
+   *     Set once building `kern_hash` has been attempted.
    */
   typedef struct  TT_FaceRec_
   {
@@ -1468,6 +1500,7 @@ FT_BEGIN_HEADER
     FT_ULong              format_tag;
     FT_UShort             num_tables;
     TT_Table              dir_tables;
+    FT_UShort*            dir_index;
 
     TT_Header             header;       /* TrueType header table          */
     TT_HoriHeader         horizontal;   /* TrueType horizontal header     */
@@ -1647,6 +1680,15 @@ FT_BEGIN_HEADER
     /* since 2.12 */
     void*                 svg;
 
+    /* since 2.13 */
+    void*                 size_states;  /* saved `fpgm' and `prep' results */
+
+    FT_UInt               lazy_tables;
+    FT_Bool               metadata_only;
+
+    void*                 kern_hash;
+    FT_Bool               kern_hash_done;
+
   } TT_FaceRec;
 
 
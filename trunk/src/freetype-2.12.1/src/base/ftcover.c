@@ -0,0 +1,999 @@
+/****************************************************************************
+ *
+ * ftcover.c
+ *
+ *   FreeType character coverage sets (body).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/internal/ftdebug.h>
+#include <freetype/ftcover.h>
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftstream.h>
+
+
+  /*
+   * A coverage set is a sorted array of blocks, each holding the
+   * character codes that share the same upper 16 bits.  A block with at
+   * most `FT_COVERAGE_ARRAY_MAX' entries stores the lower 16 bits as a
+   * sorted array; beyond that a bitmap of 65536 bits takes less space.
+   */
+
+#define FT_COVERAGE_ARRAY_MAX  4096
+#define FT_COVERAGE_WORDS      ( 0x10000 / 32 )
+
+  /* serialized data: magic, version, number of blocks */
+#define FT_COVERAGE_MAGIC        FT_MAKE_TAG( 'F', 'T', 'C', 'V' )
+#define FT_COVERAGE_VERSION      1
+#define FT_COVERAGE_HEADER_SIZE  10
+
+
+  typedef struct  FT_CoverageBlockRec_
+  {
+    FT_UInt32   key;     /* character code >> 16            */
+    FT_UInt32   count;   /* number of entries, 1 to 65536   */
+    FT_UShort*  codes;   /* if count <= FT_COVERAGE_ARRAY_MAX */
+    FT_UInt32*  bits;    /* otherwise                       */
+
+  } FT_CoverageBlockRec, *FT_CoverageBlock;
+
+
+  typedef struct  FT_CoverageRec_
+  {
+    FT_Memory         memory;
+    FT_ULong          count;
+    FT_UInt           num_blocks;
+    FT_CoverageBlock  blocks;
+
+  } FT_CoverageRec;
+
+
+  /* collects blocks in ascending key order */
+  typedef struct  FT_CoverageBuilderRec_
+  {
+    FT_Memory         memory;
+    FT_ULong          count;
+    FT_UInt           num_blocks;
+    FT_UInt           max_blocks;
+    FT_CoverageBlock  blocks;
+
+    FT_UInt32         key;      /* key of the block in `bits' */
+    FT_UInt32         pending;  /* number of bits set in `bits' */
+    FT_UInt32*        bits;
+
+  } FT_CoverageBuilderRec, *FT_CoverageBuilder;
+
+
+  static FT_UInt32
+  ft_coverage_popcount( FT_UInt32  x )
+  {
+    x = x - ( ( x >> 1 ) & 0x55555555UL );
+    x = ( x & 0x33333333UL ) + ( ( x >> 2 ) & 0x33333333UL );
+    x = ( x + ( x >> 4 ) ) & 0x0F0F0F0FUL;
+
+    return (FT_UInt32)( x * 0x01010101UL ) >> 24;
+  }
+
+
+  static void
+  ft_coverage_free_blocks( FT_Memory         memory,
+                           FT_CoverageBlock  blocks,
+                           FT_UInt           num_blocks )
+  {
+    FT_UInt  nn;
+
+
+    for ( nn = 0; nn < num_blocks; nn++ )
+    {
+      FT_FREE( blocks[nn].codes );
+      FT_FREE( blocks[nn].bits );
+    }
+
+    FT_FREE( blocks );
+  }
+
+
+  /* binary search for the block with a given key */
+  static FT_CoverageBlock
+  ft_coverage_find_block( FT_Coverage  coverage,
+                          FT_UInt32    key )
+  {
+    FT_UInt  min = 0;
+    FT_UInt  max = coverage->num_blocks;
+
+
+    while ( min < max )
+    {
+      FT_UInt           mid   = ( min + max ) >> 1;
+      FT_CoverageBlock  block = coverage->blocks + mid;
+
+
+      if ( block->key == key )
+        return block;
+
+      if ( block->key < key )
+        min = mid + 1;
+      else
+        max = mid;
+    }
+
+    return NULL;
+  }
+
+
+  static FT_Bool
+  ft_coverage_block_has( FT_CoverageBlock  block,
+                         FT_UInt           lo )
+  {
+    if ( block->bits )
+      return (FT_Bool)( ( block->bits[lo >> 5] >> ( lo & 31 ) ) & 1 );
+    else
+    {
+      /* the loop body compiles to conditional moves; */
+      /* membership tests are too random for branches */
+      FT_UShort*  base = block->codes;
+      FT_UInt     n    = block->count;
+
+
+      while ( n > 1 )
+      {
+        FT_UInt  half = n >> 1;
+
+
+        base  = base[half] <= lo ? base + half : base;
+        n    -= half;
+      }
+
+      return (FT_Bool)( *base == lo );
+    }
+  }
+
+
+  /* OR the entries of `block' into a bitmap */
+  static void
+  ft_coverage_block_or( FT_CoverageBlock  block,
+                        FT_UInt32*        bits )
+  {
+    FT_UInt  nn;
+
+
+    if ( block->bits )
+    {
+      for ( nn = 0; nn < FT_COVERAGE_WORDS; nn++ )
+        bits[nn] |= block->bits[nn];
+    }
+    else
+    {
+      for ( nn = 0; nn < block->count; nn++ )
+      {
+        FT_UInt  lo = block->codes[nn];
+
+
+        bits[lo >> 5] |= 1U << ( lo & 31 );
+      }
+    }
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                           BUILDER                             *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  static FT_Error
+  ft_coverage_builder_init( FT_CoverageBuilder  builder,
+                            FT_Memory           memory )
+  {
+    FT_Error  error;
+
+
+    FT_ZERO( builder );
+    builder->memory = memory;
+
+    (void)FT_NEW_ARRAY( builder->bits, FT_COVERAGE_WORDS );
+
+    return error;
+  }
+
+
+  static void
+  ft_coverage_builder_done( FT_CoverageBuilder  builder )
+  {
+    FT_Memory  memory = builder->memory;
+
+
+    ft_coverage_free_blocks( memory, builder->blocks, builder->num_blocks );
+    FT_FREE( builder->bits );
+  }
+
+
+  /* turn the pending bitmap into a new block and clear it */
+  static FT_Error
+  ft_coverage_builder_flush( FT_CoverageBuilder  builder )
+  {
+    FT_Memory         memory = builder->memory;
+    FT_UInt32*        bits   = builder->bits;
+    FT_CoverageBlock  block;
+    FT_Error          error  = FT_Err_Ok;
+
+
+    if ( !builder->pending )
+      return FT_Err_Ok;
+
+    if ( builder->num_blocks >= builder->max_blocks )
+    {
+      FT_UInt  new_max = builder->max_blocks + 16 + builder->max_blocks / 2;
+
+
+      if ( FT_RENEW_ARRAY( builder->blocks,
+                           builder->max_blocks,
+                           new_max ) )
+        return error;
+
+      builder->max_blocks = new_max;
+    }
+
+    block = builder->blocks + builder->num_blocks;
+
+    block->key   = builder->key;
+    block->count = builder->pending;
+
+    if ( builder->pending <= FT_COVERAGE_ARRAY_MAX )
+    {
+      FT_UInt  nn, i = 0;
+
+
+      if ( FT_QNEW_ARRAY( block->codes, builder->pending ) )
+        return error;
+
+      for ( nn = 0; nn < FT_COVERAGE_WORDS; nn++ )
+      {
+        FT_UInt32  word = bits[nn];
+
+
+        while ( word )
+        {
+          FT_UInt  bit = 0;
+
+
+          while ( !( ( word >> bit ) & 1 ) )
+            bit++;
+
+          block->codes[i++] = (FT_UShort)( ( nn << 5 ) | bit );
+          word             &= word - 1;
+        }
+      }
+    }
+    else
+    {
+      if ( FT_QNEW_ARRAY( block->bits, FT_COVERAGE_WORDS ) )
+        return error;
+
+      FT_ARRAY_COPY( block->bits, bits, FT_COVERAGE_WORDS );
+    }
+
+    builder->num_blocks++;
+    builder->count += builder->pending;
+
+    FT_ARRAY_ZERO( bits, FT_COVERAGE_WORDS );
+    builder->pending = 0;
+
+    return FT_Err_Ok;
+  }
+
+
+  /* codes must be added grouped by their upper 16 bits */
+  static FT_Error
+  ft_coverage_builder_add( FT_CoverageBuilder  builder,
+                           FT_UInt32           char_code )
+  {
+    FT_UInt32   key = char_code >> 16;
+    FT_UInt     lo  = char_code & 0xFFFFU;
+    FT_UInt32*  word;
+
+
+    if ( key != builder->key )
+    {
+      FT_Error  error = ft_coverage_builder_flush( builder );
+
+
+      if ( error )
+        return error;
+
+      builder->key = key;
+    }
+
+    word = builder->bits + ( lo >> 5 );
+    if ( !( ( *word >> ( lo & 31 ) ) & 1 ) )
+    {
+      *word |= 1U << ( lo & 31 );
+      builder->pending++;
+    }
+
+    return FT_Err_Ok;
+  }
+
+
+  /* set the pending bitmap's key and count after filling it directly */
+  static FT_Error
+  ft_coverage_builder_commit( FT_CoverageBuilder  builder,
+                              FT_UInt32           key )
+  {
+    FT_UInt32*  bits  = builder->bits;
+    FT_UInt32   count = 0;
+    FT_UInt     nn;
+
+
+    for ( nn = 0; nn < FT_COVERAGE_WORDS; nn++ )
+      count += ft_coverage_popcount( bits[nn] );
+
+    builder->key     = key;
+    builder->pending = count;
+
+    return ft_coverage_builder_flush( builder );
+  }
+
+
+  /* move the collected blocks into a new coverage object */
+  static FT_Error
+  ft_coverage_builder_finish( FT_CoverageBuilder  builder,
+                              FT_Coverage        *acoverage )
+  {
+    FT_Memory    memory = builder->memory;
+    FT_Coverage  coverage;
+    FT_Error     error;
+
+
+    error = ft_coverage_builder_flush( builder );
+    if ( error )
+      goto Exit;
+
+    if ( FT_NEW( coverage ) )
+      goto Exit;
+
+    coverage->memory     = memory;
+    coverage->count      = builder->count;
+    coverage->num_blocks = builder->num_blocks;
+    coverage->blocks     = builder->blocks;
+
+    builder->blocks     = NULL;
+    builder->num_blocks = 0;
+
+    *acoverage = coverage;
+
+  Exit:
+    ft_coverage_builder_done( builder );
+
+    return error;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                          PUBLIC API                           *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_New( FT_Face       face,
+                   FT_Coverage  *acoverage )
+  {
+    FT_CoverageBuilderRec  builder;
+    FT_Error               error;
+
+
+    if ( !face )
+      return FT_THROW( Invalid_Face_Handle );
+
+    if ( !acoverage )
+      return FT_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+
+    error = ft_coverage_builder_init( &builder, face->memory );
+    if ( error )
+      return error;
+
+    if ( face->charmap )
+    {
+      FT_ULong  char_code;
+      FT_UInt   gindex;
+
+
+      /* `FT_Get_Next_Char' returns the codes in ascending order */
+      char_code = FT_Get_First_Char( face, &gindex );
+      while ( gindex )
+      {
+        error = ft_coverage_builder_add( &builder, (FT_UInt32)char_code );
+        if ( error )
+          goto Fail;
+
+        char_code = FT_Get_Next_Char( face, char_code, &gindex );
+      }
+    }
+
+    return ft_coverage_builder_finish( &builder, acoverage );
+
+  Fail:
+    ft_coverage_builder_done( &builder );
+
+    return error;
+  }
+
+
+  FT_COMPARE_DEF( int )
+  ft_coverage_compare_codes( const void*  a,
+                             const void*  b )
+  {
+    FT_UInt32  code1 = *(const FT_UInt32*)a;
+    FT_UInt32  code2 = *(const FT_UInt32*)b;
+
+
+    if ( code1 > code2 )
+      return 1;
+    else if ( code1 < code2 )
+      return -1;
+    else
+      return 0;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_New_From_Chars( FT_Library        library,
+                              const FT_UInt32*  char_codes,
+                              FT_UInt           count,
+                              FT_Coverage      *acoverage )
+  {
+    FT_Memory              memory;
+    FT_CoverageBuilderRec  builder;
+    FT_UInt32*             sorted = NULL;
+    FT_UInt                nn;
+    FT_Error               error;
+
+
+    if ( !library )
+      return FT_THROW( Invalid_Library_Handle );
+
+    if ( !acoverage || ( count && !char_codes ) )
+      return FT_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+    memory     = library->memory;
+
+    /* the builder needs the codes grouped by block */
+    if ( count )
+    {
+      if ( FT_QNEW_ARRAY( sorted, count ) )
+        return error;
+
+      FT_ARRAY_COPY( sorted, char_codes, count );
+      ft_qsort( sorted, count, sizeof ( FT_UInt32 ),
+                ft_coverage_compare_codes );
+    }
+
+    error = ft_coverage_builder_init( &builder, memory );
+    if ( error )
+      goto Exit;
+
+    for ( nn = 0; nn < count; nn++ )
+    {
+      error = ft_coverage_builder_add( &builder, sorted[nn] );
+      if ( error )
+      {
+        ft_coverage_builder_done( &builder );
+        goto Exit;
+      }
+    }
+
+    error = ft_coverage_builder_finish( &builder, acoverage );
+
+  Exit:
+    FT_FREE( sorted );
+
+    return error;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( void )
+  FT_Coverage_Done( FT_Coverage  coverage )
+  {
+    FT_Memory  memory;
+
+
+    if ( !coverage )
+      return;
+
+    memory = coverage->memory;
+
+    ft_coverage_free_blocks( memory, coverage->blocks, coverage->num_blocks );
+    FT_FREE( coverage );
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_ULong )
+  FT_Coverage_Get_Count( FT_Coverage  coverage )
+  {
+    return coverage ? coverage->count : 0;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Bool )
+  FT_Coverage_Has_Char( FT_Coverage  coverage,
+                        FT_UInt32    char_code )
+  {
+    FT_CoverageBlock  block;
+
+
+    if ( !coverage )
+      return 0;
+
+    block = ft_coverage_find_block( coverage, char_code >> 16 );
+    if ( !block )
+      return 0;
+
+    return ft_coverage_block_has( block, char_code & 0xFFFFU );
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_UInt )
+  FT_Coverage_Check_Chars( FT_Coverage       coverage,
+                           const FT_UInt32*  char_codes,
+                           FT_UInt           count,
+                           FT_Byte*          flags )
+  {
+    FT_CoverageBlock  block  = NULL;
+    FT_UInt32         key    = 0;
+    FT_UInt           result = 0;
+    FT_UInt           nn;
+
+
+    if ( !coverage || !char_codes )
+      count = 0;
+
+    for ( nn = 0; nn < count; nn++ )
+    {
+      FT_UInt32  char_code = char_codes[nn];
+      FT_Bool    has       = 0;
+
+
+      if ( nn == 0 || ( char_code >> 16 ) != key )
+      {
+        key   = char_code >> 16;
+        block = ft_coverage_find_block( coverage, key );
+      }
+
+      if ( block )
+        has = ft_coverage_block_has( block, char_code & 0xFFFFU );
+
+      if ( flags )
+        flags[nn] = has;
+
+      result += has;
+    }
+
+    return result;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_ULong )
+  FT_Coverage_Count_Common( FT_Coverage  coverage1,
+                            FT_Coverage  coverage2 )
+  {
+    FT_CoverageBlock  b1, end1, b2, end2;
+    FT_ULong          result = 0;
+
+
+    if ( !coverage1 || !coverage2 )
+      return 0;
+
+    b1   = coverage1->blocks;
+    end1 = b1 + coverage1->num_blocks;
+    b2   = coverage2->blocks;
+    end2 = b2 + coverage2->num_blocks;
+
+    while ( b1 < end1 && b2 < end2 )
+    {
+      if ( b1->key < b2->key )
+        b1++;
+      else if ( b1->key > b2->key )
+        b2++;
+      else
+      {
+        if ( b1->bits && b2->bits )
+        {
+          FT_UInt  nn;
+
+
+          for ( nn = 0; nn < FT_COVERAGE_WORDS; nn++ )
+            result += ft_coverage_popcount( b1->bits[nn] & b2->bits[nn] );
+        }
+        else
+        {
+          /* probe the other block with each entry of an array block */
+          FT_CoverageBlock  array = b1->bits ? b2 : b1;
+          FT_CoverageBlock  other = b1->bits ? b1 : b2;
+          FT_UInt           nn;
+
+
+          for ( nn = 0; nn < array->count; nn++ )
+            result += ft_coverage_block_has( other, array->codes[nn] );
+        }
+
+        b1++;
+        b2++;
+      }
+    }
+
+    return result;
+  }
+
+
+  static FT_Error
+  ft_coverage_combine( FT_Coverage  target,
+                       FT_Coverage  source,
+                       FT_Bool      intersect )
+  {
+    FT_CoverageBuilderRec  builder;
+    FT_CoverageBlock       b1, end1, b2, end2;
+    FT_Coverage            result = NULL;
+    FT_Error               error;
+
+
+    if ( !target || !source )
+      return FT_THROW( Invalid_Argument );
+
+    error = ft_coverage_builder_init( &builder, target->memory );
+    if ( error )
+      return error;
+
+    b1   = target->blocks;
+    end1 = b1 + target->num_blocks;
+    b2   = source->blocks;
+    end2 = b2 + source->num_blocks;
+
+    while ( b1 < end1 || b2 < end2 )
+    {
+      FT_UInt32*  bits = builder.bits;
+      FT_UInt32   key;
+
+
+      if ( b2 == end2 || ( b1 < end1 && b1->key < b2->key ) )
+      {
+        key = b1->key;
+        if ( !intersect )
+          ft_coverage_block_or( b1, bits );
+        b1++;
+      }
+      else if ( b1 == end1 || b1->key > b2->key )
+      {
+        key = b2->key;
+        if ( !intersect )
+          ft_coverage_block_or( b2, bits );
+        b2++;
+      }
+      else
+      {
+        key = b1->key;
+
+        if ( !intersect )
+        {
+          ft_coverage_block_or( b1, bits );
+          ft_coverage_block_or( b2, bits );
+        }
+        else if ( b1->bits && b2->bits )
+        {
+          FT_UInt  nn;
+
+
+          for ( nn = 0; nn < FT_COVERAGE_WORDS; nn++ )
+            bits[nn] = b1->bits[nn] & b2->bits[nn];
+        }
+        else
+        {
+          FT_CoverageBlock  array = b1->bits ? b2 : b1;
+          FT_CoverageBlock  other = b1->bits ? b1 : b2;
+          FT_UInt           nn;
+
+
+          for ( nn = 0; nn < array->count; nn++ )
+          {
+            FT_UInt  lo = array->codes[nn];
+
+
+            if ( ft_coverage_block_has( other, lo ) )
+              bits[lo >> 5] |= 1U << ( lo & 31 );
+          }
+        }
+
+        b1++;
+        b2++;
+      }
+
+      error = ft_coverage_builder_commit( &builder, key );
+      if ( error )
+      {
+        ft_coverage_builder_done( &builder );
+        return error;
+      }
+    }
+
+    error = ft_coverage_builder_finish( &builder, &result );
+    if ( error )
+      return error;
+
+    /* swap contents so that `target' keeps its identity */
+    ft_coverage_free_blocks( target->memory,
+                             target->blocks,
+                             target->num_blocks );
+
+    target->count      = result->count;
+    target->num_blocks = result->num_blocks;
+    target->blocks     = result->blocks;
+
+    result->num_blocks = 0;
+    result->blocks     = NULL;
+    FT_Coverage_Done( result );
+
+    return FT_Err_Ok;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_Merge( FT_Coverage  target,
+                     FT_Coverage  source )
+  {
+    return ft_coverage_combine( target, source, 0 );
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_Intersect( FT_Coverage  target,
+                         FT_Coverage  source )
+  {
+    return ft_coverage_combine( target, source, 1 );
+  }
+
+
+  /*
+   * Serialized format, all values big-endian:
+   *
+   *   magic        ULONG   `FTCV'
+   *   version      USHORT  1
+   *   num_blocks   ULONG
+   *
+   * followed by `num_blocks' blocks in ascending key order:
+   *
+   *   key          USHORT
+   *   count - 1    USHORT
+   *   data         `count' USHORTs if count <= FT_COVERAGE_ARRAY_MAX,
+   *                otherwise FT_COVERAGE_WORDS ULONGs
+   */
+
+#define FT_COVERAGE_PUT_USHORT( p, v )          \
+          FT_BEGIN_STMNT                        \
+            (p)[0] = (FT_Byte)( (v) >> 8 );     \
+            (p)[1] = (FT_Byte)( v );            \
+            (p)   += 2;                         \
+          FT_END_STMNT
+
+#define FT_COVERAGE_PUT_ULONG( p, v )           \
+          FT_BEGIN_STMNT                        \
+            (p)[0] = (FT_Byte)( (v) >> 24 );    \
+            (p)[1] = (FT_Byte)( (v) >> 16 );    \
+            (p)[2] = (FT_Byte)( (v) >> 8 );     \
+            (p)[3] = (FT_Byte)( v );            \
+            (p)   += 4;                         \
+          FT_END_STMNT
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_Save( FT_Coverage  coverage,
+                    FT_Byte*     buffer,
+                    FT_ULong    *alength )
+  {
+    FT_ULong  size = FT_COVERAGE_HEADER_SIZE;
+    FT_Byte*  p    = buffer;
+    FT_UInt   nn, mm;
+
+
+    if ( !coverage || !alength )
+      return FT_THROW( Invalid_Argument );
+
+    for ( nn = 0; nn < coverage->num_blocks; nn++ )
+    {
+      FT_CoverageBlock  block = coverage->blocks + nn;
+
+
+      size += 4;
+      size += block->bits ? FT_COVERAGE_WORDS * 4 : block->count * 2;
+    }
+
+    if ( !buffer )
+    {
+      *alength = size;
+      return FT_Err_Ok;
+    }
+
+    if ( *alength < size )
+    {
+      *alength = size;
+      return FT_THROW( Invalid_Argument );
+    }
+
+    FT_COVERAGE_PUT_ULONG( p, FT_COVERAGE_MAGIC );
+    FT_COVERAGE_PUT_USHORT( p, FT_COVERAGE_VERSION );
+    FT_COVERAGE_PUT_ULONG( p, coverage->num_blocks );
+
+    for ( nn = 0; nn < coverage->num_blocks; nn++ )
+    {
+      FT_CoverageBlock  block = coverage->blocks + nn;
+
+
+      FT_COVERAGE_PUT_USHORT( p, block->key );
+      FT_COVERAGE_PUT_USHORT( p, block->count - 1 );
+
+      if ( block->bits )
+      {
+        for ( mm = 0; mm < FT_COVERAGE_WORDS; mm++ )
+          FT_COVERAGE_PUT_ULONG( p, block->bits[mm] );
+      }
+      else
+      {
+        for ( mm = 0; mm < block->count; mm++ )
+          FT_COVERAGE_PUT_USHORT( p, block->codes[mm] );
+      }
+    }
+
+    *alength = size;
+
+    return FT_Err_Ok;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Coverage_Load( FT_Library      library,
+                    const FT_Byte*  buffer,
+                    FT_ULong        length,
+                    FT_Coverage    *acoverage )
+  {
+    FT_Memory              memory;
+    FT_CoverageBuilderRec  builder;
+    const FT_Byte*         p     = buffer;
+    const FT_Byte*         limit = buffer + length;
+    FT_ULong               num_blocks, nn;
+    FT_Long                prev_key = -1;
+    FT_Error               error;
+
+
+    if ( !library )
+      return FT_THROW( Invalid_Library_Handle );
+
+    if ( !buffer || !acoverage )
+      return FT_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+    memory     = library->memory;
+
+    if ( length < FT_COVERAGE_HEADER_SIZE              ||
+         FT_NEXT_ULONG( p ) != FT_COVERAGE_MAGIC       ||
+         FT_NEXT_USHORT( p ) != FT_COVERAGE_VERSION    )
+      return FT_THROW( Invalid_File_Format );
+
+    num_blocks = FT_NEXT_ULONG( p );
+    if ( num_blocks > 0x10000UL )
+      return FT_THROW( Invalid_File_Format );
+
+    error = ft_coverage_builder_init( &builder, memory );
+    if ( error )
+      return error;
+
+    for ( nn = 0; nn < num_blocks; nn++ )
+    {
+      FT_UInt32*  bits = builder.bits;
+      FT_ULong    old_count = builder.count;
+      FT_UInt     key, count, mm;
+
+
+      if ( limit - p < 4 )
+        goto Invalid;
+
+      key   = FT_NEXT_USHORT( p );
+      count = FT_NEXT_USHORT( p ) + 1U;
+
+      if ( (FT_Long)key <= prev_key )
+        goto Invalid;
+      prev_key = (FT_Long)key;
+
+      if ( count <= FT_COVERAGE_ARRAY_MAX )
+      {
+        FT_Long  prev = -1;
+
+
+        if ( (FT_ULong)( limit - p ) < count * 2 )
+          goto Invalid;
+
+        for ( mm = 0; mm < count; mm++ )
+        {
+          FT_UInt  lo = FT_NEXT_USHORT( p );
+
+
+          if ( (FT_Long)lo <= prev )
+            goto Invalid;
+          prev = (FT_Long)lo;
+
+          bits[lo >> 5] |= 1U << ( lo & 31 );
+        }
+      }
+      else
+      {
+        if ( limit - p < FT_COVERAGE_WORDS * 4 )
+          goto Invalid;
+
+        for ( mm = 0; mm < FT_COVERAGE_WORDS; mm++ )
+          bits[mm] = (FT_UInt32)FT_NEXT_ULONG( p );
+      }
+
+      error = ft_coverage_builder_commit( &builder, key );
+      if ( error )
+        goto Fail;
+
+      /* a bitmap block must have the stated number of entries */
+      if ( builder.count - old_count != count )
+        goto Invalid;
+    }
+
+    if ( p != limit )
+      goto Invalid;
+
+    return ft_coverage_builder_finish( &builder, acoverage );
+
+  Invalid:
+    error = FT_THROW( Invalid_File_Format );
+
+  Fail:
+    ft_coverage_builder_done( &builder );
+
+    return error;
+  }
+
+
+/* END */
@@ -18,6 +18,7 @@
 
 #include <freetype/ftgasp.h>
 #include <freetype/internal/tttypes.h>
+#include <freetype/internal/sfnt.h>
 
 
   FT_EXPORT_DEF( FT_Int )
@@ -32,6 +33,8 @@
       TT_Face  ttface = (TT_Face)face;
 
 
+      (void)TT_FACE_LOAD_LAZY( ttface, TT_LAZY_TABLE_GASP );
+
       if ( ttface->gasp.numRanges > 0 )
       {
         TT_GaspRange  range     = ttface->gasp.gaspRanges;
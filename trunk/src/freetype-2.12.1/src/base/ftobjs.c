@@ -3556,6 +3556,51 @@
   }
 
 
+  /* scale and round a kerning vector in font units for `kern_mode', */
+  /* which must not be FT_KERNING_UNSCALED                            */
+  static void
+  ft_kerning_scale( const FT_Size_Metrics*  metrics,
+                    FT_UInt                 kern_mode,
+                    FT_Vector              *akerning )
+  {
+    akerning->x = FT_MulFix( akerning->x, metrics->x_scale );
+    akerning->y = FT_MulFix( akerning->y, metrics->y_scale );
+
+    if ( kern_mode != FT_KERNING_UNFITTED )
+    {
+      FT_Pos  orig_x = akerning->x;
+      FT_Pos  orig_y = akerning->y;
+
+
+      /* we scale down kerning values for small ppem values */
+      /* to avoid that rounding makes them too big.         */
+      /* `25' has been determined heuristically.            */
+      if ( metrics->x_ppem < 25 )
+        akerning->x = FT_MulDiv( orig_x, metrics->x_ppem, 25 );
+      if ( metrics->y_ppem < 25 )
+        akerning->y = FT_MulDiv( orig_y, metrics->y_ppem, 25 );
+
+      akerning->x = FT_PIX_ROUND( akerning->x );
+      akerning->y = FT_PIX_ROUND( akerning->y );
+
+#ifdef FT_DEBUG_LEVEL_TRACE
+      {
+        FT_Pos  orig_x_rounded = FT_PIX_ROUND( orig_x );
+        FT_Pos  orig_y_rounded = FT_PIX_ROUND( orig_y );
+
+
+        if ( akerning->x != orig_x_rounded ||
+             akerning->y != orig_y_rounded )
+          FT_TRACE5(( "FT_Get_Kerning: horizontal kerning"
+                      " (%ld, %ld) scaled down to (%ld, %ld) pixels\n",
+                      orig_x_rounded / 64, orig_y_rounded / 64,
+                      akerning->x / 64, akerning->y / 64 ));
+      }
+#endif
+    }
+  }
+
+
   /* documentation is in freetype.h */
 
   FT_EXPORT_DEF( FT_Error )
@@ -3586,51 +3631,91 @@
                                           left_glyph,
                                           right_glyph,
                                           akerning );
-      if ( !error )
-      {
-        if ( kern_mode != FT_KERNING_UNSCALED )
-        {
-          akerning->x = FT_MulFix( akerning->x, face->size->metrics.x_scale );
-          akerning->y = FT_MulFix( akerning->y, face->size->metrics.y_scale );
+      if ( !error && kern_mode != FT_KERNING_UNSCALED )
+        ft_kerning_scale( &face->size->metrics, kern_mode, akerning );
+    }
 
-          if ( kern_mode != FT_KERNING_UNFITTED )
-          {
-            FT_Pos  orig_x = akerning->x;
-            FT_Pos  orig_y = akerning->y;
+    return error;
+  }
 
 
-            /* we scale down kerning values for small ppem values */
-            /* to avoid that rounding makes them too big.         */
-            /* `25' has been determined heuristically.            */
-            if ( face->size->metrics.x_ppem < 25 )
-              akerning->x = FT_MulDiv( orig_x,
-                                       face->size->metrics.x_ppem, 25 );
-            if ( face->size->metrics.y_ppem < 25 )
-              akerning->y = FT_MulDiv( orig_y,
-                                       face->size->metrics.y_ppem, 25 );
+  /* documentation is in freetype.h */
 
-            akerning->x = FT_PIX_ROUND( akerning->x );
-            akerning->y = FT_PIX_ROUND( akerning->y );
+  FT_EXPORT_DEF( FT_Error )
+  FT_Get_Kerning_Run( FT_Face         face,
+                      const FT_UInt*  glyph_indices,
+                      FT_UInt         count,
+                      FT_UInt         kern_mode,
+                      FT_Vector      *akernings )
+  {
+    FT_Error                error = FT_Err_Ok;
+    FT_Service_Kerning      service;
+    FT_Face_GetKerningFunc  get_kerning;
+    FT_UInt                 i;
 
-#ifdef FT_DEBUG_LEVEL_TRACE
-            {
-              FT_Pos  orig_x_rounded = FT_PIX_ROUND( orig_x );
-              FT_Pos  orig_y_rounded = FT_PIX_ROUND( orig_y );
 
+    if ( !face )
+      return FT_THROW( Invalid_Face_Handle );
 
-              if ( akerning->x != orig_x_rounded ||
-                   akerning->y != orig_y_rounded )
-                FT_TRACE5(( "FT_Get_Kerning: horizontal kerning"
-                            " (%ld, %ld) scaled down to (%ld, %ld) pixels\n",
-                            orig_x_rounded / 64, orig_y_rounded / 64,
-                            akerning->x / 64, akerning->y / 64 ));
-            }
-#endif
-          }
+    if ( count && ( !glyph_indices || !akernings ) )
+      return FT_THROW( Invalid_Argument );
+
+    for ( i = 0; i < count; i++ )
+    {
+      akernings[i].x = 0;
+      akernings[i].y = 0;
+    }
+
+    get_kerning = face->driver->clazz->get_kerning;
+    if ( !get_kerning || count < 2 )
+      return FT_Err_Ok;
+
+    /* the font driver may provide all pairs in a single call */
+    FT_FACE_LOOKUP_SERVICE( face, service, KERNING );
+    if ( service && service->get_pairs )
+    {
+      error = service->get_pairs( face, glyph_indices, count, akernings );
+      if ( error )
+      {
+        for ( i = 0; i < count; i++ )
+        {
+          akernings[i].x = 0;
+          akernings[i].y = 0;
+        }
+        return error;
+      }
+
+      i = count - 1;
+    }
+    else
+    {
+      for ( i = 0; i + 1 < count; i++ )
+      {
+        error = get_kerning( face,
+                             glyph_indices[i],
+                             glyph_indices[i + 1],
+                             &akernings[i] );
+        if ( error )
+        {
+          akernings[i].x = 0;
+          akernings[i].y = 0;
+          break;
         }
       }
     }
 
+    /* scale the pairs found so far; zero vectors stay zero */
+    if ( kern_mode != FT_KERNING_UNSCALED )
+    {
+      const FT_Size_Metrics*  metrics = &face->size->metrics;
+      FT_UInt                 n;
+
+
+      for ( n = 0; n < i; n++ )
+        if ( akernings[n].x || akernings[n].y )
+          ft_kerning_scale( metrics, kern_mode, &akernings[n] );
+    }
+
     return error;
   }
 
@@ -3654,7 +3739,7 @@
       return FT_THROW( Invalid_Argument );
 
     FT_FACE_FIND_SERVICE( face, service, KERNING );
-    if ( !service )
+    if ( !service || !service->get_track )
       return FT_THROW( Unimplemented_Feature );
 
     error = service->get_track( face,
@@ -3905,6 +3990,65 @@
   }
 
 
+  /* documentation is in freetype.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FT_Get_Char_Indices( FT_Face           face,
+                       const FT_UInt32*  charcodes,
+                       FT_UInt           count,
+                       FT_UInt*          gindices )
+  {
+    FT_CMap  cmap;
+    FT_UInt  num_glyphs;
+    FT_UInt  i;
+
+
+    if ( !face )
+      return FT_THROW( Invalid_Face_Handle );
+
+    if ( count && ( !charcodes || !gindices ) )
+      return FT_THROW( Invalid_Argument );
+
+    if ( !face->charmap )
+    {
+      for ( i = 0; i < count; i++ )
+        gindices[i] = 0;
+
+      return FT_Err_Ok;
+    }
+
+    cmap = FT_CMAP( face->charmap );
+
+    if ( cmap->clazz->char_indices )
+      cmap->clazz->char_indices( cmap, charcodes, count, gindices );
+    else
+    {
+      /* runs of the same character code are common in real text */
+      FT_UInt32  last_code  = 0;
+      FT_UInt    last_index = 0;
+
+
+      for ( i = 0; i < count; i++ )
+      {
+        if ( i == 0 || charcodes[i] != last_code )
+        {
+          last_code  = charcodes[i];
+          last_index = cmap->clazz->char_index( cmap, last_code );
+        }
+
+        gindices[i] = last_index;
+      }
+    }
+
+    num_glyphs = (FT_UInt)face->num_glyphs;
+    for ( i = 0; i < count; i++ )
+      if ( gindices[i] >= num_glyphs )
+        gindices[i] = 0;
+
+    return FT_Err_Ok;
+  }
+
+
   /* documentation is in freetype.h */
 
   FT_EXPORT_DEF( FT_ULong )
@@ -203,7 +203,7 @@ THE SOFTWARE.
     bdf_cmap_char_index,
     bdf_cmap_char_next,
 
-    NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL
   };
 
 
@@ -18,6 +18,7 @@
 
 #define FT_MAKE_OPTION_SINGLE_OBJECT
 
+#include "ftcatlas.c"
 #include "ftcbasic.c"
 #include "ftccache.c"
 #include "ftccmap.c"
@@ -26,6 +27,7 @@
 #include "ftcmanag.c"
 #include "ftcmru.c"
 #include "ftcsbits.c"
+#include "ftcstore.c"
 
 
 /* END */
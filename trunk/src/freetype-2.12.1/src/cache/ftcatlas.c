@@ -0,0 +1,553 @@
+/****************************************************************************
+ *
+ * ftcatlas.c
+ *
+ *   FreeType atlas cache (body).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include "ftcatlas.h"
+#include "ftcmanag.h"
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+#include <freetype/fterrors.h>
+
+#include "ftccback.h"
+#include "ftcerror.h"
+
+#undef  FT_COMPONENT
+#define FT_COMPONENT  cache
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                        ATLAS PAGES                            *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /* allocate the bitmap of the next unused page */
+  static FT_Error
+  ftc_acache_new_page( FTC_ACache  cache,
+                       FTC_APage  *apage )
+  {
+    FT_Memory  memory = FTC_CACHE( cache )->memory;
+    FT_Error   error;
+    FTC_APage  page;
+
+
+    *apage = NULL;
+
+    if ( !cache->pages && FT_NEW_ARRAY( cache->pages, cache->max_pages ) )
+      goto Exit;
+
+    page = cache->pages + cache->num_pages;
+
+    if ( FT_ALLOC_MULT( page->root.bitmap.buffer,
+                        cache->page_width, cache->page_height ) )
+      goto Exit;
+
+    page->root.bitmap.width      = cache->page_width;
+    page->root.bitmap.rows       = cache->page_height;
+    page->root.bitmap.pitch      = (int)cache->page_width;
+    page->root.bitmap.num_grays  = 256;
+    page->root.bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+    page->root.index             = cache->num_pages;
+
+    cache->num_pages++;
+    *apage = page;
+
+  Exit:
+    return error;
+  }
+
+
+  /* clear a page whose glyphs have all been flushed */
+  static void
+  ftc_apage_clear( FTC_APage  page )
+  {
+    FT_MEM_ZERO( page->root.bitmap.buffer,
+                 (FT_Offset)page->root.bitmap.pitch *
+                   page->root.bitmap.rows );
+
+    page->stale = FALSE;
+    page->root.serial++;
+  }
+
+
+  /*
+   * Find room for a `width' x `height' rectangle on a page's shelves,
+   * which are filled from left to right.  We use the shelf that wastes
+   * the fewest rows, unless a new shelf fits better.  `*aplaced' is
+   * set to FALSE if the page is full.
+   */
+  static FT_Error
+  ftc_apage_place( FTC_APage  page,
+                   FT_UInt    width,
+                   FT_UInt    height,
+                   FT_Memory  memory,
+                   FT_UInt   *ax,
+                   FT_UInt   *ay,
+                   FT_Bool   *aplaced )
+  {
+    FT_Error    error      = FT_Err_Ok;
+    FT_UInt     page_width = page->root.bitmap.width;
+    FTC_AShelf  shelf      = page->shelves;
+    FTC_AShelf  limit      = shelf + page->num_shelves;
+    FTC_AShelf  best       = NULL;
+
+
+    *aplaced = FALSE;
+
+    for ( ; shelf < limit; shelf++ )
+    {
+      if ( shelf->height >= height          &&
+           shelf->x + width <= page_width   &&
+           ( !best || shelf->height < best->height ) )
+        best = shelf;
+    }
+
+    /* open a new shelf if the best one is more than 25% too high */
+    if ( ( !best || best->height - height > height / 4 ) &&
+         page->top + height <= page->root.bitmap.rows    )
+    {
+      if ( page->num_shelves == page->max_shelves )
+      {
+        FT_UInt  new_max = page->max_shelves ? page->max_shelves * 2 : 16;
+
+
+        if ( FT_QRENEW_ARRAY( page->shelves, page->max_shelves, new_max ) )
+          goto Exit;
+
+        page->max_shelves = new_max;
+      }
+
+      best = page->shelves + page->num_shelves++;
+
+      best->y      = page->top;
+      best->height = height;
+      best->x      = 0;
+
+      page->top += height + FTC_ATLAS_PADDING;
+    }
+
+    if ( best )
+    {
+      *ax      = best->x;
+      *ay      = best->y;
+      *aplaced = TRUE;
+
+      best->x += width + FTC_ATLAS_PADDING;
+    }
+
+  Exit:
+    return error;
+  }
+
+
+  /*
+   * Flush the glyphs of the page that holds the least recently used
+   * unreferenced glyph of this cache.  Return the page if it is now
+   * empty, NULL otherwise.  The manager lock must be held.
+   */
+  static FTC_APage
+  ftc_acache_evict( FTC_ACache  cache )
+  {
+    FTC_Manager  manager = FTC_CACHE( cache )->manager;
+    FT_UInt      index   = FTC_CACHE( cache )->index;
+    FTC_APage    victim  = NULL;
+    FT_UInt      n;
+
+
+    for ( ;; )
+    {
+      /* since the unreferenced glyphs of a victim are all flushed, */
+      /* a page is never chosen twice                               */
+      for ( n = 0; n < manager->num_shards && !victim; n++ )
+      {
+        FTC_Shard  shard = manager->shards +
+                           ( manager->next_shard + n ) % manager->num_shards;
+        FTC_Node   first, node;
+        FT_UInt    list;
+
+
+        FTC_MANAGER_LOCK_SHARD( manager, shard );
+
+        /* probation list first, as in `ftc_shard_flush' */
+        for ( list = FTC_LIST_MAX; list-- > 0 && !victim; )
+        {
+          first = shard->lists[list];
+          if ( !first )
+            continue;
+
+          node = FTC_NODE_PREV( first );
+          for (;;)
+          {
+            if ( node->cache_index == index                &&
+                 node->ref_count <= 0                      &&
+                 FTC_ANODE( node )->glyph.page             )
+            {
+              victim = (FTC_APage)FTC_ANODE( node )->glyph.page;
+              break;
+            }
+
+            if ( node == first )
+              break;
+
+            node = FTC_NODE_PREV( node );
+          }
+        }
+
+        FTC_MANAGER_UNLOCK_SHARD( manager, shard );
+      }
+
+      if ( !victim )
+        return NULL;
+
+      FT_TRACE2(( "ftc_acache_evict: flushing page %d (%d glyphs)\n",
+                  victim->root.index, victim->num_glyphs ));
+
+      for ( n = 0; n < manager->num_shards; n++ )
+      {
+        FTC_Shard  shard = manager->shards + n;
+        FTC_Node   first, last, node;
+        FT_UInt    list;
+
+
+        FTC_MANAGER_LOCK_SHARD( manager, shard );
+
+        for ( list = 0; list < FTC_LIST_MAX; list++ )
+        {
+          first = shard->lists[list];
+          if ( !first )
+            continue;
+
+          last = FTC_NODE_PREV( first );
+          node = first;
+          for (;;)
+          {
+            FTC_Node  next    = FTC_NODE_NEXT( node );
+            FT_Bool   is_last = FT_BOOL( node == last );
+
+
+            if ( node->cache_index == index                      &&
+                 node->ref_count <= 0                            &&
+                 (FTC_APage)FTC_ANODE( node )->glyph.page == victim )
+              ftc_node_destroy( node, manager );
+
+            if ( is_last )
+              break;
+
+            node = next;
+          }
+        }
+
+        FTC_MANAGER_UNLOCK_SHARD( manager, shard );
+      }
+
+      if ( victim->num_glyphs == 0 )
+        return victim;
+
+      victim = NULL;
+    }
+  }
+
+
+  /* find room for a glyph; `width' and `height' are not zero */
+  static FT_Error
+  ftc_acache_place( FTC_ACache  cache,
+                    FT_UInt     width,
+                    FT_UInt     height,
+                    FTC_APage  *apage,
+                    FT_UInt    *ax,
+                    FT_UInt    *ay )
+  {
+    FT_Memory  memory = FTC_CACHE( cache )->memory;
+    FT_Error   error  = FT_Err_Ok;
+    FTC_APage  page   = NULL;
+    FTC_APage  stale  = NULL;
+    FT_Bool    placed = FALSE;
+    FT_UInt    n;
+
+
+    if ( width > cache->page_width || height > cache->page_height )
+    {
+      FT_TRACE2(( "ftc_acache_place: glyph too large for atlas page\n" ));
+      error = FT_THROW( Invalid_Argument );
+      goto Exit;
+    }
+
+    for ( n = 0; n < cache->num_pages; n++ )
+    {
+      page = cache->pages + n;
+      if ( page->stale )
+      {
+        if ( !stale )
+          stale = page;
+        continue;
+      }
+
+      error = ftc_apage_place( page, width, height, memory, ax, ay, &placed );
+      if ( error || placed )
+        goto Exit;
+    }
+
+    page = stale;
+    if ( !page && cache->num_pages < cache->max_pages )
+    {
+      error = ftc_acache_new_page( cache, &page );
+      if ( error )
+        goto Exit;
+    }
+
+    if ( !page )
+      page = ftc_acache_evict( cache );
+
+    if ( !page )
+    {
+      /* all pages are referenced; let the retry loop flush */
+      /* other nodes before giving up                       */
+      error = FT_THROW( Out_Of_Memory );
+      goto Exit;
+    }
+
+    if ( page->stale )
+      ftc_apage_clear( page );
+
+    /* an empty page always has room */
+    error = ftc_apage_place( page, width, height, memory, ax, ay, &placed );
+
+  Exit:
+    *apage = placed ? page : NULL;
+    return error;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                     ATLAS CACHE NODES                         *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  FT_LOCAL_DEF( void )
+  ftc_anode_free( FTC_Node   ftcanode,
+                  FTC_Cache  cache )
+  {
+    FTC_ANode  anode  = (FTC_ANode)ftcanode;
+    FTC_APage  page   = (FTC_APage)anode->glyph.page;
+    FT_Memory  memory = cache->memory;
+
+
+    /* reset the packer; the page is cleared when it is used again */
+    if ( page && --page->num_glyphs == 0 )
+    {
+      page->num_shelves = 0;
+      page->top         = 0;
+      page->stale       = TRUE;
+    }
+
+    FTC_GNode_Done( FTC_GNODE( anode ), cache );
+
+    FT_FREE( anode );
+  }
+
+
+  /* copy a glyph bitmap into its page rectangle */
+  static void
+  ftc_anode_copy_bitmap( FTC_ANode   anode,
+                         FT_Bitmap*  bitmap )
+  {
+    FTC_AtlasGlyph  glyph = &anode->glyph;
+    FTC_AtlasPage   page  = glyph->page;
+    FT_Byte*        src   = bitmap->buffer;
+    FT_Byte*        dst;
+    FT_Int          pitch = bitmap->pitch;
+    FT_UInt         y;
+
+
+    /* a negative pitch means that the rows are stored bottom-up */
+    if ( pitch < 0 )
+      src -= pitch * (FT_Int)( bitmap->rows - 1 );
+
+    dst = page->bitmap.buffer +
+          glyph->y * (FT_UInt)page->bitmap.pitch + glyph->x;
+
+    for ( y = 0; y < bitmap->rows; y++ )
+    {
+      if ( bitmap->pixel_mode == FT_PIXEL_MODE_MONO )
+      {
+        FT_UInt  x;
+
+
+        for ( x = 0; x < bitmap->width; x++ )
+          dst[x] = ( src[x >> 3] & ( 0x80 >> ( x & 7 ) ) ) ? 0xFF : 0;
+      }
+      else
+        FT_MEM_COPY( dst, src, bitmap->width );
+
+      src += pitch;
+      dst += page->bitmap.pitch;
+    }
+
+    page->serial++;
+  }
+
+
+  FT_LOCAL_DEF( FT_Error )
+  ftc_anode_new( FTC_Node   *ftcpanode,
+                 FT_Pointer  ftcgquery,
+                 FTC_Cache   ftccache )
+  {
+    FTC_ANode  *panode = (FTC_ANode*)ftcpanode;
+    FTC_GQuery  gquery = (FTC_GQuery)ftcgquery;
+    FTC_ACache  cache  = (FTC_ACache)ftccache;
+    FT_Memory   memory = ftccache->memory;
+    FT_Error    error;
+    FTC_ANode   anode  = NULL;
+
+    FTC_Family        family = gquery->family;
+    FTC_AFamilyClass  clazz  = FTC_CACHE_AFAMILY_CLASS( cache );
+    FT_Face           face;
+
+
+    if ( FT_NEW( anode ) )
+      goto Exit;
+
+    FTC_GNode_Init( FTC_GNODE( anode ), gquery->gindex, family );
+
+    error = clazz->family_load_bitmap( family, gquery->gindex,
+                                       ftccache->manager, &face );
+    if ( error )
+      goto Fail;
+
+    {
+      FT_GlyphSlot    slot   = face->glyph;
+      FT_Bitmap*      bitmap = &slot->bitmap;
+      FTC_AtlasGlyph  glyph  = &anode->glyph;
+      FTC_APage       page;
+
+
+      if ( slot->format != FT_GLYPH_FORMAT_BITMAP        ||
+           ( bitmap->pixel_mode != FT_PIXEL_MODE_GRAY  &&
+             bitmap->pixel_mode != FT_PIXEL_MODE_MONO  ) )
+      {
+        FT_TRACE2(( "ftc_anode_new:"
+                    " glyph not rendered to a gray or mono bitmap\n" ));
+        error = FT_THROW( Invalid_Glyph_Format );
+        goto Fail;
+      }
+
+      glyph->width    = bitmap->width;
+      glyph->height   = bitmap->rows;
+      glyph->left     = slot->bitmap_left;
+      glyph->top      = slot->bitmap_top;
+      glyph->xadvance = slot->advance.x;
+      glyph->yadvance = slot->advance.y;
+
+      if ( glyph->width && glyph->height )
+      {
+        error = ftc_acache_place( cache, glyph->width, glyph->height,
+                                  &page, &glyph->x, &glyph->y );
+        if ( error )
+          goto Fail;
+
+        glyph->page = &page->root;
+        page->num_glyphs++;
+
+        ftc_anode_copy_bitmap( anode, bitmap );
+      }
+    }
+
+    goto Exit;
+
+  Fail:
+    ftc_anode_free( FTC_NODE( anode ), ftccache );
+    anode = NULL;
+
+  Exit:
+    *panode = anode;
+    return error;
+  }
+
+
+  FT_LOCAL_DEF( FT_Offset )
+  ftc_anode_weight( FTC_Node   ftcanode,
+                    FTC_Cache  cache )
+  {
+    FTC_ANode  anode = (FTC_ANode)ftcanode;
+
+    FT_UNUSED( cache );
+
+
+    return sizeof ( *anode ) +
+           (FT_Offset)anode->glyph.width * anode->glyph.height;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                        ATLAS CACHE                            *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  FT_LOCAL_DEF( FT_Error )
+  ftc_acache_init( FTC_Cache  ftccache )
+  {
+    FTC_ACache  cache = (FTC_ACache)ftccache;
+
+
+    cache->page_width  = 0;
+    cache->page_height = 0;
+    cache->max_pages   = 0;
+    cache->pages       = NULL;
+    cache->num_pages   = 0;
+
+    return ftc_gcache_init( ftccache );
+  }
+
+
+  FT_LOCAL_DEF( void )
+  ftc_acache_done( FTC_Cache  ftccache )
+  {
+    FTC_ACache  cache  = (FTC_ACache)ftccache;
+    FT_Memory   memory = ftccache->memory;
+    FT_UInt     n;
+
+
+    /* the nodes refer to the pages */
+    ftc_gcache_done( ftccache );
+
+    for ( n = 0; n < cache->num_pages; n++ )
+    {
+      FTC_APage  page = cache->pages + n;
+
+
+      FT_FREE( page->root.bitmap.buffer );
+      FT_FREE( page->shelves );
+    }
+
+    FT_FREE( cache->pages );
+    cache->num_pages = 0;
+  }
+
+
+/* END */
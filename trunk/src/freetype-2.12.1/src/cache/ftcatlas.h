@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * ftcatlas.h
+ *
+ *   FreeType atlas cache (specification).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#ifndef FTCATLAS_H_
+#define FTCATLAS_H_
+
+
+#include <freetype/ftcache.h>
+#include "ftcglyph.h"
+
+
+FT_BEGIN_HEADER
+
+
+  /* blank pixels to the right of and below each glyph, so that texture */
+  /* filtering doesn't pick up the neighbours                           */
+#define FTC_ATLAS_PADDING  1
+
+
+  /* a row of glyphs within a page */
+  typedef struct  FTC_AShelfRec_
+  {
+    FT_UInt  y;
+    FT_UInt  height;
+    FT_UInt  x;       /* first unused column */
+
+  } FTC_AShelfRec, *FTC_AShelf;
+
+
+  /* the public page record, extended with the packer's state */
+  typedef struct  FTC_APageRec_
+  {
+    FTC_AtlasPageRec  root;
+
+    FTC_AShelf        shelves;
+    FT_UInt           num_shelves;
+    FT_UInt           max_shelves;
+    FT_UInt           top;         /* first row not used by a shelf */
+
+    FT_UInt           num_glyphs;
+    FT_Bool           stale;       /* must be cleared before reuse  */
+
+  } FTC_APageRec, *FTC_APage;
+
+
+  typedef struct  FTC_ANodeRec_
+  {
+    FTC_GNodeRec       gnode;
+    FTC_AtlasGlyphRec  glyph;
+
+  } FTC_ANodeRec, *FTC_ANode;
+
+#define FTC_ANODE( x )  ( (FTC_ANode)( x ) )
+
+
+  typedef struct  FTC_ACacheRec_
+  {
+    FTC_GCacheRec  gcache;
+
+    FT_UInt        page_width;
+    FT_UInt        page_height;
+    FT_UInt        max_pages;
+
+    FTC_APage      pages;       /* `max_pages' records, or NULL */
+    FT_UInt        num_pages;   /* pages with a bitmap          */
+
+  } FTC_ACacheRec, *FTC_ACache;
+
+#define FTC_ACACHE( x )  ( (FTC_ACache)( x ) )
+
+
+  /* loads and renders a glyph into the face's glyph slot */
+  typedef FT_Error
+  (*FTC_AFamily_LoadBitmapFunc)( FTC_Family   family,
+                                 FT_UInt      gindex,
+                                 FTC_Manager  manager,
+                                 FT_Face     *aface );
+
+  typedef struct  FTC_AFamilyClassRec_
+  {
+    FTC_MruListClassRec         clazz;
+    FTC_AFamily_LoadBitmapFunc  family_load_bitmap;
+
+  } FTC_AFamilyClassRec;
+
+  typedef const FTC_AFamilyClassRec*  FTC_AFamilyClass;
+
+#define FTC_AFAMILY_CLASS( x )  ( (FTC_AFamilyClass)(x) )
+
+#define FTC_CACHE_AFAMILY_CLASS( x )  \
+          FTC_AFAMILY_CLASS( FTC_CACHE_GCACHE_CLASS( x )->family_class )
+
+
+  /* */
+
+FT_END_HEADER
+
+#endif /* FTCATLAS_H_ */
+
+
+/* END */
@@ -22,6 +22,7 @@
 #include "ftcglyph.h"
 #include "ftcimage.h"
 #include "ftcsbits.h"
+#include "ftcatlas.h"
 
 #include "ftccback.h"
 #include "ftcerror.h"
@@ -62,6 +63,9 @@
     FTC_FamilyRec     family;
     FTC_BasicAttrRec  attrs;
 
+    FT_Int            font_key_state;  /* 0: unknown, 1: valid, -1: none */
+    FT_UInt32         font_key[4];
+
   } FTC_BasicFamilyRec, *FTC_BasicFamily;
 
 
@@ -88,7 +92,8 @@
 
 
     FTC_Family_Init( FTC_FAMILY( family ), cache );
-    family->attrs = query->attrs;
+    family->attrs          = query->attrs;
+    family->font_key_state = 0;
     return 0;
   }
 
@@ -103,8 +108,8 @@
     FT_UInt          result = 0;
 
 
-    error = FTC_Manager_LookupFace( manager, family->attrs.scaler.face_id,
-                                    &face );
+    error = ftc_manager_lookup_face( manager, family->attrs.scaler.face_id,
+                                     &face );
 
     if ( error || !face )
       return result;
@@ -138,7 +143,7 @@
     FT_Size          size;
 
 
-    error = FTC_Manager_LookupSize( manager, &family->attrs.scaler, &size );
+    error = ftc_manager_lookup_size( manager, &family->attrs.scaler, &size );
     if ( !error )
     {
       FT_Face  face = size->face;
@@ -156,6 +161,41 @@
   }
 
 
+  FT_CALLBACK_DEF( FT_Bool )
+  ftc_basic_family_get_store_key( FTC_Family    ftcfamily,
+                                  FTC_Manager   manager,
+                                  FTC_StoreKey  key )
+  {
+    FTC_BasicFamily  family = (FTC_BasicFamily)ftcfamily;
+    FTC_Store        store  = manager->store;
+    FTC_Scaler       scaler = &family->attrs.scaler;
+
+
+    /* ask only once per family */
+    if ( family->font_key_state == 0 )
+      family->font_key_state = store->key_func( scaler->face_id,
+                                                store->key_data,
+                                                family->font_key )
+                                 ? -1 : 1;
+
+    if ( family->font_key_state < 0 )
+      return FALSE;
+
+    key->font[0]    = family->font_key[0];
+    key->font[1]    = family->font_key[1];
+    key->font[2]    = family->font_key[2];
+    key->font[3]    = family->font_key[3];
+    key->width      = scaler->width;
+    key->height     = scaler->height;
+    key->pixel      = scaler->pixel != 0;
+    key->x_res      = scaler->pixel ? 0 : scaler->x_res;
+    key->y_res      = scaler->pixel ? 0 : scaler->y_res;
+    key->load_flags = family->attrs.load_flags;
+
+    return TRUE;
+  }
+
+
   FT_CALLBACK_DEF( FT_Error )
   ftc_basic_family_load_glyph( FTC_Family  ftcfamily,
                                FT_UInt     gindex,
@@ -170,9 +210,9 @@
 
 
     /* we will now load the glyph image */
-    error = FTC_Manager_LookupSize( cache->manager,
-                                    scaler,
-                                    &size );
+    error = ftc_manager_lookup_size( cache->manager,
+                                     scaler,
+                                     &size );
     if ( !error )
     {
       face = size->face;
@@ -207,6 +247,59 @@
   }
 
 
+  /* Used by FTC_Cache_Probe.  The family list may only be used with */
+  /* the manager lock, so the node's family is compared by value.     */
+  FT_CALLBACK_DEF( FT_Bool )
+  ftc_basic_gnode_probe( FTC_Node    ftcgnode,
+                         FT_Pointer  ftcquery,
+                         FTC_Cache   cache,
+                         FT_Bool*    list_changed )
+  {
+    FTC_GNode        gnode  = (FTC_GNode)ftcgnode;
+    FTC_BasicQuery   query  = (FTC_BasicQuery)ftcquery;
+    FTC_BasicFamily  family = (FTC_BasicFamily)gnode->family;
+
+    FT_UNUSED( cache );
+    FT_UNUSED( list_changed );
+
+
+    return FT_BOOL( family                                   &&
+                    gnode->gindex == query->gquery.gindex    &&
+                    FTC_BASIC_ATTR_COMPARE( &family->attrs,
+                                            &query->attrs  ) );
+  }
+
+
+  /* Same as above for small bitmap nodes; bitmaps that are not loaded */
+  /* yet need the manager lock (see `ftc_snode_compare').              */
+  FT_CALLBACK_DEF( FT_Bool )
+  ftc_basic_snode_probe( FTC_Node    ftcsnode,
+                         FT_Pointer  ftcquery,
+                         FTC_Cache   cache,
+                         FT_Bool*    list_changed )
+  {
+    FTC_SNode        snode  = (FTC_SNode)ftcsnode;
+    FTC_GNode        gnode  = FTC_GNODE( snode );
+    FTC_BasicQuery   query  = (FTC_BasicQuery)ftcquery;
+    FTC_BasicFamily  family = (FTC_BasicFamily)gnode->family;
+    FT_UInt          gindex = query->gquery.gindex;
+    FTC_SBit         sbit;
+
+    FT_UNUSED( cache );
+    FT_UNUSED( list_changed );
+
+
+    if ( !family                                                  ||
+         gindex - gnode->gindex >= snode->count                   ||
+         !FTC_BASIC_ATTR_COMPARE( &family->attrs, &query->attrs ) )
+      return 0;
+
+    sbit = snode->sbits + ( gindex - gnode->gindex );
+
+    return FT_BOOL( sbit->buffer || sbit->width != 255 );
+  }
+
+
   FT_CALLBACK_DEF( FT_Bool )
   ftc_basic_gnode_compare_faceid( FTC_Node    ftcgnode,
                                   FT_Pointer  ftcface_id,
@@ -295,7 +388,8 @@
                          FTC_Node       *anode )
   {
     FTC_BasicQueryRec  query;
-    FTC_Node           node = 0; /* make compiler happy */
+    FTC_Node           node   = 0; /* make compiler happy */
+    FTC_Node           probed = NULL;
     FT_Error           error;
     FT_Offset          hash;
 
@@ -335,6 +429,19 @@
 
     hash = FTC_BASIC_ATTR_HASH( &query.attrs ) + gindex;
 
+    if ( FTC_CACHE( cache )->manager->lock )
+    {
+      query.gquery.gindex = gindex;
+
+      node = probed = FTC_Cache_Probe( FTC_CACHE( cache ), hash,
+                                       ftc_basic_gnode_probe, &query );
+      if ( probed )
+      {
+        error = FT_Err_Ok;
+        goto Found;
+      }
+    }
+
 #if 1  /* inlining is about 50% faster! */
     FTC_GCACHE_LOOKUP_CMP( cache,
                            ftc_basic_family_compare,
@@ -349,17 +456,22 @@
                                FTC_GQUERY( &query ),
                                &node );
 #endif
-    if ( !error )
-    {
-      *aglyph = FTC_INODE( node )->glyph;
+    if ( error )
+      goto Unlock;
 
-      if ( anode )
-      {
-        *anode = node;
-        node->ref_count++;
-      }
+  Found:
+    *aglyph = FTC_INODE( node )->glyph;
+
+    if ( anode )
+    {
+      *anode = node;
+      node->ref_count++;
     }
 
+  Unlock:
+    if ( FTC_CACHE( cache )->manager->lock )
+      FTC_Cache_Release( FTC_CACHE( cache ), hash, probed );
+
   Exit:
     return error;
   }
@@ -376,7 +488,8 @@
                                FTC_Node       *anode )
   {
     FTC_BasicQueryRec  query;
-    FTC_Node           node = 0; /* make compiler happy */
+    FTC_Node           node   = 0; /* make compiler happy */
+    FTC_Node           probed = NULL;
     FT_Error           error;
     FT_Offset          hash;
 
@@ -410,6 +523,19 @@
 
     hash = FTC_BASIC_ATTR_HASH( &query.attrs ) + gindex;
 
+    if ( FTC_CACHE( cache )->manager->lock )
+    {
+      query.gquery.gindex = gindex;
+
+      node = probed = FTC_Cache_Probe( FTC_CACHE( cache ), hash,
+                                       ftc_basic_gnode_probe, &query );
+      if ( probed )
+      {
+        error = FT_Err_Ok;
+        goto Found;
+      }
+    }
+
     FTC_GCACHE_LOOKUP_CMP( cache,
                            ftc_basic_family_compare,
                            FTC_GNode_Compare,
@@ -417,17 +543,22 @@
                            &query,
                            node,
                            error );
-    if ( !error )
-    {
-      *aglyph = FTC_INODE( node )->glyph;
+    if ( error )
+      goto Unlock;
 
-      if ( anode )
-      {
-        *anode = node;
-        node->ref_count++;
-      }
+  Found:
+    *aglyph = FTC_INODE( node )->glyph;
+
+    if ( anode )
+    {
+      *anode = node;
+      node->ref_count++;
     }
 
+  Unlock:
+    if ( FTC_CACHE( cache )->manager->lock )
+      FTC_Cache_Release( FTC_CACHE( cache ), hash, probed );
+
   Exit:
     return error;
   }
@@ -451,7 +582,8 @@
     },
 
     ftc_basic_family_get_count,
-    ftc_basic_family_load_bitmap
+    ftc_basic_family_load_bitmap,
+    ftc_basic_family_get_store_key
   };
 
 
@@ -496,7 +628,8 @@
   {
     FT_Error           error;
     FTC_BasicQueryRec  query;
-    FTC_Node           node = 0; /* make compiler happy */
+    FTC_Node           node   = 0; /* make compiler happy */
+    FTC_Node           probed = NULL;
     FT_Offset          hash;
 
 
@@ -535,6 +668,19 @@
     hash = FTC_BASIC_ATTR_HASH( &query.attrs ) +
            gindex / FTC_SBIT_ITEMS_PER_NODE;
 
+    if ( FTC_CACHE( cache )->manager->lock )
+    {
+      query.gquery.gindex = gindex;
+
+      node = probed = FTC_Cache_Probe( FTC_CACHE( cache ), hash,
+                                       ftc_basic_snode_probe, &query );
+      if ( probed )
+      {
+        error = FT_Err_Ok;
+        goto Found;
+      }
+    }
+
 #if 1  /* inlining is about 50% faster! */
     FTC_GCACHE_LOOKUP_CMP( cache,
                            ftc_basic_family_compare,
@@ -551,8 +697,9 @@
                                &node );
 #endif
     if ( error )
-      goto Exit;
+      goto Unlock;
 
+  Found:
     *ansbit = FTC_SNODE( node )->sbits +
               ( gindex - FTC_GNODE( node )->gindex );
 
@@ -562,7 +709,10 @@
       node->ref_count++;
     }
 
-  Exit:
+  Unlock:
+    if ( FTC_CACHE( cache )->manager->lock )
+      FTC_Cache_Release( FTC_CACHE( cache ), hash, probed );
+
     return error;
   }
 
@@ -579,7 +729,8 @@
   {
     FT_Error           error;
     FTC_BasicQueryRec  query;
-    FTC_Node           node = 0; /* make compiler happy */
+    FTC_Node           node   = 0; /* make compiler happy */
+    FTC_Node           probed = NULL;
     FT_Offset          hash;
 
 
@@ -612,6 +763,19 @@
     hash = FTC_BASIC_ATTR_HASH( &query.attrs ) +
              gindex / FTC_SBIT_ITEMS_PER_NODE;
 
+    if ( FTC_CACHE( cache )->manager->lock )
+    {
+      query.gquery.gindex = gindex;
+
+      node = probed = FTC_Cache_Probe( FTC_CACHE( cache ), hash,
+                                       ftc_basic_snode_probe, &query );
+      if ( probed )
+      {
+        error = FT_Err_Ok;
+        goto Found;
+      }
+    }
+
     FTC_GCACHE_LOOKUP_CMP( cache,
                            ftc_basic_family_compare,
                            FTC_SNode_Compare,
@@ -620,8 +784,9 @@
                            node,
                            error );
     if ( error )
-      goto Exit;
+      goto Unlock;
 
+  Found:
     *ansbit = FTC_SNODE( node )->sbits +
               ( gindex - FTC_GNODE( node )->gindex );
 
@@ -631,7 +796,162 @@
       node->ref_count++;
     }
 
-  Exit:
+  Unlock:
+    if ( FTC_CACHE( cache )->manager->lock )
+      FTC_Cache_Release( FTC_CACHE( cache ), hash, probed );
+
+    return error;
+  }
+
+
+ /*
+  *
+  * basic atlas cache
+  *
+  */
+
+  static
+  const FTC_AFamilyClassRec  ftc_basic_atlas_family_class =
+  {
+    {
+      sizeof ( FTC_BasicFamilyRec ),
+      ftc_basic_family_compare,     /* FTC_MruNode_CompareFunc  node_compare */
+      ftc_basic_family_init,        /* FTC_MruNode_InitFunc     node_init    */
+      NULL,                         /* FTC_MruNode_ResetFunc    node_reset   */
+      NULL                          /* FTC_MruNode_DoneFunc     node_done    */
+    },
+
+    ftc_basic_family_load_bitmap
+  };
+
+
+  static
+  const FTC_GCacheClassRec  ftc_basic_atlas_cache_class =
+  {
+    {
+      ftc_anode_new,                  /* FTC_Node_NewFunc      node_new           */
+      ftc_anode_weight,               /* FTC_Node_WeightFunc   node_weight        */
+      ftc_gnode_compare,              /* FTC_Node_CompareFunc  node_compare       */
+      ftc_basic_gnode_compare_faceid, /* FTC_Node_CompareFunc  node_remove_faceid */
+      ftc_anode_free,                 /* FTC_Node_FreeFunc     node_free          */
+
+      sizeof ( FTC_ACacheRec ),
+      ftc_acache_init,                /* FTC_Cache_InitFunc    cache_init         */
+      ftc_acache_done                 /* FTC_Cache_DoneFunc    cache_done         */
+    },
+
+    (FTC_MruListClass)&ftc_basic_atlas_family_class
+  };
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_AtlasCache_New( FTC_Manager      manager,
+                      FT_UInt          page_width,
+                      FT_UInt          page_height,
+                      FT_UInt          max_pages,
+                      FTC_AtlasCache  *acache )
+  {
+    FT_Error    error;
+    FTC_ACache  cache = NULL;
+
+
+    if ( acache )
+      *acache = NULL;
+
+    if ( !page_width || !page_height || !max_pages || !acache ||
+         page_width > 0x7FFF || page_height > 0x7FFF        )
+      return FT_THROW( Invalid_Argument );
+
+    error = FTC_GCache_New( manager, &ftc_basic_atlas_cache_class,
+                            (FTC_GCache*)&cache );
+    if ( !error )
+    {
+      /* no lookup can happen before we return the handle */
+      cache->page_width  = page_width;
+      cache->page_height = page_height;
+      cache->max_pages   = max_pages;
+
+      *acache = (FTC_AtlasCache)cache;
+    }
+
+    return error;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_AtlasCache_Lookup( FTC_AtlasCache   cache,
+                         FTC_ImageType    type,
+                         FT_UInt          gindex,
+                         FTC_AtlasGlyph  *aglyph,
+                         FTC_Node        *anode )
+  {
+    FT_Error           error;
+    FTC_BasicQueryRec  query;
+    FTC_Node           node   = 0; /* make compiler happy */
+    FTC_Node           probed = NULL;
+    FT_Offset          hash;
+
+
+    if ( anode )
+      *anode = NULL;
+
+    /* other argument checks delayed to `FTC_Cache_Lookup' */
+    if ( !aglyph || !type )
+      return FT_THROW( Invalid_Argument );
+
+    *aglyph = NULL;
+
+    query.attrs.scaler.face_id = type->face_id;
+    query.attrs.scaler.width   = type->width;
+    query.attrs.scaler.height  = type->height;
+    query.attrs.load_flags     = (FT_UInt)type->flags;
+
+    query.attrs.scaler.pixel = 1;
+    query.attrs.scaler.x_res = 0;  /* make compilers happy */
+    query.attrs.scaler.y_res = 0;
+
+    hash = FTC_BASIC_ATTR_HASH( &query.attrs ) + gindex;
+
+    if ( FTC_CACHE( cache )->manager->lock )
+    {
+      query.gquery.gindex = gindex;
+
+      node = probed = FTC_Cache_Probe( FTC_CACHE( cache ), hash,
+                                       ftc_basic_gnode_probe, &query );
+      if ( probed )
+      {
+        error = FT_Err_Ok;
+        goto Found;
+      }
+    }
+
+    FTC_GCACHE_LOOKUP_CMP( cache,
+                           ftc_basic_family_compare,
+                           FTC_GNode_Compare,
+                           hash, gindex,
+                           &query,
+                           node,
+                           error );
+    if ( error )
+      goto Unlock;
+
+  Found:
+    *aglyph = &FTC_ANODE( node )->glyph;
+
+    if ( anode )
+    {
+      *anode = node;
+      node->ref_count++;
+    }
+
+  Unlock:
+    if ( FTC_CACHE( cache )->manager->lock )
+      FTC_Cache_Release( FTC_CACHE( cache ), hash, probed );
+
     return error;
   }
 
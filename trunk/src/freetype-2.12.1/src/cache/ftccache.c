@@ -43,46 +43,111 @@
   /*************************************************************************/
   /*************************************************************************/
 
-  /* add a new node to the head of the manager's circular MRU list */
+  /* add a node to the head of one of its shard's circular MRU lists */
   static void
-  ftc_node_mru_link( FTC_Node     node,
-                     FTC_Manager  manager )
+  ftc_shard_list_prepend( FTC_Shard  shard,
+                          FTC_Node   node,
+                          FT_UInt    list )
   {
-    void  *nl = &manager->nodes_list;
+    void  *nl = &shard->lists[list];
 
 
     FTC_MruNode_Prepend( (FTC_MruNode*)nl,
                          (FTC_MruNode)node );
-    manager->num_nodes++;
+    node->list_index = (FT_Byte)list;
+    shard->num_list_nodes[list]++;
   }
 
 
-  /* remove a node from the manager's MRU list */
+  /* remove a node from its MRU list */
   static void
-  ftc_node_mru_unlink( FTC_Node     node,
-                       FTC_Manager  manager )
+  ftc_shard_list_remove( FTC_Shard  shard,
+                         FTC_Node   node )
   {
-    void  *nl = &manager->nodes_list;
+    void  *nl = &shard->lists[node->list_index];
 
 
     FTC_MruNode_Remove( (FTC_MruNode*)nl,
                         (FTC_MruNode)node );
-    manager->num_nodes--;
+    shard->num_list_nodes[node->list_index]--;
   }
 
 
-#ifndef FTC_INLINE
+  /* add a new node to its shard */
+  static void
+  ftc_node_mru_link( FTC_Node     node,
+                     FTC_Manager  manager )
+  {
+    FTC_Shard  shard = manager->shards +
+                       FTC_SHARD_INDEX( manager, node->hash );
+
+
+    ftc_shard_list_prepend( shard, node,
+                            manager->policy == FTC_EVICTION_POLICY_2Q
+                              ? FTC_LIST_PROBATION
+                              : FTC_LIST_MAIN );
+    manager->num_nodes++;
+  }
 
-  /* move a node to the head of the manager's MRU list */
+
+  /* remove a node from its shard */
   static void
+  ftc_node_mru_unlink( FTC_Node     node,
+                       FTC_Manager  manager )
+  {
+    FTC_Shard  shard = manager->shards +
+                       FTC_SHARD_INDEX( manager, node->hash );
+
+
+    ftc_shard_list_remove( shard, node );
+    manager->num_nodes--;
+  }
+
+
+  FT_LOCAL_DEF( void )
   ftc_node_mru_up( FTC_Node     node,
                    FTC_Manager  manager )
   {
-    FTC_MruNode_Up( (FTC_MruNode*)&manager->nodes_list,
-                    (FTC_MruNode)node );
+    FTC_Shard  shard = manager->shards +
+                       FTC_SHARD_INDEX( manager, node->hash );
+
+
+    if ( node->list_index == FTC_LIST_MAIN )
+    {
+      if ( node != shard->lists[FTC_LIST_MAIN] )
+        FTC_MruNode_Up( (FTC_MruNode*)&shard->lists[FTC_LIST_MAIN],
+                        (FTC_MruNode)node );
+      return;
+    }
+
+    /* used again: promote the node */
+    ftc_shard_list_remove( shard, node );
+    ftc_shard_list_prepend( shard, node, FTC_LIST_MAIN );
+  }
+
+
+  /* Called before evicting nodes with the 2Q policy: move the least */
+  /* recently used nodes of the main list back to probation until it */
+  /* holds at most 3/4 of the shard, leaving room for new nodes to    */
+  /* prove themselves.  The caller holds the shard.                   */
+  FT_LOCAL_DEF( void )
+  ftc_shard_balance( FTC_Shard  shard )
+  {
+    while ( shard->num_list_nodes[FTC_LIST_MAIN] * 4 >
+              ( shard->num_list_nodes[FTC_LIST_MAIN] +
+                shard->num_list_nodes[FTC_LIST_PROBATION] ) * 3 )
+    {
+      FTC_Node  last = FTC_NODE_PREV( shard->lists[FTC_LIST_MAIN] );
+
+
+      ftc_shard_list_remove( shard, last );
+      ftc_shard_list_prepend( shard, last, FTC_LIST_PROBATION );
+    }
   }
 
 
+#ifndef FTC_INLINE
+
   /* get a top bucket for specified hash from cache,
    * body for FTC_NODE_TOP_FOR_HASH( cache, hash )
    */
@@ -90,14 +155,16 @@
   ftc_get_top_node_for_hash( FTC_Cache  cache,
                              FT_Offset  hash )
   {
+    FTC_Hash   table = cache->hashes +
+                       FTC_SHARD_INDEX( cache->manager, hash );
     FT_Offset  idx;
 
 
-    idx = hash & cache->mask;
-    if ( idx < cache->p )
-      idx = hash & ( 2 * cache->mask + 1 );
+    idx = hash & table->mask;
+    if ( idx < table->p )
+      idx = hash & ( 2 * table->mask + 1 );
 
-    return cache->buckets + idx;
+    return table->buckets + idx;
   }
 
 #endif /* !FTC_INLINE */
@@ -108,18 +175,19 @@
    * performance!
    */
   static void
-  ftc_cache_resize( FTC_Cache  cache )
+  ftc_hash_resize( FTC_Hash   table,
+                   FT_Memory  memory )
   {
     for (;;)
     {
       FTC_Node  node, *pnode;
-      FT_UFast  p     = cache->p;
-      FT_UFast  mask  = cache->mask;
+      FT_UFast  p     = table->p;
+      FT_UFast  mask  = table->mask;
       FT_UFast  count = mask + p + 1;    /* number of buckets */
 
 
       /* do we need to expand the buckets array? */
-      if ( cache->slack < 0 )
+      if ( table->slack < 0 )
       {
         FTC_Node  new_list = NULL;
 
@@ -129,18 +197,17 @@
          */
         if ( p >= mask )
         {
-          FT_Memory  memory = cache->memory;
-          FT_Error   error;
+          FT_Error  error;
 
 
           /* if we can't expand the array, leave immediately */
-          if ( FT_RENEW_ARRAY( cache->buckets,
+          if ( FT_RENEW_ARRAY( table->buckets,
                                ( mask + 1 ) * 2, ( mask + 1 ) * 4 ) )
             break;
         }
 
         /* split a single bucket */
-        pnode = cache->buckets + p;
+        pnode = table->buckets + p;
 
         for (;;)
         {
@@ -158,21 +225,21 @@
             pnode = &node->link;
         }
 
-        cache->buckets[p + mask + 1] = new_list;
+        table->buckets[p + mask + 1] = new_list;
 
-        cache->slack += FTC_HASH_MAX_LOAD;
+        table->slack += FTC_HASH_MAX_LOAD;
 
         if ( p >= mask )
         {
-          cache->mask = 2 * mask + 1;
-          cache->p    = 0;
+          table->mask = 2 * mask + 1;
+          table->p    = 0;
         }
         else
-          cache->p = p + 1;
+          table->p = p + 1;
       }
 
       /* do we need to shrink the buckets array? */
-      else if ( cache->slack > (FT_Long)count * FTC_HASH_SUB_LOAD )
+      else if ( table->slack > (FT_Long)count * FTC_HASH_SUB_LOAD )
       {
         FT_UFast   old_index = p + mask;
         FTC_Node*  pold;
@@ -183,31 +250,30 @@
 
         if ( p == 0 )
         {
-          FT_Memory  memory = cache->memory;
-          FT_Error   error;
+          FT_Error  error;
 
 
           /* if we can't shrink the array, leave immediately */
-          if ( FT_QRENEW_ARRAY( cache->buckets,
+          if ( FT_QRENEW_ARRAY( table->buckets,
                                ( mask + 1 ) * 2, mask + 1 ) )
             break;
 
-          cache->mask >>= 1;
-          p             = cache->mask;
+          table->mask >>= 1;
+          p             = table->mask;
         }
         else
           p--;
 
-        pnode = cache->buckets + p;
+        pnode = table->buckets + p;
         while ( *pnode )
           pnode = &(*pnode)->link;
 
-        pold   = cache->buckets + old_index;
+        pold   = table->buckets + old_index;
         *pnode = *pold;
         *pold  = NULL;
 
-        cache->slack -= FTC_HASH_MAX_LOAD;
-        cache->p      = p;
+        table->slack -= FTC_HASH_MAX_LOAD;
+        table->p      = p;
       }
 
       /* otherwise, the hash table is balanced */
@@ -222,7 +288,9 @@
   ftc_node_hash_unlink( FTC_Node   node0,
                         FTC_Cache  cache )
   {
-    FTC_Node  *pnode = FTC_NODE_TOP_FOR_HASH( cache, node0->hash );
+    FTC_Hash   table = cache->hashes +
+                       FTC_SHARD_INDEX( cache->manager, node0->hash );
+    FTC_Node  *pnode = FTC_HASH_TOP_FOR_HASH( table, node0->hash );
 
 
     for (;;)
@@ -245,8 +313,8 @@
     *pnode      = node0->link;
     node0->link = NULL;
 
-    cache->slack++;
-    ftc_cache_resize( cache );
+    table->slack++;
+    ftc_hash_resize( table, cache->memory );
   }
 
 
@@ -255,18 +323,21 @@
   ftc_node_hash_link( FTC_Node   node,
                       FTC_Cache  cache )
   {
-    FTC_Node  *pnode = FTC_NODE_TOP_FOR_HASH( cache, node->hash );
+    FTC_Hash   table = cache->hashes +
+                       FTC_SHARD_INDEX( cache->manager, node->hash );
+    FTC_Node  *pnode = FTC_HASH_TOP_FOR_HASH( table, node->hash );
 
 
     node->link = *pnode;
     *pnode     = node;
 
-    cache->slack--;
-    ftc_cache_resize( cache );
+    table->slack--;
+    ftc_hash_resize( table, cache->memory );
   }
 
 
-  /* remove a node from the cache manager */
+  /* remove a node from the cache manager; */
+  /* the caller holds the node's shard     */
   FT_LOCAL_DEF( void )
   ftc_node_destroy( FTC_Node     node,
                     FTC_Manager  manager )
@@ -293,7 +364,9 @@
     }
 #endif
 
-    manager->cur_weight -= cache->clazz.node_weight( node, cache );
+    FTC_CACHE_SUB_WEIGHT( cache, cache->clazz.node_weight( node, cache ) );
+
+    cache->hashes[FTC_SHARD_INDEX( manager, node->hash )].num_evictions++;
 
     /* remove node from mru list */
     ftc_node_mru_unlink( node, manager );
@@ -332,15 +405,29 @@
   FT_LOCAL_DEF( FT_Error )
   ftc_cache_init( FTC_Cache  cache )
   {
-    FT_Memory  memory = cache->memory;
+    FT_Memory  memory     = cache->memory;
+    FT_UInt    num_shards = cache->manager->num_shards;
+    FT_UInt    nn;
     FT_Error   error;
 
 
-    cache->p     = 0;
-    cache->mask  = FTC_HASH_INITIAL_SIZE - 1;
-    cache->slack = FTC_HASH_INITIAL_SIZE * FTC_HASH_MAX_LOAD;
+    if ( FT_NEW_ARRAY( cache->hashes, num_shards ) )
+      goto Exit;
+
+    for ( nn = 0; nn < num_shards; nn++ )
+    {
+      FTC_Hash  table = cache->hashes + nn;
+
+
+      table->p     = 0;
+      table->mask  = FTC_HASH_INITIAL_SIZE - 1;
+      table->slack = FTC_HASH_INITIAL_SIZE * FTC_HASH_MAX_LOAD;
+
+      if ( FT_NEW_ARRAY( table->buckets, FTC_HASH_INITIAL_SIZE * 2 ) )
+        break;
+    }
 
-    FT_MEM_NEW_ARRAY( cache->buckets, FTC_HASH_INITIAL_SIZE * 2 );
+  Exit:
     return error;
   }
 
@@ -348,37 +435,48 @@
   static void
   FTC_Cache_Clear( FTC_Cache  cache )
   {
-    if ( cache && cache->buckets )
+    if ( cache && cache->hashes )
     {
       FTC_Manager  manager = cache->manager;
-      FT_UFast     i;
-      FT_UFast     count;
-
+      FT_UInt      nn;
 
-      count = cache->p + cache->mask + 1;
 
-      for ( i = 0; i < count; i++ )
+      for ( nn = 0; nn < manager->num_shards; nn++ )
       {
-        FTC_Node  node = cache->buckets[i], next;
+        FTC_Hash  table = cache->hashes + nn;
+        FT_UFast  i;
+        FT_UFast  count;
+
+
+        if ( !table->buckets )
+          continue;
 
+        count = table->p + table->mask + 1;
 
-        while ( node )
+        for ( i = 0; i < count; i++ )
         {
-          next        = node->link;
-          node->link  = NULL;
+          FTC_Node  node = table->buckets[i], next;
 
-          /* remove node from mru list */
-          ftc_node_mru_unlink( node, manager );
 
-          /* now finalize it */
-          manager->cur_weight -= cache->clazz.node_weight( node, cache );
+          while ( node )
+          {
+            next        = node->link;
+            node->link  = NULL;
+
+            /* remove node from mru list */
+            ftc_node_mru_unlink( node, manager );
 
-          cache->clazz.node_free( node, cache );
-          node = next;
+            /* now finalize it */
+            FTC_CACHE_SUB_WEIGHT( cache,
+                                  cache->clazz.node_weight( node, cache ) );
+
+            cache->clazz.node_free( node, cache );
+            node = next;
+          }
+          table->buckets[i] = NULL;
         }
-        cache->buckets[i] = NULL;
+        ftc_hash_resize( table, cache->memory );
       }
-      ftc_cache_resize( cache );
     }
   }
 
@@ -393,10 +491,16 @@
 
       FTC_Cache_Clear( cache );
 
-      FT_FREE( cache->buckets );
-      cache->mask  = 0;
-      cache->p     = 0;
-      cache->slack = 0;
+      if ( cache->hashes )
+      {
+        FT_UInt  nn;
+
+
+        for ( nn = 0; nn < cache->manager->num_shards; nn++ )
+          FT_FREE( cache->hashes[nn].buckets );
+
+        FT_FREE( cache->hashes );
+      }
 
       cache->memory = NULL;
     }
@@ -416,7 +520,7 @@
                  FTC_Node   node )
   {
     node->hash        = hash;
-    node->cache_index = (FT_UShort)cache->index;
+    node->cache_index = (FT_Byte)cache->index;
     node->ref_count   = 0;
 
     ftc_node_hash_link( node, cache );
@@ -426,9 +530,10 @@
       FTC_Manager  manager = cache->manager;
 
 
-      manager->cur_weight += cache->clazz.node_weight( node, cache );
+      FTC_CACHE_ADD_WEIGHT( cache, cache->clazz.node_weight( node, cache ) );
 
-      if ( manager->cur_weight >= manager->max_weight )
+      if ( manager->cur_weight >= manager->max_weight ||
+           FTC_CACHE_OVER_LIMIT( cache )              )
       {
         node->ref_count++;
         FTC_Manager_Compress( manager );
@@ -448,6 +553,8 @@
     FTC_Node  node;
 
 
+    cache->hashes[FTC_SHARD_INDEX( cache->manager, hash )].num_misses++;
+
     /*
      * We use the FTC_CACHE_TRYLOOP macros to support out-of-memory
      * errors (OOM) correctly, i.e., by flushing the cache progressively
@@ -540,13 +647,10 @@
     }
 
     /* move to head of MRU list */
-    {
-      FTC_Manager  manager = cache->manager;
+    ftc_node_mru_up( node, cache->manager );
 
+    cache->hashes[FTC_SHARD_INDEX( cache->manager, hash )].num_hits++;
 
-      if ( node != manager->nodes_list )
-        ftc_node_mru_up( node, manager );
-    }
     *anode = node;
 
     return error;
@@ -558,60 +662,148 @@
 #endif /* !FTC_INLINE */
 
 
+  FT_LOCAL_DEF( FTC_Node )
+  FTC_Cache_Probe( FTC_Cache             cache,
+                   FT_Offset             hash,
+                   FTC_Node_CompareFunc  probe,
+                   FT_Pointer            query )
+  {
+    FTC_Manager  manager = cache->manager;
+    FT_UInt      idx     = FTC_SHARD_INDEX( manager, hash );
+    FTC_Shard    shard   = manager->shards + idx;
+    FTC_Node*    bucket;
+    FTC_Node*    pnode;
+    FTC_Node     node;
+
+
+    FTC_SHARD_LOCK( manager, shard );
+
+    bucket = pnode = FTC_HASH_TOP_FOR_HASH( cache->hashes + idx, hash );
+
+    for (;;)
+    {
+      node = *pnode;
+      if ( !node )
+        break;
+
+      if ( node->hash == hash && probe( node, query, cache, NULL ) )
+      {
+        if ( node != *bucket )
+        {
+          *pnode     = node->link;
+          node->link = *bucket;
+          *bucket    = node;
+        }
+
+        ftc_node_mru_up( node, manager );
+        cache->hashes[idx].num_hits++;
+        return node;
+      }
+
+      pnode = &node->link;
+    }
+
+    /* the manager lock must be acquired first */
+    FTC_SHARD_UNLOCK( manager, shard );
+
+    FTC_MANAGER_LOCK( manager );
+    FTC_SHARD_LOCK( manager, shard );
+
+    manager->locked_shard = shard;
+
+    return NULL;
+  }
+
+
+  FT_LOCAL_DEF( void )
+  FTC_Cache_Release( FTC_Cache  cache,
+                     FT_Offset  hash,
+                     FTC_Node   probed )
+  {
+    FTC_Manager  manager = cache->manager;
+    FTC_Shard    shard   = manager->shards +
+                           FTC_SHARD_INDEX( manager, hash );
+
+
+    if ( probed )
+      FTC_SHARD_UNLOCK( manager, shard );
+    else
+    {
+      manager->locked_shard = NULL;
+
+      FTC_SHARD_UNLOCK( manager, shard );
+      FTC_MANAGER_UNLOCK( manager );
+    }
+  }
+
+
   FT_LOCAL_DEF( void )
   FTC_Cache_RemoveFaceID( FTC_Cache   cache,
                           FTC_FaceID  face_id )
   {
-    FT_UFast     i, count;
     FTC_Manager  manager = cache->manager;
-    FTC_Node     frees   = NULL;
+    FT_UInt      nn;
 
 
-    count = cache->p + cache->mask + 1;
-    for ( i = 0; i < count; i++ )
+    for ( nn = 0; nn < manager->num_shards; nn++ )
     {
-      FTC_Node*  pnode = cache->buckets + i;
+      FTC_Shard  shard = manager->shards + nn;
+      FTC_Hash   table = cache->hashes + nn;
+      FTC_Node   frees = NULL;
+      FT_UFast   i, count;
 
 
-      for (;;)
-      {
-        FTC_Node  node = *pnode;
-        FT_Bool   list_changed = FALSE;
+      FTC_MANAGER_LOCK_SHARD( manager, shard );
 
+      count = table->p + table->mask + 1;
+      for ( i = 0; i < count; i++ )
+      {
+        FTC_Node*  pnode = table->buckets + i;
 
-        if ( !node )
-          break;
 
-        if ( cache->clazz.node_remove_faceid( node, face_id,
-                                              cache, &list_changed ) )
+        for (;;)
         {
-          *pnode     = node->link;
-          node->link = frees;
-          frees      = node;
+          FTC_Node  node = *pnode;
+          FT_Bool   list_changed = FALSE;
+
+
+          if ( !node )
+            break;
+
+          if ( cache->clazz.node_remove_faceid( node, face_id,
+                                                cache, &list_changed ) )
+          {
+            *pnode     = node->link;
+            node->link = frees;
+            frees      = node;
+          }
+          else
+            pnode = &node->link;
         }
-        else
-          pnode = &node->link;
       }
-    }
 
-    /* remove all nodes in the free list */
-    while ( frees )
-    {
-      FTC_Node  node;
+      /* remove all nodes in the free list */
+      while ( frees )
+      {
+        FTC_Node  node;
 
 
-      node  = frees;
-      frees = node->link;
+        node  = frees;
+        frees = node->link;
 
-      manager->cur_weight -= cache->clazz.node_weight( node, cache );
-      ftc_node_mru_unlink( node, manager );
+        FTC_CACHE_SUB_WEIGHT( cache,
+                              cache->clazz.node_weight( node, cache ) );
+        ftc_node_mru_unlink( node, manager );
 
-      cache->clazz.node_free( node, cache );
+        cache->clazz.node_free( node, cache );
 
-      cache->slack++;
-    }
+        table->slack++;
+      }
 
-    ftc_cache_resize( cache );
+      ftc_hash_resize( table, cache->memory );
+
+      FTC_MANAGER_UNLOCK_SHARD( manager, shard );
+    }
   }
 
 
@@ -60,7 +60,8 @@ FT_BEGIN_HEADER
     FTC_MruNodeRec  mru;          /* circular mru list pointer           */
     FTC_Node        link;         /* used for hashing                    */
     FT_Offset       hash;         /* used for hashing too                */
-    FT_UShort       cache_index;  /* index of cache the node belongs to  */
+    FT_Byte         cache_index;  /* index of cache the node belongs to  */
+    FT_Byte         list_index;   /* MRU list of the node in its shard   */
     FT_Short        ref_count;    /* reference count for this node       */
 
   } FTC_NodeRec;
@@ -72,12 +73,36 @@ FT_BEGIN_HEADER
 #define FTC_NODE_NEXT( x )  FTC_NODE( (x)->mru.next )
 #define FTC_NODE_PREV( x )  FTC_NODE( (x)->mru.prev )
 
+
+  /* each cache implements a dynamic hash table per shard to manage its */
+  /* nodes (see FTC_ShardRec); it also counts the lookups of the shard  */
+  /* for FTC_Manager_GetStats, protected by the shard's lock            */
+  typedef struct  FTC_HashRec_
+  {
+    FT_UFast   p;
+    FT_UFast   mask;
+    FT_Long    slack;
+    FTC_Node*  buckets;
+
+    FT_ULong   num_hits;
+    FT_ULong   num_misses;
+    FT_ULong   num_evictions;
+
+  } FTC_HashRec, *FTC_Hash;
+
+
+#define FTC_HASH_TOP_FOR_HASH( table, hash )                      \
+        ( ( table )->buckets +                                    \
+            ( ( ( ( hash ) &   ( table )->mask ) < ( table )->p ) \
+              ? ( ( hash ) & ( ( table )->mask * 2 + 1 ) )        \
+              : ( ( hash ) &   ( table )->mask ) ) )
+
 #ifdef FTC_INLINE
-#define FTC_NODE_TOP_FOR_HASH( cache, hash )                      \
-        ( ( cache )->buckets +                                    \
-            ( ( ( ( hash ) &   ( cache )->mask ) < ( cache )->p ) \
-              ? ( ( hash ) & ( ( cache )->mask * 2 + 1 ) )        \
-              : ( ( hash ) &   ( cache )->mask ) ) )
+#define FTC_NODE_TOP_FOR_HASH( cache, hash )                         \
+        FTC_HASH_TOP_FOR_HASH( ( cache )->hashes +                   \
+                                 FTC_SHARD_INDEX( ( cache )->manager, \
+                                                  hash ),            \
+                               hash )
 #else
   FT_LOCAL( FTC_Node* )
   ftc_get_top_node_for_hash( FTC_Cache  cache,
@@ -139,13 +164,9 @@ FT_BEGIN_HEADER
   } FTC_CacheClassRec;
 
 
-  /* each cache really implements a dynamic hash table to manage its nodes */
   typedef struct  FTC_CacheRec_
   {
-    FT_UFast           p;
-    FT_UFast           mask;
-    FT_Long            slack;
-    FTC_Node*          buckets;
+    FTC_Hash           hashes;      /* one per manager shard  */
 
     FTC_CacheClassRec  clazz;       /* local copy, for speed  */
 
@@ -155,6 +176,9 @@ FT_BEGIN_HEADER
 
     FTC_CacheClass     org_class;   /* original class pointer */
 
+    FT_Offset          max_weight;  /* 0 if only the manager's */
+    FT_Offset          cur_weight;  /* limit applies           */
+
   } FTC_CacheRec;
 
 
@@ -184,12 +208,37 @@ FT_BEGIN_HEADER
                     FTC_Node   *anode );
 #endif
 
+  /* move a node to the head of its shard's MRU lists, following the */
+  /* manager's eviction policy; the caller holds the node's shard     */
+  FT_LOCAL( void )
+  ftc_node_mru_up( FTC_Node     node,
+                   FTC_Manager  manager );
+
   FT_LOCAL( FT_Error )
   FTC_Cache_NewNode( FTC_Cache   cache,
                      FT_Offset   hash,
                      FT_Pointer  query,
                      FTC_Node   *anode );
 
+  /* Used by the lookup functions if the manager has lock functions.
+   * Acquire the shard of `hash' and look up its node with `probe',
+   * which must not change anything but `query'.  If a node is found,
+   * move it to the head of the shard's MRU list and return it with the
+   * shard held.  Otherwise, return NULL with both the manager and the
+   * shard held; the caller must then use the normal lookup.
+   */
+  FT_LOCAL( FTC_Node )
+  FTC_Cache_Probe( FTC_Cache             cache,
+                   FT_Offset             hash,
+                   FTC_Node_CompareFunc  probe,
+                   FT_Pointer            query );
+
+  /* release the locks acquired by FTC_Cache_Probe */
+  FT_LOCAL( void )
+  FTC_Cache_Release( FTC_Cache  cache,
+                     FT_Offset  hash,
+                     FTC_Node   probed );
+
   /* Remove all nodes that relate to a given face_id.  This is useful
    * when un-installing fonts.  Note that if a cache node relates to
    * the face_id but is locked (i.e., has `ref_count > 0'), the node
@@ -214,13 +263,16 @@ FT_BEGIN_HEADER
     FT_Offset             _hash    = (FT_Offset)(hash);                  \
     FTC_Node_CompareFunc  _nodcomp = (FTC_Node_CompareFunc)(nodecmp);    \
     FT_Bool               _list_changed = FALSE;                         \
+    FT_UInt               _idx     = FTC_SHARD_INDEX( _cache->manager,   \
+                                                      _hash );           \
                                                                          \
                                                                          \
     error = FT_Err_Ok;                                                   \
     node  = NULL;                                                        \
                                                                          \
     /* Go to the `top' node of the list sharing same masked hash */      \
-    _bucket = _pnode = FTC_NODE_TOP_FOR_HASH( _cache, _hash );           \
+    _bucket = _pnode = FTC_HASH_TOP_FOR_HASH( _cache->hashes + _idx,     \
+                                              _hash );                   \
                                                                          \
     /* Look up a node with identical hash and queried properties.    */  \
     /* NOTE: _nodcomp() may change the linked list to reduce memory. */  \
@@ -240,7 +292,8 @@ FT_BEGIN_HEADER
     if ( _list_changed )                                                 \
     {                                                                    \
       /* Update _bucket by possibly modified linked list */              \
-      _bucket = _pnode = FTC_NODE_TOP_FOR_HASH( _cache, _hash );         \
+      _bucket = _pnode = FTC_HASH_TOP_FOR_HASH( _cache->hashes + _idx,   \
+                                                _hash );                 \
                                                                          \
       /* Update _pnode by possibly modified linked list */               \
       while ( *_pnode != _node )                                         \
@@ -264,15 +317,8 @@ FT_BEGIN_HEADER
     }                                                                    \
                                                                          \
     /* Update MRU list */                                                \
-    {                                                                    \
-      FTC_Manager  _manager = _cache->manager;                           \
-      void*        _nl      = &_manager->nodes_list;                     \
-                                                                         \
-                                                                         \
-      if ( _node != _manager->nodes_list )                               \
-        FTC_MruNode_Up( (FTC_MruNode*)_nl,                               \
-                        (FTC_MruNode)_node );                            \
-    }                                                                    \
+    ftc_node_mru_up( _node, _cache->manager );                           \
+    _cache->hashes[_idx].num_hits++;                                     \
     goto Ok_;                                                            \
                                                                          \
   NewNode_:                                                              \
@@ -24,6 +24,7 @@
 #include "ftcmanag.h"
 #include "ftcglyph.h"
 #include "ftcsbits.h"
+#include "ftcatlas.h"
 
 FT_BEGIN_HEADER
 
@@ -61,6 +62,20 @@ FT_BEGIN_HEADER
                      FT_Bool*    list_changed );
 
 
+  FT_LOCAL( void )
+  ftc_anode_free( FTC_Node   anode,
+                  FTC_Cache  cache );
+
+  FT_LOCAL( FT_Error )
+  ftc_anode_new( FTC_Node   *panode,
+                 FT_Pointer  gquery,
+                 FTC_Cache   cache );
+
+  FT_LOCAL( FT_Offset )
+  ftc_anode_weight( FTC_Node   anode,
+                    FTC_Cache  cache );
+
+
   FT_LOCAL( FT_Bool )
   ftc_gnode_compare( FTC_Node    gnode,
                      FT_Pointer  gquery,
@@ -75,6 +90,14 @@ FT_BEGIN_HEADER
   ftc_gcache_done( FTC_Cache  cache );
 
 
+  /* the caller must set the page dimensions after registration */
+  FT_LOCAL( FT_Error )
+  ftc_acache_init( FTC_Cache  cache );
+
+  FT_LOCAL( void )
+  ftc_acache_done( FTC_Cache  cache );
+
+
   FT_LOCAL( FT_Error )
   ftc_cache_init( FTC_Cache  cache );
 
@@ -85,6 +108,9 @@ FT_BEGIN_HEADER
   ftc_node_destroy( FTC_Node     node,
                     FTC_Manager  manager );
 
+  FT_LOCAL( void )
+  ftc_shard_balance( FTC_Shard  shard );
+
 FT_END_HEADER
 
 #endif /* FTCCBACK_H_ */
@@ -35,22 +35,43 @@
    * Each FTC_CMapNode contains a simple array to map a range of character
    * codes to equivalent glyph indices.
    *
-   * For now, the implementation is very basic: Each node maps a range of
-   * 128 consecutive character codes to their corresponding glyph indices.
+   * The size of the range depends on the character codes: Below U+3000,
+   * where scripts are small, a node maps 128 consecutive character codes.
+   * Above, where CJK text touches many code points of large blocks, a node
+   * maps 1024 codes.
    *
-   * We could do more complex things, but I don't think it is really very
-   * useful.
+   * Glyph indices are filled in on demand.  The first miss in a node maps
+   * a single character code; a further miss shows that the text really
+   * uses the range, and the rest of the node gets mapped with one call to
+   * `FT_Get_Char_Indices'.
    *
    */
 
 
-  /* number of glyph indices / character code per node */
-#define FTC_CMAP_INDICES_MAX  128
+  /* log2 of the number of glyph indices / character codes per node */
+#define FTC_CMAP_SHIFT_SMALL  7
+#define FTC_CMAP_SHIFT_LARGE  10
+
+  /* first character code covered by large nodes */
+#define FTC_CMAP_LARGE_START  0x3000UL
+
+#define FTC_CMAP_SHIFT( charcode )                 \
+          ( (charcode) < FTC_CMAP_LARGE_START      \
+              ? FTC_CMAP_SHIFT_SMALL               \
+              : FTC_CMAP_SHIFT_LARGE               )
+
+  /* first character code of the node holding `charcode' */
+#define FTC_CMAP_FIRST( charcode )                        \
+          ( ( (charcode) >> FTC_CMAP_SHIFT( charcode ) ) << \
+            FTC_CMAP_SHIFT( charcode )                    )
 
   /* compute a query/node hash */
-#define FTC_CMAP_HASH( faceid, index, charcode )         \
-          ( FTC_FACE_ID_HASH( faceid ) + 211 * (index) + \
-            ( (charcode) / FTC_CMAP_INDICES_MAX )      )
+#define FTC_CMAP_HASH( faceid, index, charcode )                       \
+          ( FTC_FACE_ID_HASH( faceid ) + 211 * (index) +               \
+            ( FTC_CMAP_FIRST( charcode ) >> FTC_CMAP_SHIFT_SMALL )     )
+
+  /* number of misses in a node before all of it gets mapped */
+#define FTC_CMAP_BULK_MISSES  2
 
   /* the charmap query */
   typedef struct  FTC_CMapQueryRec_
@@ -69,8 +90,10 @@
     FTC_NodeRec  node;
     FTC_FaceID   face_id;
     FT_UInt      cmap_index;
-    FT_UInt32    first;                         /* first character in node */
-    FT_UInt16    indices[FTC_CMAP_INDICES_MAX]; /* array of glyph indices  */
+    FT_UInt32    first;    /* first character in node  */
+    FT_UInt      count;    /* number of characters     */
+    FT_UInt      misses;   /* number of on-demand fills */
+    FT_UInt16*   indices;  /* array of glyph indices   */
 
   } FTC_CMapNodeRec, *FTC_CMapNode;
 
@@ -113,17 +136,21 @@
     FT_Error       error;
     FT_Memory      memory = cache->memory;
     FTC_CMapNode   node   = NULL;
+    FT_UInt        count  = 1U << FTC_CMAP_SHIFT( query->char_code );
     FT_UInt        nn;
 
 
-    if ( !FT_QNEW( node ) )
+    /* the index array follows the node in the same block */
+    if ( !FT_QALLOC( node, sizeof ( *node ) + count * sizeof ( FT_UInt16 ) ) )
     {
       node->face_id    = query->face_id;
       node->cmap_index = query->cmap_index;
-      node->first      = (query->char_code / FTC_CMAP_INDICES_MAX) *
-                         FTC_CMAP_INDICES_MAX;
+      node->first      = FTC_CMAP_FIRST( query->char_code );
+      node->count      = count;
+      node->misses     = 0;
+      node->indices    = (FT_UInt16*)( node + 1 );
 
-      for ( nn = 0; nn < FTC_CMAP_INDICES_MAX; nn++ )
+      for ( nn = 0; nn < count; nn++ )
         node->indices[nn] = FTC_CMAP_UNKNOWN;
     }
 
@@ -137,10 +164,12 @@
   ftc_cmap_node_weight( FTC_Node   cnode,
                         FTC_Cache  cache )
   {
-    FT_UNUSED( cnode );
+    FTC_CMapNode  node = (FTC_CMapNode)cnode;
+
     FT_UNUSED( cache );
 
-    return sizeof ( *cnode );
+
+    return sizeof ( *node ) + node->count * sizeof ( FT_UInt16 );
   }
 
 
@@ -164,13 +193,38 @@
       FT_UInt32  offset = (FT_UInt32)( query->char_code - node->first );
 
 
-      return FT_BOOL( offset < FTC_CMAP_INDICES_MAX );
+      return FT_BOOL( offset < node->count );
     }
 
     return 0;
   }
 
 
+  /* used by FTC_Cache_Probe; glyph indices not known yet */
+  /* need the manager lock                                */
+  FT_CALLBACK_DEF( FT_Bool )
+  ftc_cmap_node_probe( FTC_Node    ftcnode,
+                       FT_Pointer  ftcquery,
+                       FTC_Cache   cache,
+                       FT_Bool*    list_changed )
+  {
+    FTC_CMapNode   node  = (FTC_CMapNode)ftcnode;
+    FTC_CMapQuery  query = (FTC_CMapQuery)ftcquery;
+    FT_UInt32      offset;
+
+    FT_UNUSED( cache );
+    FT_UNUSED( list_changed );
+
+
+    offset = (FT_UInt32)( query->char_code - node->first );
+
+    return FT_BOOL( node->face_id    == query->face_id    &&
+                    node->cmap_index == query->cmap_index &&
+                    offset < node->count                  &&
+                    node->indices[offset] != FTC_CMAP_UNKNOWN );
+  }
+
+
   FT_CALLBACK_DEF( FT_Bool )
   ftc_cmap_node_remove_faceid( FTC_Node    ftcnode,
                                FT_Pointer  ftcface_id,
@@ -224,21 +278,83 @@
   }
 
 
-  /* documentation is in ftcache.h */
+  /* Map the glyph index at `offset' of `node', or all of the node if it */
+  /* has seen enough misses.                                             */
+  static FT_Error
+  ftc_cmap_node_fill( FTC_Cache     cache,
+                      FTC_CMapNode  node,
+                      FT_UInt       offset,
+                      FT_Bool       no_cmap_change )
+  {
+    FT_Face     face;
+    FT_CharMap  old, cmap;
+    FT_Error    error;
 
-  FT_EXPORT_DEF( FT_UInt )
-  FTC_CMapCache_Lookup( FTC_CMapCache  cmap_cache,
-                        FTC_FaceID     face_id,
-                        FT_Int         cmap_index,
-                        FT_UInt32      char_code )
+
+    error = ftc_manager_lookup_face( cache->manager, node->face_id, &face );
+    if ( error )
+      return error;
+
+    node->indices[offset] = 0;
+
+    if ( node->cmap_index >= (FT_UInt)face->num_charmaps )
+      return FT_Err_Ok;
+
+    old  = face->charmap;
+    cmap = face->charmaps[node->cmap_index];
+
+    if ( old != cmap && !no_cmap_change )
+      FT_Set_Charmap( face, cmap );
+
+    if ( ++node->misses < FTC_CMAP_BULK_MISSES )
+      node->indices[offset] =
+        (FT_UInt16)FT_Get_Char_Index( face, node->first + offset );
+    else
+    {
+      FT_UInt32  codes[128];
+      FT_UInt    gindices[128];
+      FT_UInt    nn, mm;
+
+
+      for ( nn = 0; nn < node->count; nn += 128 )
+      {
+        for ( mm = 0; mm < 128; mm++ )
+          codes[mm] = node->first + nn + mm;
+
+        (void)FT_Get_Char_Indices( face, codes, 128, gindices );
+
+        for ( mm = 0; mm < 128; mm++ )
+          node->indices[nn + mm] = (FT_UInt16)gindices[mm];
+      }
+    }
+
+    if ( old != cmap && !no_cmap_change )
+      FT_Set_Charmap( face, old );
+
+    return FT_Err_Ok;
+  }
+
+
+  /* Map `char_codes[0]' and all following codes that fall into the */
+  /* same node, with a single node lookup.  Return the number of     */
+  /* codes mapped (at least one).                                    */
+  static FT_UInt
+  ftc_cmap_lookup_run( FTC_Cache         cache,
+                       FTC_FaceID        face_id,
+                       FT_Int            cmap_index,
+                       const FT_UInt32*  char_codes,
+                       FT_UInt           count,
+                       FT_UInt*          gindices,
+                       FT_Error         *aerror )
   {
-    FTC_Cache         cache = FTC_CACHE( cmap_cache );
     FTC_CMapQueryRec  query;
     FTC_Node          node;
-    FT_Error          error;
-    FT_UInt           gindex = 0;
+    FTC_Node          probed = NULL;
+    FTC_CMapNode      cnode;
+    FT_Error          error  = FT_Err_Ok;
     FT_Offset         hash;
-    FT_Int            no_cmap_change = 0;
+    FT_Bool           no_cmap_change = 0;
+    FT_UInt           nn = 0;
 
 
     if ( cmap_index < 0 )
@@ -252,17 +368,38 @@
       cmap_index     = 0;
     }
 
-    if ( !cache )
-    {
-      FT_TRACE0(( "FTC_CMapCache_Lookup: bad arguments, returning 0\n" ));
-      return 0;
-    }
+    gindices[0] = 0;
 
     query.face_id    = face_id;
     query.cmap_index = (FT_UInt)cmap_index;
-    query.char_code  = char_code;
+    query.char_code  = char_codes[0];
+
+    hash = FTC_CMAP_HASH( face_id, (FT_UInt)cmap_index, char_codes[0] );
+
+    if ( cache->manager->lock )
+    {
+      node = probed = FTC_Cache_Probe( cache, hash,
+                                       ftc_cmap_node_probe, &query );
+      if ( probed )
+      {
+        /* only the shard is held; stop at the first unknown entry */
+        cnode = FTC_CMAP_NODE( node );
+
+        for ( ; nn < count; nn++ )
+        {
+          FT_UInt32  offset = char_codes[nn] - cnode->first;
 
-    hash = FTC_CMAP_HASH( face_id, (FT_UInt)cmap_index, char_code );
+
+          if ( offset >= cnode->count                      ||
+               cnode->indices[offset] == FTC_CMAP_UNKNOWN  )
+            break;
+
+          gindices[nn] = cnode->indices[offset];
+        }
+
+        goto Exit;
+      }
+    }
 
 #if 1
     FTC_CACHE_LOOKUP_CMP( cache, ftc_cmap_node_compare, hash, &query,
@@ -273,53 +410,101 @@
     if ( error )
       goto Exit;
 
-    FT_ASSERT( char_code - FTC_CMAP_NODE( node )->first <
-               FTC_CMAP_INDICES_MAX );
+    cnode = FTC_CMAP_NODE( node );
+
+    FT_ASSERT( char_codes[0] - cnode->first < cnode->count );
 
     /* something rotten can happen with rogue clients */
-    if ( char_code - FTC_CMAP_NODE( node )->first >= FTC_CMAP_INDICES_MAX )
-      return 0; /* XXX: should return appropriate error */
+    if ( char_codes[0] - cnode->first >= cnode->count )
+      goto Exit; /* XXX: should return appropriate error */
 
-    gindex = FTC_CMAP_NODE( node )->indices[char_code -
-                                            FTC_CMAP_NODE( node )->first];
-    if ( gindex == FTC_CMAP_UNKNOWN )
+    for ( ; nn < count; nn++ )
     {
-      FT_Face  face;
-
+      FT_UInt32  offset = char_codes[nn] - cnode->first;
 
-      gindex = 0;
 
-      error = FTC_Manager_LookupFace( cache->manager,
-                                      FTC_CMAP_NODE( node )->face_id,
-                                      &face );
-      if ( error )
-        goto Exit;
+      if ( offset >= cnode->count )
+        break;
 
-      if ( (FT_UInt)cmap_index < (FT_UInt)face->num_charmaps )
+      if ( cnode->indices[offset] == FTC_CMAP_UNKNOWN )
       {
-        FT_CharMap  old, cmap  = NULL;
+        error = ftc_cmap_node_fill( cache, cnode, offset, no_cmap_change );
+        if ( error )
+          goto Exit;
+      }
 
+      gindices[nn] = cnode->indices[offset];
+    }
 
-        old  = face->charmap;
-        cmap = face->charmaps[cmap_index];
+  Exit:
+    if ( cache->manager->lock )
+      FTC_Cache_Release( cache, hash, probed );
 
-        if ( old != cmap && !no_cmap_change )
-          FT_Set_Charmap( face, cmap );
+    *aerror = error;
 
-        gindex = FT_Get_Char_Index( face, char_code );
+    return nn > 0 ? nn : 1;
+  }
 
-        if ( old != cmap && !no_cmap_change )
-          FT_Set_Charmap( face, old );
-      }
 
-      FTC_CMAP_NODE( node )->indices[char_code -
-                                     FTC_CMAP_NODE( node )->first]
-        = (FT_UShort)gindex;
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_UInt )
+  FTC_CMapCache_Lookup( FTC_CMapCache  cmap_cache,
+                        FTC_FaceID     face_id,
+                        FT_Int         cmap_index,
+                        FT_UInt32      char_code )
+  {
+    FTC_Cache  cache = FTC_CACHE( cmap_cache );
+    FT_UInt    gindex;
+    FT_Error   error;
+
+
+    if ( !cache )
+    {
+      FT_TRACE0(( "FTC_CMapCache_Lookup: bad arguments, returning 0\n" ));
+      return 0;
     }
 
-  Exit:
+    (void)ftc_cmap_lookup_run( cache, face_id, cmap_index,
+                               &char_code, 1, &gindex, &error );
+
     return gindex;
   }
 
 
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_CMapCache_LookupMany( FTC_CMapCache     cmap_cache,
+                            FTC_FaceID        face_id,
+                            FT_Int            cmap_index,
+                            const FT_UInt32*  char_codes,
+                            FT_UInt           count,
+                            FT_UInt*          gindices )
+  {
+    FTC_Cache  cache = FTC_CACHE( cmap_cache );
+    FT_Error   error = FT_Err_Ok;
+    FT_UInt    nn    = 0;
+
+
+    if ( !cache || ( count && ( !char_codes || !gindices ) ) )
+      return FT_THROW( Invalid_Argument );
+
+    while ( nn < count )
+    {
+      nn += ftc_cmap_lookup_run( cache, face_id, cmap_index,
+                                 char_codes + nn, count - nn,
+                                 gindices + nn, &error );
+      if ( error )
+        break;
+    }
+
+    /* clear the rest in case of error */
+    for ( ; nn < count; nn++ )
+      gindices[nn] = 0;
+
+    return error;
+  }
+
+
 /* END */
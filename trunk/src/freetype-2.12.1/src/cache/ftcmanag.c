@@ -40,7 +40,7 @@
     FT_Error  error;
 
 
-    error = FTC_Manager_LookupFace( manager, scaler->face_id, &face );
+    error = ftc_manager_lookup_face( manager, scaler->face_id, &face );
     if ( error )
       goto Exit;
 
@@ -172,6 +172,31 @@
   }
 
 
+  FT_LOCAL_DEF( FT_Error )
+  ftc_manager_lookup_size( FTC_Manager  manager,
+                           FTC_Scaler   scaler,
+                           FT_Size     *asize )
+  {
+    FT_Error     error;
+    FTC_MruNode  mrunode;
+
+
+#ifdef FTC_INLINE
+
+    FTC_MRULIST_LOOKUP_CMP( &manager->sizes, scaler, ftc_size_node_compare,
+                            mrunode, error );
+
+#else
+    error = FTC_MruList_Lookup( &manager->sizes, scaler, &mrunode );
+#endif
+
+    if ( !error )
+      *asize = FTC_SIZE_NODE( mrunode )->size;
+
+    return error;
+  }
+
+
   /* documentation is in ftcache.h */
 
   FT_EXPORT_DEF( FT_Error )
@@ -179,8 +204,7 @@
                           FTC_Scaler   scaler,
                           FT_Size     *asize )
   {
-    FT_Error     error;
-    FTC_MruNode  mrunode;
+    FT_Error  error;
 
 
     if ( !asize || !scaler )
@@ -191,17 +215,9 @@
     if ( !manager )
       return FT_THROW( Invalid_Cache_Handle );
 
-#ifdef FTC_INLINE
-
-    FTC_MRULIST_LOOKUP_CMP( &manager->sizes, scaler, ftc_size_node_compare,
-                            mrunode, error );
-
-#else
-    error = FTC_MruList_Lookup( &manager->sizes, scaler, &mrunode );
-#endif
-
-    if ( !error )
-      *asize = FTC_SIZE_NODE( mrunode )->size;
+    FTC_MANAGER_LOCK( manager );
+    error = ftc_manager_lookup_size( manager, scaler, asize );
+    FTC_MANAGER_UNLOCK( manager );
 
     return error;
   }
@@ -299,25 +315,15 @@
   };
 
 
-  /* documentation is in ftcache.h */
-
-  FT_EXPORT_DEF( FT_Error )
-  FTC_Manager_LookupFace( FTC_Manager  manager,
-                          FTC_FaceID   face_id,
-                          FT_Face     *aface )
+  FT_LOCAL_DEF( FT_Error )
+  ftc_manager_lookup_face( FTC_Manager  manager,
+                           FTC_FaceID   face_id,
+                           FT_Face     *aface )
   {
     FT_Error     error;
     FTC_MruNode  mrunode;
 
 
-    if ( !aface )
-      return FT_THROW( Invalid_Argument );
-
-    *aface = NULL;
-
-    if ( !manager )
-      return FT_THROW( Invalid_Cache_Handle );
-
     /* we break encapsulation for the sake of speed */
 #ifdef FTC_INLINE
 
@@ -335,6 +341,32 @@
   }
 
 
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_LookupFace( FTC_Manager  manager,
+                          FTC_FaceID   face_id,
+                          FT_Face     *aface )
+  {
+    FT_Error  error;
+
+
+    if ( !aface )
+      return FT_THROW( Invalid_Argument );
+
+    *aface = NULL;
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    FTC_MANAGER_LOCK( manager );
+    error = ftc_manager_lookup_face( manager, face_id, aface );
+    FTC_MANAGER_UNLOCK( manager );
+
+    return error;
+  }
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*****                                                               *****/
@@ -368,7 +400,7 @@
 
     memory = library->memory;
 
-    if ( FT_QNEW( manager ) )
+    if ( FT_NEW( manager ) )
       goto Exit;
 
     if ( max_faces == 0 )
@@ -399,9 +431,10 @@
                       manager,
                       memory );
 
-    manager->nodes_list = NULL;
+    manager->num_shards = 1;
     manager->num_nodes  = 0;
     manager->num_caches = 0;
+    manager->policy     = FTC_EVICTION_POLICY_LRU;
 
     *amanager = manager;
 
@@ -410,6 +443,276 @@
   }
 
 
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_SetLockFuncs( FTC_Manager              manager,
+                            const FTC_LockFuncsRec*  funcs,
+                            FT_UInt                  num_shards )
+  {
+    FT_Error  error = FT_Err_Ok;
+    FT_UInt   nn;
+
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    if ( !funcs                                       ||
+         !funcs->lock_new || !funcs->lock_done        ||
+         !funcs->lock_acquire || !funcs->lock_release )
+      return FT_THROW( Invalid_Argument );
+
+    if ( num_shards == 0 )
+      num_shards = FTC_SHARDS_DEFAULT;
+
+    /* the hash tables of caches are allocated per shard */
+    if ( num_shards > FTC_MAX_SHARDS || manager->num_caches > 0 ||
+         manager->lock                                          )
+      return FT_THROW( Invalid_Argument );
+
+    error = funcs->lock_new( funcs->lock_data, &manager->lock );
+    if ( error )
+      goto Fail;
+
+    for ( nn = 0; nn < num_shards; nn++ )
+    {
+      error = funcs->lock_new( funcs->lock_data,
+                               &manager->shards[nn].lock );
+      if ( error )
+        goto Fail;
+    }
+
+    manager->lock_funcs = funcs[0];
+    manager->num_shards = num_shards;
+
+    return FT_Err_Ok;
+
+  Fail:
+    if ( manager->lock )
+      funcs->lock_done( funcs->lock_data, manager->lock );
+    manager->lock = NULL;
+
+    for ( nn = 0; nn < num_shards; nn++ )
+    {
+      if ( manager->shards[nn].lock )
+        funcs->lock_done( funcs->lock_data, manager->shards[nn].lock );
+      manager->shards[nn].lock = NULL;
+    }
+
+    return error;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_SetGlyphStore( FTC_Manager            manager,
+                             const FT_Byte*         base,
+                             FT_ULong               size,
+                             FTC_Store_FontKeyFunc  key_func,
+                             FT_Pointer             key_data )
+  {
+    FT_Error  error;
+
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    if ( !key_func || ( !base && size ) || manager->store )
+      return FT_THROW( Invalid_Argument );
+
+    FTC_MANAGER_LOCK( manager );
+
+    error = ftc_store_new( manager->memory, base, size,
+                           key_func, key_data, &manager->store );
+
+    FTC_MANAGER_UNLOCK( manager );
+
+    return error;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_SaveGlyphStore( FTC_Manager          manager,
+                              FTC_Store_WriteFunc  write_func,
+                              FT_Pointer           write_data )
+  {
+    FT_Error  error;
+
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    if ( !write_func || !manager->store )
+      return FT_THROW( Invalid_Argument );
+
+    FTC_MANAGER_LOCK( manager );
+
+    error = ftc_store_save( manager->store, write_func, write_data );
+
+    FTC_MANAGER_UNLOCK( manager );
+
+    return error;
+  }
+
+
+  static void
+  ftc_mru_list_get_stats( FTC_MruList        list,
+                          FTC_ListStatsRec*  stats )
+  {
+    stats->num_nodes = list->num_nodes;
+    stats->max_nodes = list->max_nodes;
+    stats->hits      = list->num_hits;
+    stats->misses    = list->num_misses;
+    stats->evictions = list->num_evictions;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_GetStats( FTC_Manager       manager,
+                        FTC_ManagerStats  astats,
+                        FTC_CacheStats    acaches,
+                        FT_UInt           max_caches )
+  {
+    FT_UInt  nn, idx;
+
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    if ( !astats || ( max_caches && !acaches ) )
+      return FT_THROW( Invalid_Argument );
+
+    FTC_MANAGER_LOCK( manager );
+
+    astats->max_bytes  = manager->max_weight;
+    astats->cur_bytes  = manager->cur_weight;
+    astats->num_nodes  = manager->num_nodes;
+    astats->num_caches = manager->num_caches;
+
+    ftc_mru_list_get_stats( &manager->faces, &astats->faces );
+    ftc_mru_list_get_stats( &manager->sizes, &astats->sizes );
+
+    if ( max_caches > manager->num_caches )
+      max_caches = manager->num_caches;
+
+    if ( max_caches )
+      FT_ARRAY_ZERO( acaches, max_caches );
+
+    for ( nn = 0; nn < manager->num_shards; nn++ )
+    {
+      FTC_Shard  shard = manager->shards + nn;
+      FTC_Node   first, node;
+      FT_UInt    list;
+
+
+      FTC_MANAGER_LOCK_SHARD( manager, shard );
+
+      for ( idx = 0; idx < max_caches; idx++ )
+      {
+        FTC_Hash        table = manager->caches[idx]->hashes + nn;
+        FTC_CacheStats  stats = acaches + idx;
+
+
+        stats->hits        += table->num_hits;
+        stats->misses      += table->num_misses;
+        stats->evictions   += table->num_evictions;
+        stats->num_buckets += table->p + table->mask + 1;
+      }
+
+      for ( list = 0; list < FTC_LIST_MAX; list++ )
+      {
+        first = shard->lists[list];
+        if ( !first )
+          continue;
+
+        node = first;
+
+        do
+        {
+          idx = node->cache_index;
+          if ( idx < max_caches )
+          {
+            FTC_Cache  cache = manager->caches[idx];
+
+
+            acaches[idx].num_nodes++;
+            acaches[idx].num_bytes += cache->clazz.node_weight( node,
+                                                                cache );
+          }
+
+          node = FTC_NODE_NEXT( node );
+
+        } while ( node != first );
+      }
+
+      FTC_MANAGER_UNLOCK_SHARD( manager, shard );
+    }
+
+    FTC_MANAGER_UNLOCK( manager );
+
+    return FT_Err_Ok;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_SetEvictionPolicy( FTC_Manager         manager,
+                                 FTC_EvictionPolicy  policy )
+  {
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    /* lookups read the policy without the manager lock */
+    if ( ( policy != FTC_EVICTION_POLICY_LRU &&
+           policy != FTC_EVICTION_POLICY_2Q  ) ||
+         manager->num_caches > 0               )
+      return FT_THROW( Invalid_Argument );
+
+    manager->policy = policy;
+
+    return FT_Err_Ok;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_EXPORT_DEF( FT_Error )
+  FTC_Manager_SetCacheMaxBytes( FTC_Manager  manager,
+                                FT_UInt      cache_index,
+                                FT_ULong     max_bytes )
+  {
+    FT_Error  error = FT_Err_Ok;
+
+
+    if ( !manager )
+      return FT_THROW( Invalid_Cache_Handle );
+
+    FTC_MANAGER_LOCK( manager );
+
+    if ( cache_index >= manager->num_caches )
+    {
+      error = FT_THROW( Invalid_Argument );
+      goto Exit;
+    }
+
+    manager->caches[cache_index]->max_weight = max_bytes;
+
+    if ( FTC_CACHE_OVER_LIMIT( manager->caches[cache_index] ) )
+      FTC_Manager_Compress( manager );
+
+  Exit:
+    FTC_MANAGER_UNLOCK( manager );
+
+    return error;
+  }
+
+
   /* documentation is in ftcache.h */
 
   FT_EXPORT_DEF( void )
@@ -443,6 +746,22 @@
     FTC_MruList_Done( &manager->sizes );
     FTC_MruList_Done( &manager->faces );
 
+    /* the caches might have used the store's bitmaps */
+    ftc_store_done( manager->store );
+    manager->store = NULL;
+
+    if ( manager->lock )
+    {
+      FTC_LockFuncsRec*  funcs = &manager->lock_funcs;
+
+
+      for ( idx = 0; idx < manager->num_shards; idx++ )
+        funcs->lock_done( funcs->lock_data, manager->shards[idx].lock );
+
+      funcs->lock_done( funcs->lock_data, manager->lock );
+      manager->lock = NULL;
+    }
+
     manager->library = NULL;
     manager->memory  = NULL;
 
@@ -458,10 +777,14 @@
     if ( !manager )
       return;
 
+    FTC_MANAGER_LOCK( manager );
+
     FTC_MruList_Reset( &manager->sizes );
     FTC_MruList_Reset( &manager->faces );
 
     FTC_Manager_FlushN( manager, manager->num_nodes );
+
+    FTC_MANAGER_UNLOCK( manager );
   }
 
 
@@ -470,61 +793,183 @@
   static void
   FTC_Manager_Check( FTC_Manager  manager )
   {
-    FTC_Node  node, first;
-
+    FTC_Node   node, first;
+    FT_Offset  weight = 0;
+    FT_UFast   count  = 0;
+    FT_UInt    nn;
 
-    first = manager->nodes_list;
 
-    /* check node weights */
-    if ( first )
+    for ( nn = 0; nn < manager->num_shards; nn++ )
     {
-      FT_Offset  weight = 0;
+      FTC_Shard  shard = manager->shards + nn;
+      FT_UInt    list;
 
 
-      node = first;
+      FTC_MANAGER_LOCK_SHARD( manager, shard );
 
-      do
+      for ( list = 0; list < FTC_LIST_MAX; list++ )
       {
-        FTC_Cache  cache = manager->caches[node->cache_index];
+        FT_UInt  list_count = 0;
 
 
-        if ( (FT_UInt)node->cache_index >= manager->num_caches )
-          FT_TRACE0(( "FTC_Manager_Check: invalid node (cache index = %ld\n",
-                      node->cache_index ));
-        else
-          weight += cache->clazz.node_weight( node, cache );
+        first = shard->lists[list];
 
-        node = FTC_NODE_NEXT( node );
+        /* check node weights */
+        if ( !first )
+          continue;
 
-      } while ( node != first );
+        node = first;
 
-      if ( weight != manager->cur_weight )
-        FT_TRACE0(( "FTC_Manager_Check: invalid weight %ld instead of %ld\n",
-                    manager->cur_weight, weight ));
+        do
+        {
+          FTC_Cache  cache = manager->caches[node->cache_index];
+
+
+          if ( (FT_UInt)node->cache_index >= manager->num_caches )
+            FT_TRACE0(( "FTC_Manager_Check:"
+                        " invalid node (cache index = %ld\n",
+                        node->cache_index ));
+          else
+            weight += cache->clazz.node_weight( node, cache );
+
+          if ( FTC_SHARD_INDEX( manager, node->hash ) != nn )
+            FT_TRACE0(( "FTC_Manager_Check: node in wrong shard %d\n",
+                        nn ));
+
+          if ( node->list_index != list )
+            FT_TRACE0(( "FTC_Manager_Check: node in wrong list %d\n",
+                        list ));
+
+          list_count++;
+          node = FTC_NODE_NEXT( node );
+
+        } while ( node != first );
+
+        if ( list_count != shard->num_list_nodes[list] )
+          FT_TRACE0(( "FTC_Manager_Check:"
+                      " invalid list node count %d instead of %d\n",
+                      shard->num_list_nodes[list], list_count ));
+
+        count += list_count;
+      }
+
+      FTC_MANAGER_UNLOCK_SHARD( manager, shard );
     }
 
-    /* check circular list */
-    if ( first )
-    {
-      FT_UFast  count = 0;
+    if ( weight != manager->cur_weight )
+      FT_TRACE0(( "FTC_Manager_Check: invalid weight %ld instead of %ld\n",
+                  manager->cur_weight, weight ));
+
+    /* check circular lists */
+    if ( count != manager->num_nodes )
+      FT_TRACE0(( "FTC_Manager_Check:"
+                  " invalid cache node count %d instead of %d\n",
+                  manager->num_nodes, count ));
+  }
+
+#endif /* FT_DEBUG_ERROR */
+
+
+  /* true if `cache' (or the whole manager if NULL) is within its limit */
+#define FTC_WITHIN_LIMIT( manager, cache )                     \
+          ( (cache) ? !FTC_CACHE_OVER_LIMIT( cache )           \
+                    : (manager)->cur_weight <= (manager)->max_weight )
+
+
+  /* Destroy unreferenced nodes from the least recently used end of a */
+  /* shard, probation list first, until `count' nodes are gone or, if */
+  /* `compress' is set, the weight is within its limit.  If `cache'   */
+  /* is not NULL, only destroy its nodes and check its own limit.     */
+  /* Return the number of destroyed nodes.                            */
+  static FT_UInt
+  ftc_shard_flush( FTC_Manager  manager,
+                   FTC_Shard    shard,
+                   FT_UInt      count,
+                   FT_Bool      compress,
+                   FTC_Cache    cache )
+  {
+    FTC_Node  first, node;
+    FT_UInt   result = 0;
+    FT_UInt   list;
 
 
-      node = first;
-      do
+    FTC_MANAGER_LOCK_SHARD( manager, shard );
+
+    if ( manager->policy == FTC_EVICTION_POLICY_2Q )
+      ftc_shard_balance( shard );
+
+    for ( list = FTC_LIST_MAX; list-- > 0 && result < count; )
+    {
+      first = shard->lists[list];
+      if ( !first )  /* empty list! */
+        continue;
+
+      /* go to last node -- it's a circular list */
+      node = FTC_NODE_PREV( first );
+      while ( result < count )
       {
-        count++;
-        node = FTC_NODE_NEXT( node );
+        FTC_Node  prev = ( node == first ) ? NULL : FTC_NODE_PREV( node );
+
 
-      } while ( node != first );
+        /* don't touch locked nodes */
+        if ( node->ref_count <= 0                                   &&
+             ( !cache || node->cache_index == (FT_UInt)cache->index ) )
+        {
+          ftc_node_destroy( node, manager );
+          result++;
+
+          if ( compress && FTC_WITHIN_LIMIT( manager, cache ) )
+            goto Exit;
+        }
 
-      if ( count != manager->num_nodes )
-        FT_TRACE0(( "FTC_Manager_Check:"
-                    " invalid cache node count %d instead of %d\n",
-                    manager->num_nodes, count ));
+        if ( !prev )
+          break;
+
+        node = prev;
+      }
     }
+
+  Exit:
+    FTC_MANAGER_UNLOCK_SHARD( manager, shard );
+
+    return result;
   }
 
-#endif /* FT_DEBUG_ERROR */
+
+  /* Flush nodes from all shards in turn; a single shard is flushed at */
+  /* once.  The manager lock must be held.                             */
+  static FT_UInt
+  ftc_manager_flush( FTC_Manager  manager,
+                     FT_UInt      count,
+                     FT_Bool      compress,
+                     FTC_Cache    cache )
+  {
+    FT_UInt  step   = manager->num_shards == 1 ? count : 1;
+    FT_UInt  idle   = 0;
+    FT_UInt  result = 0;
+
+
+    while ( result < count && idle < manager->num_shards )
+    {
+      FTC_Shard  shard = manager->shards + manager->next_shard;
+      FT_UInt    done;
+
+
+      if ( ++manager->next_shard >= manager->num_shards )
+        manager->next_shard = 0;
+
+      done    = ftc_shard_flush( manager, shard,
+                                 FT_MIN( step, count - result ),
+                                 compress, cache );
+      result += done;
+      idle    = done ? 0 : idle + 1;
+
+      if ( compress && FTC_WITHIN_LIMIT( manager, cache ) )
+        break;
+    }
+
+    return result;
+  }
 
 
   /* `Compress' the manager's data, i.e., get rid of old cache nodes */
@@ -536,14 +981,12 @@
   FT_LOCAL_DEF( void )
   FTC_Manager_Compress( FTC_Manager  manager )
   {
-    FTC_Node   node, first;
+    FT_UInt  idx;
 
 
     if ( !manager )
       return;
 
-    first = manager->nodes_list;
-
 #ifdef FT_DEBUG_ERROR
     FTC_Manager_Check( manager );
 
@@ -552,24 +995,20 @@
                 manager->num_nodes ));
 #endif
 
-    if ( manager->cur_weight < manager->max_weight || !first )
-      return;
-
-    /* go to last node -- it's a circular list */
-    node = FTC_NODE_PREV( first );
-    do
+    /* caches over their own limit go first */
+    for ( idx = 0; idx < manager->num_caches; idx++ )
     {
-      FTC_Node  prev;
-
+      FTC_Cache  cache = manager->caches[idx];
 
-      prev = ( node == first ) ? NULL : FTC_NODE_PREV( node );
 
-      if ( node->ref_count <= 0 )
-        ftc_node_destroy( node, manager );
+      if ( FTC_CACHE_OVER_LIMIT( cache ) )
+        ftc_manager_flush( manager, manager->num_nodes, TRUE, cache );
+    }
 
-      node = prev;
+    if ( manager->cur_weight < manager->max_weight || !manager->num_nodes )
+      return;
 
-    } while ( node && manager->cur_weight > manager->max_weight );
+    ftc_manager_flush( manager, manager->num_nodes, TRUE, NULL );
   }
 
 
@@ -589,12 +1028,14 @@
       FT_Memory  memory = manager->memory;
 
 
+      FTC_MANAGER_LOCK( manager );
+
       if ( manager->num_caches >= FTC_MAX_CACHES )
       {
         error = FT_THROW( Too_Many_Caches );
         FT_ERROR(( "FTC_Manager_RegisterCache:"
                    " too many registered caches\n" ));
-        goto Exit;
+        goto Unlock;
       }
 
       if ( !FT_QALLOC( cache, clazz->cache_size ) )
@@ -604,6 +1045,9 @@
         cache->clazz     = clazz[0];
         cache->org_class = clazz;
 
+        cache->max_weight = 0;
+        cache->cur_weight = 0;
+
         /* THIS IS VERY IMPORTANT!  IT WILL WRETCH THE MANAGER */
         /* IF IT IS NOT SET CORRECTLY                          */
         cache->index = manager->num_caches;
@@ -613,14 +1057,16 @@
         {
           clazz->cache_done( cache );
           FT_FREE( cache );
-          goto Exit;
+          goto Unlock;
         }
 
         manager->caches[manager->num_caches++] = cache;
       }
+
+    Unlock:
+      FTC_MANAGER_UNLOCK( manager );
     }
 
-  Exit:
     if ( acache )
       *acache = cache;
     return error;
@@ -631,35 +1077,8 @@
   FTC_Manager_FlushN( FTC_Manager  manager,
                       FT_UInt      count )
   {
-    FTC_Node  first = manager->nodes_list;
-    FTC_Node  node;
-    FT_UInt   result;
-
-
-    /* try to remove `count' nodes from the list */
-    if ( !first )  /* empty list! */
-      return 0;
-
-    /* go to last node - it's a circular list */
-    node = FTC_NODE_PREV(first);
-    for ( result = 0; result < count; )
-    {
-      FTC_Node  prev = FTC_NODE_PREV( node );
-
-
-      /* don't touch locked nodes */
-      if ( node->ref_count <= 0 )
-      {
-        ftc_node_destroy( node, manager );
-        result++;
-      }
-
-      if ( node == first )
-        break;
-
-      node = prev;
-    }
-    return  result;
+    /* try to remove `count' nodes from the lists */
+    return ftc_manager_flush( manager, count, FALSE, NULL );
   }
 
 
@@ -675,6 +1094,8 @@
     if ( !manager )
       return;
 
+    FTC_MANAGER_LOCK( manager );
+
     /* this will remove all FTC_SizeNode that correspond to
      * the face_id as well
      */
@@ -684,6 +1105,8 @@
 
     for ( nn = 0; nn < manager->num_caches; nn++ )
       FTC_Cache_RemoveFaceID( manager->caches[nn], face_id );
+
+    FTC_MANAGER_UNLOCK( manager );
   }
 
 
@@ -696,7 +1119,15 @@
     if ( node                                             &&
          manager                                          &&
          (FT_UInt)node->cache_index < manager->num_caches )
+    {
+      FTC_Shard  shard = manager->shards +
+                         FTC_SHARD_INDEX( manager, node->hash );
+
+
+      FTC_SHARD_LOCK( manager, shard );
       node->ref_count--;
+      FTC_SHARD_UNLOCK( manager, shard );
+    }
   }
 
 
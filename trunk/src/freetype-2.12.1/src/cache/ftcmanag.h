@@ -66,6 +66,7 @@
 #include <freetype/ftcache.h>
 #include "ftcmru.h"
 #include "ftccache.h"
+#include "ftcstore.h"
 
 
 FT_BEGIN_HEADER
@@ -86,17 +87,60 @@ FT_BEGIN_HEADER
   /* maximum number of caches registered in a single manager */
 #define FTC_MAX_CACHES         16
 
+  /* maximum and default number of node shards with lock functions */
+#define FTC_MAX_SHARDS         64
+#define FTC_SHARDS_DEFAULT     16
+
+
+  /* the MRU lists of a shard; see FTC_ShardRec */
+#define FTC_LIST_MAIN        0
+#define FTC_LIST_PROBATION   1
+#define FTC_LIST_MAX         2
+
+
+  /*
+   * The nodes of all caches are distributed into shards by their hash
+   * value.  A shard holds the most-recently-used lists of its nodes; each
+   * cache has a separate hash table per shard (see FTC_CacheRec).
+   *
+   * With the LRU eviction policy, all nodes are in the main list.  With
+   * the 2Q policy, new nodes enter the probation list and move to the
+   * main list only when they are used again.  Before nodes are evicted,
+   * the least recently used nodes of the main list are moved back to the
+   * probation list while it holds more than 3/4 of the shard's nodes.
+   * Nodes are always evicted from the probation list first, so that
+   * nodes used only once cannot push out the working set.
+   *
+   * Without lock functions, there is a single shard and no lock at all.
+   * Otherwise, the shard's lock protects its MRU lists, its hash tables,
+   * and the reference counts of its nodes.  The manager lock must be held
+   * to add or remove nodes, to change the weights, or to use the face,
+   * size, and family lists; it is always acquired before a shard lock.
+   */
+  typedef struct  FTC_ShardRec_
+  {
+    FT_Pointer  lock;
+    FTC_Node    lists[FTC_LIST_MAX];
+    FT_UInt     num_list_nodes[FTC_LIST_MAX];
+
+  } FTC_ShardRec, *FTC_Shard;
+
 
   typedef struct  FTC_ManagerRec_
   {
     FT_Library          library;
     FT_Memory           memory;
 
-    FTC_Node            nodes_list;
+    FTC_ShardRec        shards[FTC_MAX_SHARDS];
+    FT_UInt             num_shards;
+    FT_UInt             next_shard;   /* next shard to flush */
+
     FT_Offset           max_weight;
     FT_Offset           cur_weight;
     FT_UInt             num_nodes;
 
+    FTC_EvictionPolicy  policy;
+
     FTC_Cache           caches[FTC_MAX_CACHES];
     FT_UInt             num_caches;
 
@@ -106,9 +150,86 @@ FT_BEGIN_HEADER
     FT_Pointer          request_data;
     FTC_Face_Requester  request_face;
 
+    FT_Pointer          lock;
+    FTC_LockFuncsRec    lock_funcs;
+    FTC_Shard           locked_shard; /* shard held with the manager lock */
+
+    FTC_Store           store;        /* persistent glyph store, or NULL  */
+
   } FTC_ManagerRec;
 
 
+  /* the shard index of a given node hash; it mixes the high bits in */
+  /* since the low bits are used to select the hash table bucket      */
+#define FTC_SHARD_INDEX( manager, hash )                           \
+          ( (manager)->num_shards == 1                             \
+              ? 0                                                  \
+              : (FT_UInt)( (FT_UInt32)( (FT_UInt32)(hash) *        \
+                                        0x9E3779B9UL ) >> 16 ) %   \
+                  (manager)->num_shards )
+
+#define FTC_MANAGER_LOCK( manager )                             \
+  FT_BEGIN_STMNT                                                \
+    if ( (manager)->lock )                                      \
+      (manager)->lock_funcs.lock_acquire( (manager)->lock );    \
+  FT_END_STMNT
+
+#define FTC_MANAGER_UNLOCK( manager )                           \
+  FT_BEGIN_STMNT                                                \
+    if ( (manager)->lock )                                      \
+      (manager)->lock_funcs.lock_release( (manager)->lock );    \
+  FT_END_STMNT
+
+#define FTC_SHARD_LOCK( manager, shard )                      \
+  FT_BEGIN_STMNT                                              \
+    if ( (shard)->lock )                                      \
+      (manager)->lock_funcs.lock_acquire( (shard)->lock );    \
+  FT_END_STMNT
+
+#define FTC_SHARD_UNLOCK( manager, shard )                    \
+  FT_BEGIN_STMNT                                              \
+    if ( (shard)->lock )                                      \
+      (manager)->lock_funcs.lock_release( (shard)->lock );    \
+  FT_END_STMNT
+
+  /* variants used with the manager lock held, skipping the shard */
+  /* that the same thread may already hold                        */
+#define FTC_MANAGER_LOCK_SHARD( manager, shard )                  \
+  FT_BEGIN_STMNT                                                  \
+    if ( (shard)->lock && (shard) != (manager)->locked_shard )    \
+      (manager)->lock_funcs.lock_acquire( (shard)->lock );        \
+  FT_END_STMNT
+
+#define FTC_MANAGER_UNLOCK_SHARD( manager, shard )                \
+  FT_BEGIN_STMNT                                                  \
+    if ( (shard)->lock && (shard) != (manager)->locked_shard )    \
+      (manager)->lock_funcs.lock_release( (shard)->lock );        \
+  FT_END_STMNT
+
+  /* account node weights to both the cache and the manager */
+#define FTC_CACHE_ADD_WEIGHT( cache, weight )                     \
+  FT_BEGIN_STMNT                                                  \
+    FT_Offset  _weight = (weight);                                \
+                                                                  \
+                                                                  \
+    (cache)->cur_weight          += _weight;                      \
+    (cache)->manager->cur_weight += _weight;                      \
+  FT_END_STMNT
+
+#define FTC_CACHE_SUB_WEIGHT( cache, weight )                     \
+  FT_BEGIN_STMNT                                                  \
+    FT_Offset  _weight = (weight);                                \
+                                                                  \
+                                                                  \
+    (cache)->cur_weight          -= _weight;                      \
+    (cache)->manager->cur_weight -= _weight;                      \
+  FT_END_STMNT
+
+#define FTC_CACHE_OVER_LIMIT( cache )                             \
+          ( (cache)->max_weight                           &&      \
+            (cache)->cur_weight > (cache)->max_weight     )
+
+
   /**************************************************************************
    *
    * @Function:
@@ -149,6 +270,19 @@ FT_BEGIN_HEADER
                              FTC_CacheClass   clazz,
                              FTC_Cache       *acache );
 
+
+  /* variants of FTC_Manager_LookupFace and FTC_Manager_LookupSize */
+  /* used by caches, which already hold the manager lock           */
+  FT_LOCAL( FT_Error )
+  ftc_manager_lookup_face( FTC_Manager  manager,
+                           FTC_FaceID   face_id,
+                           FT_Face     *aface );
+
+  FT_LOCAL( FT_Error )
+  ftc_manager_lookup_size( FTC_Manager  manager,
+                           FTC_Scaler   scaler,
+                           FT_Size     *asize );
+
  /* */
 
 #define FTC_SCALER_COMPARE( a, b )                \
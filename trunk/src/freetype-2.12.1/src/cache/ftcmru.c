@@ -177,6 +177,10 @@
     list->clazz     = *clazz;
     list->data      = data;
     list->memory    = memory;
+
+    list->num_hits      = 0;
+    list->num_misses    = 0;
+    list->num_evictions = 0;
   }
 
 
@@ -219,6 +223,7 @@
           if ( node != first )
             FTC_MruNode_Up( &list->nodes, node );
 
+          list->num_hits++;
           return node;
         }
 
@@ -241,12 +246,16 @@
     FT_Memory    memory = list->memory;
 
 
+    list->num_misses++;
+
     if ( list->num_nodes >= list->max_nodes && list->max_nodes > 0 )
     {
       node = list->nodes->prev;
 
       FT_ASSERT( node );
 
+      list->num_evictions++;
+
       if ( list->clazz.node_reset )
       {
         FTC_MruNode_Up( &list->nodes, node );
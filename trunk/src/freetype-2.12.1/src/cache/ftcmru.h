@@ -126,6 +126,11 @@ FT_BEGIN_HEADER
     FTC_MruListClassRec  clazz;
     FT_Memory            memory;
 
+    /* for FTC_Manager_GetStats */
+    FT_ULong             num_hits;
+    FT_ULong             num_misses;
+    FT_ULong             num_evictions;
+
   } FTC_MruListRec;
 
 
@@ -182,6 +187,7 @@ FT_BEGIN_HEADER
           if ( _node != _first )                                            \
             FTC_MruNode_Up( _pfirst, _node );                               \
                                                                             \
+          (list)->num_hits++;                                               \
           node = _node;                                                     \
           goto MruOk_;                                                      \
         }                                                                   \
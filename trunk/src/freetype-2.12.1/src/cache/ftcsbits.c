@@ -18,6 +18,7 @@
 
 #include <freetype/ftcache.h>
 #include "ftcsbits.h"
+#include "ftcmanag.h"
 #include <freetype/internal/ftobjs.h>
 #include <freetype/internal/ftdebug.h>
 #include <freetype/fterrors.h>
@@ -68,10 +69,15 @@
     FTC_SBit   sbit   = snode->sbits;
     FT_UInt    count  = snode->count;
     FT_Memory  memory = cache->memory;
+    FTC_Store  store  = cache->manager->store;
 
 
     for ( ; count > 0; sbit++, count-- )
-      FT_FREE( sbit->buffer );
+    {
+      /* bitmaps from the glyph store are not ours */
+      if ( !FTC_STORE_OWNS( store, sbit->buffer ) )
+        FT_FREE( sbit->buffer );
+    }
 
     FTC_GNode_Done( FTC_GNODE( snode ), cache );
 
@@ -109,6 +115,9 @@
     FT_Face           face;
     FTC_SBit          sbit;
     FTC_SFamilyClass  clazz;
+    FTC_Store         store  = manager->store;
+    FTC_StoreKeyRec   key;
+    FT_Bool           stored = FALSE;
 
 
     if ( gindex - gnode->gindex >= snode->count )
@@ -120,9 +129,28 @@
     sbit  = snode->sbits + ( gindex - gnode->gindex );
     clazz = (FTC_SFamilyClass)family->clazz;
 
+    if ( store                                                   &&
+         clazz->family_get_store_key                             &&
+         clazz->family_get_store_key( family, manager, &key )    )
+    {
+      /* the glyph store's bitmaps don't count as cache memory */
+      if ( ftc_store_lookup( store, &key, gindex, sbit ) )
+      {
+        if ( asize )
+          *asize = 0;
+        return FT_Err_Ok;
+      }
+
+      stored = TRUE;
+    }
+
     error = clazz->family_load_glyph( family, gindex, manager, &face );
     if ( error )
+    {
+      /* the failure might be temporary */
+      stored = FALSE;
       goto BadGlyph;
+    }
 
     {
       FT_Int        temp;
@@ -206,6 +234,9 @@
         *asize = 0;
     }
 
+    if ( stored && !error )
+      ftc_store_record( store, &key, gindex, sbit );
+
     return error;
   }
 
@@ -290,11 +321,10 @@
     FTC_SNode  snode = (FTC_SNode)ftcsnode;
     FT_UInt    count = snode->count;
     FTC_SBit   sbit  = snode->sbits;
+    FTC_Store  store = cache->manager->store;
     FT_Int     pitch;
     FT_Offset  size;
 
-    FT_UNUSED( cache );
-
 
     FT_ASSERT( snode->count <= FTC_SBIT_ITEMS_PER_NODE );
 
@@ -303,7 +333,7 @@
 
     for ( ; count > 0; count--, sbit++ )
     {
-      if ( sbit->buffer )
+      if ( sbit->buffer && !FTC_STORE_OWNS( store, sbit->buffer ) )
       {
         pitch = sbit->pitch;
         if ( pitch < 0 )
@@ -404,7 +434,7 @@
         if ( error )
           result = 0;
         else
-          cache->manager->cur_weight += size;
+          FTC_CACHE_ADD_WEIGHT( cache, size );
       }
     }
 
@@ -22,6 +22,7 @@
 
 #include <freetype/ftcache.h>
 #include "ftcglyph.h"
+#include "ftcstore.h"
 
 
 FT_BEGIN_HEADER
@@ -51,11 +52,18 @@ FT_BEGIN_HEADER
                                 FTC_Manager  manager,
                                 FT_Face     *aface );
 
+  /* fill the store key of a family; return FALSE if it has none */
+  typedef FT_Bool
+  (*FTC_SFamily_GetStoreKeyFunc)( FTC_Family    family,
+                                  FTC_Manager   manager,
+                                  FTC_StoreKey  key );
+
   typedef struct  FTC_SFamilyClassRec_
   {
-    FTC_MruListClassRec        clazz;
-    FTC_SFamily_GetCountFunc   family_get_count;
-    FTC_SFamily_LoadGlyphFunc  family_load_glyph;
+    FTC_MruListClassRec          clazz;
+    FTC_SFamily_GetCountFunc     family_get_count;
+    FTC_SFamily_LoadGlyphFunc    family_load_glyph;
+    FTC_SFamily_GetStoreKeyFunc  family_get_store_key;  /* optional */
 
   } FTC_SFamilyClassRec;
 
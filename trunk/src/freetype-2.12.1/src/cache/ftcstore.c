@@ -0,0 +1,531 @@
+/****************************************************************************
+ *
+ * ftcstore.c
+ *
+ *   FreeType persistent glyph store (body).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include "ftcstore.h"
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+#include <freetype/fterrors.h>
+
+#include "ftcerror.h"
+
+#undef  FT_COMPONENT
+#define FT_COMPONENT  cache
+
+
+  /* rendering may change between releases */
+#define FTC_STORE_VERSION  ( ( FREETYPE_MAJOR << 16 ) | \
+                             ( FREETYPE_MINOR <<  8 ) | \
+                               FREETYPE_PATCH         )
+
+#define FTC_STORE_MIX( h, v )  ( ( (h) ^ (FT_UInt32)(v) ) * 16777619UL )
+
+
+  static FT_UInt32
+  ftc_store_hash( FTC_StoreKey  key,
+                  FT_UInt       gindex )
+  {
+    FT_UInt32  h = 2166136261UL;
+
+
+    h = FTC_STORE_MIX( h, key->font[0] );
+    h = FTC_STORE_MIX( h, key->font[1] );
+    h = FTC_STORE_MIX( h, key->font[2] );
+    h = FTC_STORE_MIX( h, key->font[3] );
+    h = FTC_STORE_MIX( h, key->width );
+    h = FTC_STORE_MIX( h, key->height );
+    h = FTC_STORE_MIX( h, key->pixel );
+    h = FTC_STORE_MIX( h, key->x_res );
+    h = FTC_STORE_MIX( h, key->y_res );
+    h = FTC_STORE_MIX( h, key->load_flags );
+    h = FTC_STORE_MIX( h, gindex );
+
+    return h ^ ( h >> 16 );
+  }
+
+
+#define FTC_STORE_KEY_EQUAL( a, b )            \
+          ( (a)->font[0]    == (b)->font[0]    && \
+            (a)->font[1]    == (b)->font[1]    && \
+            (a)->font[2]    == (b)->font[2]    && \
+            (a)->font[3]    == (b)->font[3]    && \
+            (a)->width      == (b)->width      && \
+            (a)->height     == (b)->height     && \
+            (a)->pixel      == (b)->pixel      && \
+            (a)->x_res      == (b)->x_res      && \
+            (a)->y_res      == (b)->y_res      && \
+            (a)->load_flags == (b)->load_flags )
+
+
+  /* the number of pixel bytes of a record */
+#define FTC_STORE_RECORD_SIZE( rec )  \
+          ( (FT_ULong)FT_ABS( (rec)->pitch ) * (rec)->height )
+
+
+  /* the smallest valid pitch of a bitmap row, or 0 for unknown formats */
+  static FT_UInt
+  ftc_store_min_pitch( FT_Byte  format,
+                       FT_UInt  width )
+  {
+    switch ( format )
+    {
+    case FT_PIXEL_MODE_MONO:
+      return ( width + 7 ) >> 3;
+    case FT_PIXEL_MODE_GRAY2:
+      return ( width + 3 ) >> 2;
+    case FT_PIXEL_MODE_GRAY4:
+      return ( width + 1 ) >> 1;
+    case FT_PIXEL_MODE_GRAY:
+    case FT_PIXEL_MODE_LCD:
+    case FT_PIXEL_MODE_LCD_V:
+      return width ? width : 1;
+    case FT_PIXEL_MODE_BGRA:
+      return width ? 4 * width : 1;
+    default:
+      return 0;
+    }
+  }
+
+
+  /* check the layout of a store so that lookups need no further tests */
+  static FT_Error
+  ftc_store_validate( FTC_Store       store,
+                      const FT_Byte*  base,
+                      FT_ULong        size )
+  {
+    const FTC_StoreHeaderRec*  header = (const FTC_StoreHeaderRec*)base;
+    const FT_UInt32*           buckets;
+    const FTC_StoreRecordRec*  records;
+    FT_UInt32                  num_buckets, num_records, nn;
+    FT_ULong                   tables_size;
+
+
+    if ( (FT_PtrDist)base & 3 )
+      return FT_THROW( Invalid_Argument );
+
+    if ( size < sizeof ( *header )          ||
+         header->magic != FTC_STORE_MAGIC   )
+      return FT_THROW( Invalid_File_Format );
+
+    if ( header->format  != FTC_STORE_FORMAT  ||
+         header->version != FTC_STORE_VERSION )
+      return FT_THROW( Invalid_Version );
+
+    num_buckets = header->num_buckets;
+    num_records = header->num_records;
+
+    if ( header->header_size != sizeof ( FTC_StoreHeaderRec ) ||
+         header->record_size != sizeof ( FTC_StoreRecordRec ) ||
+         header->total_size  >  size                          ||
+         num_buckets == 0                                     ||
+         ( num_buckets & ( num_buckets - 1 ) )                )
+      goto Bad;
+
+    /* avoid overflow */
+    if ( num_buckets > size / 4                                       ||
+         num_records > size / sizeof ( FTC_StoreRecordRec )           )
+      goto Bad;
+
+    tables_size = sizeof ( FTC_StoreHeaderRec ) +
+                  num_buckets * 4 +
+                  num_records * sizeof ( FTC_StoreRecordRec );
+    if ( tables_size > header->total_size )
+      goto Bad;
+
+    buckets = (const FT_UInt32*)( header + 1 );
+    records = (const FTC_StoreRecordRec*)( buckets + num_buckets );
+
+    for ( nn = 0; nn < num_buckets; nn++ )
+      if ( buckets[nn] > num_records )
+        goto Bad;
+
+    for ( nn = 0; nn < num_records; nn++ )
+    {
+      const FTC_StoreRecordRec*  rec = records + nn;
+      FT_ULong                   pixels;
+
+
+      /* chains must go downwards, so that they end */
+      if ( rec->prev > nn )
+        goto Bad;
+
+      /* we never write bottom-up bitmaps */
+      if ( rec->pitch < 0 )
+        goto Bad;
+
+      pixels = FTC_STORE_RECORD_SIZE( rec );
+      if ( rec->offset )
+      {
+        FT_UInt  min_pitch = ftc_store_min_pitch( rec->format, rec->width );
+
+
+        if ( rec->offset < tables_size                 ||
+             rec->offset >= header->total_size         ||
+             pixels > header->total_size - rec->offset ||
+             !min_pitch                                ||
+             (FT_UInt)rec->pitch < min_pitch           )
+          goto Bad;
+      }
+      else if ( pixels )
+        goto Bad;
+    }
+
+    store->base        = base;
+    store->size        = header->total_size;
+    store->buckets     = buckets;
+    store->records     = records;
+    store->num_buckets = num_buckets;
+    store->num_records = num_records;
+
+    return FT_Err_Ok;
+
+  Bad:
+    FT_TRACE0(( "ftc_store_validate: invalid glyph store\n" ));
+    return FT_THROW( Invalid_File_Format );
+  }
+
+
+  FT_LOCAL_DEF( FT_Error )
+  ftc_store_new( FT_Memory              memory,
+                 const FT_Byte*         base,
+                 FT_ULong               size,
+                 FTC_Store_FontKeyFunc  key_func,
+                 FT_Pointer             key_data,
+                 FTC_Store             *astore )
+  {
+    FT_Error   error;
+    FTC_Store  store = NULL;
+
+
+    if ( FT_NEW( store ) )
+      goto Exit;
+
+    store->memory   = memory;
+    store->key_func = key_func;
+    store->key_data = key_data;
+
+    if ( base )
+    {
+      error = ftc_store_validate( store, base, size );
+      if ( error )
+        FT_FREE( store );
+    }
+
+  Exit:
+    *astore = store;
+    return error;
+  }
+
+
+  FT_LOCAL_DEF( void )
+  ftc_store_done( FTC_Store  store )
+  {
+    FT_Memory  memory;
+    FT_UInt32  nn;
+
+
+    if ( !store )
+      return;
+
+    memory = store->memory;
+
+    for ( nn = 0; nn < store->new_num_records; nn++ )
+      FT_FREE( store->new_pixels[nn] );
+
+    FT_FREE( store->new_pixels );
+    FT_FREE( store->new_records );
+    FT_FREE( store->new_buckets );
+
+    FT_FREE( store );
+  }
+
+
+  FT_LOCAL_DEF( FT_Bool )
+  ftc_store_lookup( FTC_Store     store,
+                    FTC_StoreKey  key,
+                    FT_UInt       gindex,
+                    FTC_SBit      sbit )
+  {
+    FT_UInt32  idx;
+
+
+    if ( !store->num_records )
+      return FALSE;
+
+    idx = store->buckets[ftc_store_hash( key, gindex ) &
+                         ( store->num_buckets - 1 )];
+    while ( idx )
+    {
+      const FTC_StoreRecordRec*  rec = store->records + idx - 1;
+
+
+      if ( rec->gindex == gindex && FTC_STORE_KEY_EQUAL( &rec->key, key ) )
+      {
+        sbit->width     = rec->width;
+        sbit->height    = rec->height;
+        sbit->left      = rec->left;
+        sbit->top       = rec->top;
+        sbit->format    = rec->format;
+        sbit->max_grays = rec->max_grays;
+        sbit->pitch     = rec->pitch;
+        sbit->xadvance  = rec->xadvance;
+        sbit->yadvance  = rec->yadvance;
+        sbit->buffer    = rec->offset ? (FT_Byte*)store->base + rec->offset
+                                      : NULL;
+        return TRUE;
+      }
+
+      idx = rec->prev;
+    }
+
+    return FALSE;
+  }
+
+
+  /* rebuild the journal's hash chains with twice as many buckets */
+  static FT_Error
+  ftc_store_grow_buckets( FTC_Store  store )
+  {
+    FT_Memory  memory      = store->memory;
+    FT_Error   error;
+    FT_UInt32  num_buckets = store->new_num_buckets ? 2 * store->new_num_buckets
+                                                    : 64;
+    FT_UInt32  nn;
+
+
+    if ( FT_RENEW_ARRAY( store->new_buckets,
+                         store->new_num_buckets, num_buckets ) )
+      return error;
+
+    FT_ARRAY_ZERO( store->new_buckets, num_buckets );
+    store->new_num_buckets = num_buckets;
+
+    for ( nn = 0; nn < store->new_num_records; nn++ )
+    {
+      FTC_StoreRecord  rec = store->new_records + nn;
+      FT_UInt32*       top = store->new_buckets +
+                               ( ftc_store_hash( &rec->key, rec->gindex ) &
+                                 ( num_buckets - 1 ) );
+
+
+      rec->prev = *top;
+      *top      = nn + 1;
+    }
+
+    return FT_Err_Ok;
+  }
+
+
+  FT_LOCAL_DEF( void )
+  ftc_store_record( FTC_Store     store,
+                    FTC_StoreKey  key,
+                    FT_UInt       gindex,
+                    FTC_SBit      sbit )
+  {
+    FT_Memory        memory = store->memory;
+    FT_Error         error;
+    FT_ULong         size   = (FT_ULong)FT_ABS( sbit->pitch ) * sbit->height;
+    FT_UInt32        idx;
+    FT_UInt32*       top;
+    FTC_StoreRecord  rec;
+
+
+    /* see `ftc_store_validate' */
+    if ( ( !sbit->buffer && size )                        ||
+         sbit->pitch < 0                                  ||
+         store->new_size + size > FTC_STORE_MAX_JOURNAL )
+      return;
+
+    if ( store->new_num_records >= store->new_num_buckets &&
+         ftc_store_grow_buckets( store )                  )
+      return;
+
+    top = store->new_buckets + ( ftc_store_hash( key, gindex ) &
+                                 ( store->new_num_buckets - 1 ) );
+
+    /* the glyph may have been flushed and loaded again */
+    for ( idx = *top; idx; idx = rec->prev )
+    {
+      rec = store->new_records + idx - 1;
+      if ( rec->gindex == gindex && FTC_STORE_KEY_EQUAL( &rec->key, key ) )
+        return;
+    }
+
+    if ( store->new_num_records == store->new_max_records )
+    {
+      FT_UInt32  new_max = store->new_max_records ? 2 * store->new_max_records
+                                                  : 64;
+
+
+      if ( FT_QRENEW_ARRAY( store->new_records,
+                            store->new_max_records, new_max ) )
+        return;
+
+      if ( FT_QRENEW_ARRAY( store->new_pixels,
+                            store->new_max_records, new_max ) )
+        return;
+
+      store->new_max_records = new_max;
+    }
+
+    idx = store->new_num_records;
+    rec = store->new_records + idx;
+
+    store->new_pixels[idx] = NULL;
+    if ( size )
+    {
+      if ( FT_QALLOC( store->new_pixels[idx], size ) )
+        return;
+
+      FT_MEM_COPY( store->new_pixels[idx], sbit->buffer, size );
+    }
+
+    FT_ZERO( rec );
+
+    rec->key       = *key;
+    rec->gindex    = gindex;
+    rec->width     = sbit->width;
+    rec->height    = sbit->height;
+    rec->left      = sbit->left;
+    rec->top       = sbit->top;
+    rec->format    = sbit->format;
+    rec->max_grays = sbit->max_grays;
+    rec->pitch     = sbit->pitch;
+    rec->xadvance  = sbit->xadvance;
+    rec->yadvance  = sbit->yadvance;
+    rec->prev      = *top;
+
+    *top = idx + 1;
+
+    store->new_num_records++;
+    store->new_size += size;
+  }
+
+
+  FT_LOCAL_DEF( FT_Error )
+  ftc_store_save( FTC_Store            store,
+                  FTC_Store_WriteFunc  write_func,
+                  FT_Pointer           write_data )
+  {
+    FT_Memory           memory = store->memory;
+    FT_Error            error;
+    FTC_StoreHeaderRec  header;
+    FTC_StoreRecord     records = NULL;
+    FT_UInt32*          buckets = NULL;
+    FT_UInt32           num_records, num_buckets, nn;
+    FT_ULong            offset;
+
+
+    num_records = store->num_records + store->new_num_records;
+
+    num_buckets = 1;
+    while ( num_buckets < num_records )
+      num_buckets <<= 1;
+
+    if ( FT_QNEW_ARRAY( records, num_records ) ||
+         FT_NEW_ARRAY( buckets, num_buckets )  )
+      goto Exit;
+
+    offset = sizeof ( FTC_StoreHeaderRec ) +
+             num_buckets * 4 +
+             (FT_ULong)num_records * sizeof ( FTC_StoreRecordRec );
+
+    for ( nn = 0; nn < num_records; nn++ )
+    {
+      FTC_StoreRecord  rec = records + nn;
+      FT_UInt32*       top;
+      FT_ULong         size;
+
+
+      if ( nn < store->num_records )
+        *rec = store->records[nn];
+      else
+        *rec = store->new_records[nn - store->num_records];
+
+      top = buckets + ( ftc_store_hash( &rec->key, rec->gindex ) &
+                        ( num_buckets - 1 ) );
+
+      rec->prev = *top;
+      *top      = nn + 1;
+
+      size = FTC_STORE_RECORD_SIZE( rec );
+      if ( size )
+      {
+        if ( offset > 0xFFFFFFFFUL - size )
+        {
+          error = FT_THROW( Array_Too_Large );
+          goto Exit;
+        }
+
+        rec->offset = (FT_UInt32)offset;
+        offset     += size;
+      }
+      else
+        rec->offset = 0;
+    }
+
+    header.magic       = FTC_STORE_MAGIC;
+    header.format      = FTC_STORE_FORMAT;
+    header.version     = FTC_STORE_VERSION;
+    header.header_size = sizeof ( FTC_StoreHeaderRec );
+    header.record_size = sizeof ( FTC_StoreRecordRec );
+    header.num_buckets = num_buckets;
+    header.num_records = num_records;
+    header.total_size  = (FT_UInt32)offset;
+
+    error = write_func( write_data, (const FT_Byte*)&header,
+                        sizeof ( header ) );
+    if ( error )
+      goto Exit;
+
+    error = write_func( write_data, (const FT_Byte*)buckets,
+                        num_buckets * 4 );
+    if ( error )
+      goto Exit;
+
+    error = write_func( write_data, (const FT_Byte*)records,
+                        num_records * sizeof ( FTC_StoreRecordRec ) );
+    if ( error )
+      goto Exit;
+
+    for ( nn = 0; nn < num_records && !error; nn++ )
+    {
+      const FT_Byte*  pixels;
+
+
+      if ( !records[nn].offset )
+        continue;
+
+      if ( nn < store->num_records )
+        pixels = store->base + store->records[nn].offset;
+      else
+        pixels = store->new_pixels[nn - store->num_records];
+
+      error = write_func( write_data, pixels,
+                          FTC_STORE_RECORD_SIZE( records + nn ) );
+    }
+
+  Exit:
+    FT_FREE( records );
+    FT_FREE( buckets );
+
+    return error;
+  }
+
+
+/* END */
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ * ftcstore.h
+ *
+ *   FreeType persistent glyph store (specification).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+  /**************************************************************************
+   *
+   * A glyph store is a block of memory holding small glyph bitmaps, so
+   * that they can be shared across process restarts through a
+   * memory-mapped file.  All values use the native byte order; the layout
+   * is
+   *
+   *   FTC_StoreHeaderRec   header
+   *   FT_UInt32            buckets[num_buckets]
+   *   FTC_StoreRecordRec   records[num_records]
+   *   FT_Byte              pixels[]
+   *
+   * A bucket holds the index plus one of the last record with a given
+   * masked hash (or zero), and each record the index plus one of the
+   * previous record in its bucket, which is always smaller than its own.
+   *
+   * Glyphs loaded while a store is attached are copied into a journal
+   * with the same record structure, to be merged into the next store
+   * written.
+   *
+   */
+
+
+#ifndef FTCSTORE_H_
+#define FTCSTORE_H_
+
+
+#include <freetype/ftcache.h>
+
+
+FT_BEGIN_HEADER
+
+
+#define FTC_STORE_MAGIC    FT_MAKE_TAG( 'F', 'T', 'C', 'S' )
+#define FTC_STORE_FORMAT   1
+
+  /* the maximum size of the journal's bitmaps */
+#define FTC_STORE_MAX_JOURNAL  ( 4L * 1024 * 1024 )
+
+
+  typedef struct  FTC_StoreHeaderRec_
+  {
+    FT_UInt32  magic;
+    FT_UInt32  format;
+    FT_UInt32  version;       /* FreeType version of the writer */
+    FT_UInt32  header_size;
+    FT_UInt32  record_size;
+    FT_UInt32  num_buckets;   /* a power of 2                   */
+    FT_UInt32  num_records;
+    FT_UInt32  total_size;
+
+  } FTC_StoreHeaderRec;
+
+
+  /* the key of a glyph's family */
+  typedef struct  FTC_StoreKeyRec_
+  {
+    FT_UInt32  font[4];       /* from FTC_Store_FontKeyFunc */
+    FT_UInt32  width;
+    FT_UInt32  height;
+    FT_UInt32  pixel;
+    FT_UInt32  x_res;         /* 0 for pixel sizes          */
+    FT_UInt32  y_res;
+    FT_UInt32  load_flags;
+
+  } FTC_StoreKeyRec, *FTC_StoreKey;
+
+
+  typedef struct  FTC_StoreRecordRec_
+  {
+    FTC_StoreKeyRec  key;
+    FT_UInt32        gindex;
+    FT_UInt32        prev;     /* previous record in bucket, plus one */
+    FT_UInt32        offset;   /* of the pixels; 0 if none            */
+
+    /* the fields of FTC_SBitRec */
+    FT_Byte          width;
+    FT_Byte          height;
+    FT_Char          left;
+    FT_Char          top;
+    FT_Byte          format;
+    FT_Byte          max_grays;
+    FT_Short         pitch;
+    FT_Char          xadvance;
+    FT_Char          yadvance;
+    FT_Byte          pad[2];
+
+  } FTC_StoreRecordRec, *FTC_StoreRecord;
+
+
+  typedef struct  FTC_StoreRec_
+  {
+    FT_Memory                  memory;
+
+    const FT_Byte*             base;
+    FT_ULong                   size;
+    const FT_UInt32*           buckets;
+    const FTC_StoreRecordRec*  records;
+    FT_UInt32                  num_buckets;
+    FT_UInt32                  num_records;
+
+    FTC_Store_FontKeyFunc      key_func;
+    FT_Pointer                 key_data;
+
+    /* the journal, with pixels allocated separately */
+    FTC_StoreRecord            new_records;
+    FT_Byte**                  new_pixels;
+    FT_UInt32*                 new_buckets;
+    FT_UInt32                  new_num_buckets;
+    FT_UInt32                  new_num_records;
+    FT_UInt32                  new_max_records;
+    FT_ULong                   new_size;
+
+  } FTC_StoreRec, *FTC_Store;
+
+
+  /* true if `p' points into the store's memory */
+#define FTC_STORE_OWNS( store, p )                    \
+          ( (store)                                &&  \
+            (const FT_Byte*)(p) >= (store)->base   &&  \
+            (const FT_Byte*)(p) <  (store)->base +     \
+                                     (store)->size )
+
+
+  FT_LOCAL( FT_Error )
+  ftc_store_new( FT_Memory              memory,
+                 const FT_Byte*         base,
+                 FT_ULong               size,
+                 FTC_Store_FontKeyFunc  key_func,
+                 FT_Pointer             key_data,
+                 FTC_Store             *astore );
+
+  FT_LOCAL( void )
+  ftc_store_done( FTC_Store  store );
+
+  /* fill `sbit' from the store; return FALSE if the glyph is unknown */
+  FT_LOCAL( FT_Bool )
+  ftc_store_lookup( FTC_Store     store,
+                    FTC_StoreKey  key,
+                    FT_UInt       gindex,
+                    FTC_SBit      sbit );
+
+  /* copy a loaded glyph into the journal, if new */
+  FT_LOCAL( void )
+  ftc_store_record( FTC_Store     store,
+                    FTC_StoreKey  key,
+                    FT_UInt       gindex,
+                    FTC_SBit      sbit );
+
+  FT_LOCAL( FT_Error )
+  ftc_store_save( FTC_Store            store,
+                  FTC_Store_WriteFunc  write_func,
+                  FT_Pointer           write_data );
+
+  /* */
+
+FT_END_HEADER
+
+#endif /* FTCSTORE_H_ */
+
+
+/* END */
@@ -181,7 +181,7 @@ THE SOFTWARE.
     pcf_cmap_char_index,
     pcf_cmap_char_next,
 
-    NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL
   };
 
 
@@ -169,7 +169,8 @@
     (FT_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+    (FT_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -145,7 +145,8 @@
     (FT_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+    (FT_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -174,7 +175,8 @@
     (FT_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+    (FT_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -274,7 +276,8 @@
     (FT_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+    (FT_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -367,7 +370,8 @@
     (FT_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+    (FT_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -54,6 +54,7 @@
 #include "ttmtx.h"
 
 #include <freetype/internal/services/svgldict.h>
+#include <freetype/internal/services/svkern.h>
 #include <freetype/internal/services/svpostnm.h>
 #include <freetype/internal/services/svsfnt.h>
 #include <freetype/internal/services/svttcmap.h>
@@ -113,6 +114,7 @@
       break;
 
     case FT_SFNT_PCLT:
+      (void)TT_FACE_LOAD_LAZY( face, TT_LAZY_TABLE_PCLT );
       table = face->pclt.Version ? &face->pclt : NULL;
       break;
 
@@ -1153,42 +1155,57 @@
 #endif /* TT_CONFIG_OPTION_BDF */
 
 
+  /*
+   * KERNING
+   */
+
+  static const FT_Service_KerningRec  sfnt_service_kerning =
+  {
+    NULL,                                              /* get_track */
+    (FT_Kerning_PairsGetFunc)tt_face_get_kerning_run   /* get_pairs */
+  };
+
+
   /*
    * SERVICE LIST
    */
 
 #if defined TT_CONFIG_OPTION_POSTSCRIPT_NAMES && defined TT_CONFIG_OPTION_BDF
-  FT_DEFINE_SERVICEDESCREC5(
+  FT_DEFINE_SERVICEDESCREC6(
     sfnt_services,
 
     FT_SERVICE_ID_SFNT_TABLE,           &sfnt_service_sfnt_table,
     FT_SERVICE_ID_POSTSCRIPT_FONT_NAME, &sfnt_service_ps_name,
     FT_SERVICE_ID_GLYPH_DICT,           &sfnt_service_glyph_dict,
     FT_SERVICE_ID_BDF,                  &sfnt_service_bdf,
-    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info )
+    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info,
+    FT_SERVICE_ID_KERNING,              &sfnt_service_kerning )
 #elif defined TT_CONFIG_OPTION_POSTSCRIPT_NAMES
-  FT_DEFINE_SERVICEDESCREC4(
+  FT_DEFINE_SERVICEDESCREC5(
     sfnt_services,
 
     FT_SERVICE_ID_SFNT_TABLE,           &sfnt_service_sfnt_table,
     FT_SERVICE_ID_POSTSCRIPT_FONT_NAME, &sfnt_service_ps_name,
     FT_SERVICE_ID_GLYPH_DICT,           &sfnt_service_glyph_dict,
-    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info )
+    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info,
+    FT_SERVICE_ID_KERNING,              &sfnt_service_kerning )
 #elif defined TT_CONFIG_OPTION_BDF
-  FT_DEFINE_SERVICEDESCREC4(
+  FT_DEFINE_SERVICEDESCREC5(
     sfnt_services,
 
     FT_SERVICE_ID_SFNT_TABLE,           &sfnt_service_sfnt_table,
     FT_SERVICE_ID_POSTSCRIPT_FONT_NAME, &sfnt_service_ps_name,
     FT_SERVICE_ID_BDF,                  &sfnt_service_bdf,
-    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info )
+    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info,
+    FT_SERVICE_ID_KERNING,              &sfnt_service_kerning )
 #else
-  FT_DEFINE_SERVICEDESCREC3(
+  FT_DEFINE_SERVICEDESCREC4(
     sfnt_services,
 
     FT_SERVICE_ID_SFNT_TABLE,           &sfnt_service_sfnt_table,
     FT_SERVICE_ID_POSTSCRIPT_FONT_NAME, &sfnt_service_ps_name,
-    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info )
+    FT_SERVICE_ID_TT_CMAP,              &tt_service_get_cmap_info,
+    FT_SERVICE_ID_KERNING,              &sfnt_service_kerning )
 #endif
 
 
@@ -1320,8 +1337,10 @@
                             /* TT_Load_Table_Func      load_svg        */
     PUT_SVG_SUPPORT( tt_face_free_svg ),
                             /* TT_Free_Table_Func      free_svg        */
-    PUT_SVG_SUPPORT( tt_face_load_svg_doc )
+    PUT_SVG_SUPPORT( tt_face_load_svg_doc ),
                             /* TT_Load_Svg_Doc_Func    load_svg_doc    */
+
+    sfnt_load_lazy_tables   /* TT_Load_Lazy_Func       load_lazy       */
   )
 
 
@@ -768,6 +768,33 @@
     FT_TRACE3(( "\n" ));                                    \
   } while ( 0 )
 
+
+  /* Load optional tables whose loading has been deferred by */
+  /* `sfnt_load_face'.  Each table is tried only once.       */
+  FT_LOCAL_DEF( FT_Error )
+  sfnt_load_lazy_tables( TT_Face  face,
+                         FT_UInt  tables )
+  {
+    FT_Stream     stream = face->root.stream;
+    SFNT_Service  sfnt   = (SFNT_Service)face->sfnt;
+    FT_Error      error  = FT_Err_Ok;
+
+
+    tables            &= face->lazy_tables;
+    face->lazy_tables &= ~tables;
+
+    FT_TRACE2(( "sfnt_load_lazy_tables: %p\n", (void *)face ));
+
+    if ( tables & TT_LAZY_TABLE_PCLT )
+      LOAD_( pclt );
+    if ( tables & TT_LAZY_TABLE_GASP )
+      LOAD_( gasp );
+    if ( tables & TT_LAZY_TABLE_KERN )
+      LOAD_( kern );
+
+    return error;
+  }
+
 #define GET_NAME( id, field )                                   \
   do                                                            \
   {                                                             \
@@ -801,6 +828,7 @@
     FT_Bool  ignore_typographic_family    = FALSE;
     FT_Bool  ignore_typographic_subfamily = FALSE;
     FT_Bool  ignore_sbix                  = FALSE;
+    FT_Bool  lazy_tables                  = FALSE;
 
     SFNT_Service  sfnt = (SFNT_Service)face->sfnt;
 
@@ -821,6 +849,9 @@
           ignore_typographic_subfamily = TRUE;
         else if ( params[i].tag == FT_PARAM_TAG_IGNORE_SBIX )
           ignore_sbix = TRUE;
+        else if ( params[i].tag == FT_PARAM_TAG_LAZY_TABLES  ||
+                  params[i].tag == FT_PARAM_TAG_METADATA_ONLY )
+          lazy_tables = TRUE;
       }
     }
 
@@ -1012,10 +1043,19 @@
     if ( sfnt->load_svg )
       LOAD_( svg );
 
-    /* consider the pclt, kerning, and gasp tables as optional */
-    LOAD_( pclt );
-    LOAD_( gasp );
-    LOAD_( kern );
+    /* consider the pclt, kerning, and gasp tables as optional; */
+    /* they are rarely needed, so the user can defer them       */
+    if ( lazy_tables )
+    {
+      FT_TRACE2(( "`pclt', `gasp', `kern' deferred\n" ));
+      face->lazy_tables = TT_LAZY_TABLES_ALL;
+    }
+    else
+    {
+      LOAD_( pclt );
+      LOAD_( gasp );
+      LOAD_( kern );
+    }
 
     face->root.num_glyphs = face->max_profile.numGlyphs;
 
@@ -1100,7 +1140,13 @@
         flags |= FT_FACE_FLAG_VERTICAL;
 
       /* kerning available ? */
-      if ( TT_FACE_HAS_KERNING( face ) )
+      if ( face->lazy_tables & TT_LAZY_TABLE_KERN )
+      {
+        /* not loaded yet; we can only check for the table's presence */
+        if ( tt_face_lookup_table( face, TTAG_kern ) )
+          flags |= FT_FACE_FLAG_KERNING;
+      }
+      else if ( TT_FACE_HAS_KERNING( face ) )
         flags |= FT_FACE_FLAG_KERNING;
 
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
@@ -1463,6 +1509,7 @@
 
     /* freeing table directory */
     FT_FREE( face->dir_tables );
+    FT_FREE( face->dir_index );
     face->num_tables = 0;
 
     {
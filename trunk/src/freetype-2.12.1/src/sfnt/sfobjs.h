@@ -44,6 +44,10 @@ FT_BEGIN_HEADER
   FT_LOCAL( void )
   sfnt_done_face( TT_Face  face );
 
+  FT_LOCAL( FT_Error )
+  sfnt_load_lazy_tables( TT_Face  face,
+                         FT_UInt  tables );
+
   FT_LOCAL( FT_Error )
   tt_face_get_name( TT_Face      face,
                     FT_UShort    nameid,
@@ -67,6 +67,210 @@
   }
 
 
+#ifdef TT_CONFIG_CMAP_PAGES
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                     COMPILED LOOKUP PAGES                     *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+  /*
+   * For charmaps that are used heavily, the results of a format's
+   * `char_index' function are cached in a two-level table: each Unicode
+   * plane has an array of 256 page pointers, and each page holds the
+   * glyph indices of 256 consecutive character codes.  Pages are filled
+   * with the format's own lookup function on first access, so results
+   * are identical.  Glyph indices larger than 0xFFFF are stored as zero;
+   * they are invalid and get rejected by `FT_Get_Char_Index' anyway.
+   *
+   * Compilation starts after `TT_CMAP_PAGES_THRESHOLD' direct lookups to
+   * avoid the setup costs for charmaps that are only queried a few times.
+   * Since filling a page costs 256 lookups, a page is only compiled after
+   * `TT_CMAP_PAGES_MIN_HITS' direct lookups of codes in its block; they
+   * are counted in `hits', indexed by a hash of the block number, so a
+   * collision at most compiles a page earlier.  At most
+   * `TT_CMAP_PAGES_MAX' pages get compiled for a charmap; codes in other
+   * blocks are then always looked up directly.
+   */
+
+#define TT_CMAP_PAGES_THRESHOLD  256
+#define TT_CMAP_PAGES_MIN_HITS   32
+#define TT_CMAP_PAGES_MAX        64
+#define TT_CMAP_PAGES_PLANES     17
+
+#define TT_CMAP_PAGES_HIT_INDEX( char_code )                    \
+          ( ( ( (char_code) >> 8 ) + ( (char_code) >> 16 ) * 37 ) & 0xFF )
+
+  typedef struct  TT_CMapPagesRec_
+  {
+    FT_UShort**  planes[TT_CMAP_PAGES_PLANES];
+    FT_UInt      num_pages;
+    FT_Byte      hits[256];
+
+  } TT_CMapPagesRec;
+
+
+  typedef FT_UInt
+  (*TT_CMap_CharMapFunc)( TT_CMap    cmap,
+                          FT_UInt32  char_code );
+
+
+  static FT_UInt
+  tt_cmap_pages_char_index( TT_CMap              cmap,
+                            FT_UInt32            char_code,
+                            TT_CMap_CharMapFunc  char_map )
+  {
+    FT_Memory     memory = FT_FACE_MEMORY( cmap->cmap.charmap.face );
+    TT_CMapPages  pages  = cmap->pages;
+    FT_UShort**   plane;
+    FT_UShort*    page;
+    FT_Error      error;
+
+
+    if ( char_code >= TT_CMAP_PAGES_PLANES * 0x10000UL )
+      return char_map( cmap, char_code );
+
+    if ( !pages )
+    {
+      if ( cmap->num_lookups < TT_CMAP_PAGES_THRESHOLD ||
+           FT_NEW( pages )                             )
+      {
+        cmap->num_lookups++;
+        return char_map( cmap, char_code );
+      }
+
+      cmap->pages = pages;
+    }
+
+    plane = pages->planes[char_code >> 16];
+    page  = plane ? plane[( char_code >> 8 ) & 0xFF] : NULL;
+    if ( !page )
+    {
+      FT_Byte*   hits = pages->hits + TT_CMAP_PAGES_HIT_INDEX( char_code );
+      FT_UInt32  base = char_code & ~0xFFUL;
+      FT_UInt    nn;
+
+
+      /* look up sparsely used blocks directly */
+      if ( pages->num_pages >= TT_CMAP_PAGES_MAX )
+        return char_map( cmap, char_code );
+
+      if ( *hits < TT_CMAP_PAGES_MIN_HITS )
+      {
+        (*hits)++;
+        return char_map( cmap, char_code );
+      }
+
+      if ( !plane )
+      {
+        if ( FT_NEW_ARRAY( plane, 256 ) )
+          return char_map( cmap, char_code );
+
+        pages->planes[char_code >> 16] = plane;
+      }
+
+      if ( FT_QNEW_ARRAY( page, 256 ) )
+        return char_map( cmap, char_code );
+
+      for ( nn = 0; nn < 256; nn++ )
+      {
+        FT_UInt  gindex = char_map( cmap, base + nn );
+
+
+        page[nn] = gindex > 0xFFFFU ? 0 : (FT_UShort)gindex;
+      }
+
+      plane[( char_code >> 8 ) & 0xFF] = page;
+      pages->num_pages++;
+    }
+
+    return page[char_code & 0xFF];
+  }
+
+
+  FT_CALLBACK_DEF( void )
+  tt_cmap_pages_done( TT_CMap  cmap )
+  {
+    FT_Memory     memory = FT_FACE_MEMORY( cmap->cmap.charmap.face );
+    TT_CMapPages  pages  = cmap->pages;
+    FT_UInt       nn, mm;
+
+
+    if ( !pages )
+      return;
+
+    for ( nn = 0; nn < TT_CMAP_PAGES_PLANES; nn++ )
+    {
+      FT_UShort**  plane = pages->planes[nn];
+
+
+      if ( !plane )
+        continue;
+
+      for ( mm = 0; mm < 256; mm++ )
+        FT_FREE( plane[mm] );
+
+      FT_FREE( pages->planes[nn] );
+    }
+
+    FT_FREE( cmap->pages );
+  }
+
+  /*
+   * Batch lookup for `FT_Get_Char_Indices'.  The first code of a run is
+   * mapped with the format's `char_index' function (which also compiles
+   * its page if appropriate); subsequent codes in the same page are then
+   * read directly from the compiled page.
+   */
+  FT_CALLBACK_DEF( void )
+  tt_cmap_pages_char_indices( TT_CMap           cmap,
+                              const FT_UInt32*  char_codes,
+                              FT_UInt           count,
+                              FT_UInt*          gindices )
+  {
+    FT_CMap_CharIndexFunc  char_index = cmap->cmap.clazz->char_index;
+    FT_UInt                nn         = 0;
+
+
+    while ( nn < count )
+    {
+      FT_UInt32   char_code = char_codes[nn];
+      FT_UShort*  page      = NULL;
+
+
+      gindices[nn++] = char_index( FT_CMAP( cmap ), char_code );
+
+      if ( cmap->pages                                  &&
+           char_code < TT_CMAP_PAGES_PLANES * 0x10000UL &&
+           cmap->pages->planes[char_code >> 16]         )
+        page = cmap->pages->planes[char_code >> 16]
+                                  [( char_code >> 8 ) & 0xFF];
+
+      if ( !page )
+        continue;
+
+      while ( nn < count && ( char_codes[nn] >> 8 ) == ( char_code >> 8 ) )
+      {
+        gindices[nn] = page[char_codes[nn] & 0xFF];
+        nn++;
+      }
+    }
+  }
+
+#define TT_CMAP_PAGES_DONE     tt_cmap_pages_done
+#define TT_CMAP_PAGES_INDICES  tt_cmap_pages_char_indices
+
+#else /* !TT_CONFIG_CMAP_PAGES */
+
+#define TT_CMAP_PAGES_DONE     NULL
+#define TT_CMAP_PAGES_INDICES  NULL
+
+#endif /* !TT_CONFIG_CMAP_PAGES */
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*****                                                               *****/
@@ -193,6 +397,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     0,
     (TT_CMap_ValidateFunc)tt_cmap0_validate,  /* validate      */
@@ -607,6 +812,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     2,
     (TT_CMap_ValidateFunc)tt_cmap2_validate,  /* validate      */
@@ -1488,6 +1694,17 @@
   }
 
 
+  static FT_UInt
+  tt_cmap4_char_map( TT_CMap    cmap,
+                     FT_UInt32  char_code )
+  {
+    if ( cmap->flags & TT_CMAP_FLAG_UNSORTED )
+      return tt_cmap4_char_map_linear( cmap, &char_code, 0 );
+    else
+      return tt_cmap4_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
   FT_CALLBACK_DEF( FT_UInt )
   tt_cmap4_char_index( TT_CMap    cmap,
                        FT_UInt32  char_code )
@@ -1495,10 +1712,11 @@
     if ( char_code >= 0x10000UL )
       return 0;
 
-    if ( cmap->flags & TT_CMAP_FLAG_UNSORTED )
-      return tt_cmap4_char_map_linear( cmap, &char_code, 0 );
-    else
-      return tt_cmap4_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_CMAP_PAGES
+    return tt_cmap_pages_char_index( cmap, char_code, tt_cmap4_char_map );
+#else
+    return tt_cmap4_char_map( cmap, char_code );
+#endif
   }
 
 
@@ -1555,7 +1773,7 @@
       sizeof ( TT_CMap4Rec ),
 
       (FT_CMap_InitFunc)     tt_cmap4_init,        /* init       */
-      (FT_CMap_DoneFunc)     NULL,                 /* done       */
+      (FT_CMap_DoneFunc)     TT_CMAP_PAGES_DONE,   /* done       */
       (FT_CMap_CharIndexFunc)tt_cmap4_char_index,  /* char_index */
       (FT_CMap_CharNextFunc) tt_cmap4_char_next,   /* char_next  */
 
@@ -1564,6 +1782,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     TT_CMAP_PAGES_INDICES,
 
     4,
     (TT_CMap_ValidateFunc)tt_cmap4_validate,  /* validate      */
@@ -1734,6 +1953,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     6,
     (TT_CMap_ValidateFunc)tt_cmap6_validate,  /* validate      */
@@ -2028,6 +2248,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     8,
     (TT_CMap_ValidateFunc)tt_cmap8_validate,  /* validate      */
@@ -2200,6 +2421,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     10,
     (TT_CMap_ValidateFunc)tt_cmap10_validate,  /* validate      */
@@ -2489,11 +2711,23 @@
   }
 
 
+  static FT_UInt
+  tt_cmap12_char_map( TT_CMap    cmap,
+                      FT_UInt32  char_code )
+  {
+    return tt_cmap12_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
   FT_CALLBACK_DEF( FT_UInt )
   tt_cmap12_char_index( TT_CMap    cmap,
                         FT_UInt32  char_code )
   {
-    return tt_cmap12_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_CMAP_PAGES
+    return tt_cmap_pages_char_index( cmap, char_code, tt_cmap12_char_map );
+#else
+    return tt_cmap12_char_map( cmap, char_code );
+#endif
   }
 
 
@@ -2544,7 +2778,7 @@
       sizeof ( TT_CMap12Rec ),
 
       (FT_CMap_InitFunc)     tt_cmap12_init,        /* init       */
-      (FT_CMap_DoneFunc)     NULL,                  /* done       */
+      (FT_CMap_DoneFunc)     TT_CMAP_PAGES_DONE,    /* done       */
       (FT_CMap_CharIndexFunc)tt_cmap12_char_index,  /* char_index */
       (FT_CMap_CharNextFunc) tt_cmap12_char_next,   /* char_next  */
 
@@ -2553,6 +2787,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     TT_CMAP_PAGES_INDICES,
 
     12,
     (TT_CMap_ValidateFunc)tt_cmap12_validate,  /* validate      */
@@ -2815,11 +3050,23 @@
   }
 
 
+  static FT_UInt
+  tt_cmap13_char_map( TT_CMap    cmap,
+                      FT_UInt32  char_code )
+  {
+    return tt_cmap13_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
   FT_CALLBACK_DEF( FT_UInt )
   tt_cmap13_char_index( TT_CMap    cmap,
                         FT_UInt32  char_code )
   {
-    return tt_cmap13_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_CMAP_PAGES
+    return tt_cmap_pages_char_index( cmap, char_code, tt_cmap13_char_map );
+#else
+    return tt_cmap13_char_map( cmap, char_code );
+#endif
   }
 
 
@@ -2870,7 +3117,7 @@
       sizeof ( TT_CMap13Rec ),
 
       (FT_CMap_InitFunc)     tt_cmap13_init,        /* init       */
-      (FT_CMap_DoneFunc)     NULL,                  /* done       */
+      (FT_CMap_DoneFunc)     TT_CMAP_PAGES_DONE,    /* done       */
       (FT_CMap_CharIndexFunc)tt_cmap13_char_index,  /* char_index */
       (FT_CMap_CharNextFunc) tt_cmap13_char_next,   /* char_next  */
 
@@ -2879,6 +3126,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     TT_CMAP_PAGES_INDICES,
 
     13,
     (TT_CMap_ValidateFunc)tt_cmap13_validate,  /* validate      */
@@ -3642,6 +3890,7 @@
       (FT_CMap_VariantListFunc)     tt_cmap14_variants,
       (FT_CMap_CharVariantListFunc) tt_cmap14_char_variants,
       (FT_CMap_VariantCharListFunc) tt_cmap14_variant_chars,
+      (FT_CMap_CharIndicesFunc)     NULL,
 
     14,
     (TT_CMap_ValidateFunc)tt_cmap14_validate,  /* validate      */
@@ -3750,6 +3999,7 @@
       (FT_CMap_VariantListFunc)     NULL,  /* variant_list     */
       (FT_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+      (FT_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
 
     ~0U,
     (TT_CMap_ValidateFunc)NULL,  /* validate      */
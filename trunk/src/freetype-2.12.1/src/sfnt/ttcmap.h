@@ -30,12 +30,19 @@ FT_BEGIN_HEADER
 #define TT_CMAP_FLAG_UNSORTED     1
 #define TT_CMAP_FLAG_OVERLAPPING  2
 
+  typedef struct TT_CMapPagesRec_*  TT_CMapPages;
+
   typedef struct  TT_CMapRec_
   {
     FT_CMapRec  cmap;
     FT_Byte*    data;           /* pointer to in-memory cmap table */
     FT_Int      flags;          /* for format 4 only               */
 
+#ifdef TT_CONFIG_CMAP_PAGES
+    TT_CMapPages  pages;        /* compiled lookup table, if any   */
+    FT_UInt       num_lookups;  /* lookups before compilation      */
+#endif
+
   } TT_CMapRec, *TT_CMap;
 
   typedef const struct TT_CMap_ClassRec_*  TT_CMap_Class;
@@ -66,6 +73,7 @@ FT_BEGIN_HEADER
                            variant_list_,      \
                            charvariant_list_,  \
                            variantchar_list_,  \
+                           char_indices_,      \
                            format_,            \
                            validate_,          \
                            get_cmap_info_ )    \
@@ -81,7 +89,8 @@ FT_BEGIN_HEADER
       char_var_default_,                       \
       variant_list_,                           \
       charvariant_list_,                       \
-      variantchar_list_                        \
+      variantchar_list_,                       \
+      char_indices_                            \
     },                                         \
                                                \
     format_,                                   \
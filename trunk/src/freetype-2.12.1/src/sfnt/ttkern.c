@@ -20,6 +20,7 @@
 #include <freetype/internal/ftdebug.h>
 #include <freetype/internal/ftstream.h>
 #include <freetype/tttags.h>
+#include <freetype/internal/sfnt.h>
 #include "ttkern.h"
 
 #include "sferrors.h"
@@ -39,6 +40,32 @@
 #define TT_KERN_INDEX( g1, g2 )  ( ( (FT_ULong)(g1) << 16 ) | (g2) )
 
 
+#ifdef TT_CONFIG_KERN_HASH
+
+  /*
+   * The hash table maps all kerning pairs of the available subtables to
+   * their combined value, using open addressing with linear probing.  It
+   * is at most half full.  Glyph index 0xFFFF can't occur in a valid
+   * font, so key 0xFFFFFFFF marks an empty slot.
+   */
+
+#define TT_KERN_HASH_MAX_PAIRS  0x10000UL
+#define TT_KERN_HASH_EMPTY      0xFFFFFFFFUL
+
+#define TT_KERN_HASH_SLOT( key, mask )                             \
+          ( ( (FT_UInt32)( (key) * 0x9E3779B1UL ) >> 7 ) & (mask) )
+
+  typedef struct  TT_KernHashRec_
+  {
+    FT_UInt32   mask;
+    FT_UInt32*  keys;
+    FT_Int*     values;
+
+  } TT_KernHashRec, *TT_KernHash;
+
+#endif /* TT_CONFIG_KERN_HASH */
+
+
   FT_LOCAL_DEF( FT_Error )
   tt_face_load_kern( TT_Face    face,
                      FT_Stream  stream )
@@ -173,6 +200,19 @@
   {
     FT_Stream  stream = face->root.stream;
 
+#ifdef TT_CONFIG_KERN_HASH
+    FT_Memory    memory = stream->memory;
+    TT_KernHash  hash   = (TT_KernHash)face->kern_hash;
+
+
+    if ( hash )
+    {
+      FT_FREE( hash->keys );
+      FT_FREE( hash->values );
+      FT_FREE( face->kern_hash );
+    }
+    face->kern_hash_done = 0;
+#endif
 
     FT_FRAME_RELEASE( face->kern_table );
     face->kern_table_size = 0;
@@ -182,10 +222,46 @@
   }
 
 
-  FT_LOCAL_DEF( FT_Int )
-  tt_face_get_kerning( TT_Face  face,
-                       FT_UInt  left_glyph,
-                       FT_UInt  right_glyph )
+  /* binary search of `key0' in the `num_pairs' ordered pairs at `p' */
+  static FT_Bool
+  tt_kern_bsearch( FT_Byte*  p,
+                   FT_UInt   num_pairs,
+                   FT_ULong  key0,
+                   FT_Int   *avalue )
+  {
+    FT_UInt  min = 0;
+    FT_UInt  max = num_pairs;
+
+
+    while ( min < max )
+    {
+      FT_UInt   mid = ( min + max ) >> 1;
+      FT_Byte*  q   = p + 6 * mid;
+      FT_ULong  key;
+
+
+      key = FT_NEXT_ULONG( q );
+
+      if ( key == key0 )
+      {
+        *avalue = FT_PEEK_SHORT( q );
+        return 1;
+      }
+      if ( key < key0 )
+        min = mid + 1;
+      else
+        max = mid;
+    }
+
+    return 0;
+  }
+
+
+  /* search all subtables for a kerning pair */
+  static FT_Int
+  tt_kern_search( TT_Face  face,
+                  FT_UInt  left_glyph,
+                  FT_UInt  right_glyph )
   {
     FT_Int   result = 0;
     FT_UInt  count, mask;
@@ -194,9 +270,6 @@
     FT_Byte*  p_limit;
 
 
-    if ( !face->kern_table )
-      return result;
-
     p       = face->kern_table;
     p_limit = p + face->kern_table_size;
 
@@ -243,29 +316,8 @@
 
           if ( face->kern_order_bits & mask )   /* binary search */
           {
-            FT_UInt   min = 0;
-            FT_UInt   max = num_pairs;
-
-
-            while ( min < max )
-            {
-              FT_UInt   mid = ( min + max ) >> 1;
-              FT_Byte*  q   = p + 6 * mid;
-              FT_ULong  key;
-
-
-              key = FT_NEXT_ULONG( q );
-
-              if ( key == key0 )
-              {
-                value = FT_PEEK_SHORT( q );
-                goto Found;
-              }
-              if ( key < key0 )
-                min = mid + 1;
-              else
-                max = mid;
-            }
+            if ( tt_kern_bsearch( p, num_pairs, key0, &value ) )
+              goto Found;
           }
           else /* linear search */
           {
@@ -312,6 +364,264 @@
     return result;
   }
 
+
+#ifdef TT_CONFIG_KERN_HASH
+
+  /*
+   * Build `face->kern_hash'.  The subtables are walked in order, and the
+   * value of each key is combined as in `tt_kern_search': the first
+   * subtable containing a key sets its value, and later ones either
+   * override it or add to it, depending on bit 3 of their coverage.
+   * Within a subtable, only the pair a search would find counts; this is
+   * the first one in unordered subtables and the binary search result in
+   * ordered ones.  A temporary array records which subtable last set a
+   * slot, so that duplicate pairs within a subtable can be skipped.
+   */
+  static void
+  tt_kern_hash_build( TT_Face  face )
+  {
+    FT_Memory    memory = face->root.memory;
+    FT_Error     error;
+    TT_KernHash  hash   = NULL;
+    FT_Byte*     owner  = NULL;
+    FT_ULong     total  = 0;
+    FT_UInt32    size;
+    FT_UInt      pass, count, mask, nn;
+    FT_Byte*     p;
+    FT_Byte*     p_limit = face->kern_table + face->kern_table_size;
+
+
+    face->kern_hash_done = 1;
+
+    /* pass 0 counts the pairs, pass 1 inserts them */
+    for ( pass = 0; pass < 2; pass++ )
+    {
+      p = face->kern_table + 4;
+
+      for ( count = face->num_kern_tables, mask = 1, nn = 0;
+            count > 0 && p + 6 <= p_limit;
+            count--, mask <<= 1, nn++ )
+      {
+        FT_Byte*  next     = p + FT_PEEK_USHORT( p + 2 );
+        FT_UInt   coverage = FT_PEEK_USHORT( p + 4 );
+        FT_Byte*  pairs;
+        FT_UInt   num_pairs, n;
+
+
+        if ( next > p_limit )
+          next = p_limit;
+
+        if ( !( face->kern_avail_bits & mask ) )
+          goto NextTable;
+
+        p        += 6;
+        num_pairs = FT_NEXT_USHORT( p );
+        p        += 6;
+
+        if ( ( next - p ) < 6 * (int)num_pairs )
+          num_pairs = (FT_UInt)( ( next - p ) / 6 );
+
+        if ( pass == 0 )
+        {
+          total += num_pairs;
+          goto NextTable;
+        }
+
+        pairs = p;
+
+        for ( n = num_pairs; n > 0; n-- )
+        {
+          FT_UInt32  key   = FT_NEXT_ULONG( p );
+          FT_Int     value = FT_NEXT_SHORT( p );
+          FT_UInt32  slot;
+
+
+          if ( key == TT_KERN_HASH_EMPTY )
+            goto Fail;
+
+          slot = TT_KERN_HASH_SLOT( key, hash->mask );
+          while ( hash->keys[slot] != TT_KERN_HASH_EMPTY &&
+                  hash->keys[slot] != key                )
+            slot = ( slot + 1 ) & hash->mask;
+
+          if ( hash->keys[slot] == key && owner[slot] == nn )
+            continue;  /* duplicate pair in this subtable */
+
+          if ( face->kern_order_bits & mask )
+            (void)tt_kern_bsearch( pairs, num_pairs, key, &value );
+
+          if ( hash->keys[slot] == TT_KERN_HASH_EMPTY )
+          {
+            hash->keys[slot]   = key;
+            hash->values[slot] = value;
+          }
+          else if ( coverage & 8 )  /* override or add */
+            hash->values[slot] = value;
+          else
+            hash->values[slot] += value;
+
+          owner[slot] = (FT_Byte)nn;
+        }
+
+      NextTable:
+        p = next;
+      }
+
+      if ( pass == 0 )
+      {
+        if ( total == 0 || total > TT_KERN_HASH_MAX_PAIRS )
+          return;
+
+        for ( size = 16; size < 2 * total; size <<= 1 )
+          ;
+
+        if ( FT_NEW( hash )                     ||
+             FT_QNEW_ARRAY( hash->keys, size )  ||
+             FT_QNEW_ARRAY( hash->values, size ) ||
+             FT_QNEW_ARRAY( owner, size )        )
+          goto Fail;
+
+        hash->mask = size - 1;
+        FT_MEM_SET( hash->keys, 0xFF, size * sizeof ( FT_UInt32 ) );
+      }
+    }
+
+    FT_TRACE3(( "tt_kern_hash_build: %lu pairs in %u slots\n",
+                total, hash->mask + 1 ));
+
+    FT_FREE( owner );
+    face->kern_hash = hash;
+    return;
+
+  Fail:
+    FT_FREE( owner );
+    if ( hash )
+    {
+      FT_FREE( hash->keys );
+      FT_FREE( hash->values );
+      FT_FREE( hash );
+    }
+  }
+
+#endif /* TT_CONFIG_KERN_HASH */
+
+
+#ifdef TT_CONFIG_KERN_HASH
+
+  static FT_Int
+  tt_kern_hash_lookup( TT_KernHash  hash,
+                       FT_UInt      left_glyph,
+                       FT_UInt      right_glyph )
+  {
+    FT_UInt32  key  = (FT_UInt32)TT_KERN_INDEX( left_glyph, right_glyph );
+    FT_UInt32  slot = TT_KERN_HASH_SLOT( key, hash->mask );
+
+
+    for (;;)
+    {
+      FT_UInt32  k = hash->keys[slot];
+
+
+      if ( k == key )
+        return hash->values[slot];
+      if ( k == TT_KERN_HASH_EMPTY )
+        return 0;
+
+      slot = ( slot + 1 ) & hash->mask;
+    }
+  }
+
+#endif /* TT_CONFIG_KERN_HASH */
+
+
+  /* Load the `kern' table and build the hash if not done yet. */
+  /* Return 0 if the face has no (usable) `kern' table.        */
+  static FT_Bool
+  tt_kern_prepare( TT_Face  face )
+  {
+    (void)TT_FACE_LOAD_LAZY( face, TT_LAZY_TABLE_KERN );
+
+    if ( !face->kern_table )
+      return 0;
+
+#ifdef TT_CONFIG_KERN_HASH
+    if ( !face->kern_hash_done )
+      tt_kern_hash_build( face );
+#endif
+
+    return 1;
+  }
+
+
+  FT_LOCAL_DEF( FT_Int )
+  tt_face_get_kerning( TT_Face  face,
+                       FT_UInt  left_glyph,
+                       FT_UInt  right_glyph )
+  {
+#ifdef TT_CONFIG_KERN_HASH
+    TT_KernHash  hash;
+#endif
+
+
+    if ( !tt_kern_prepare( face ) )
+      return 0;
+
+#ifdef TT_CONFIG_KERN_HASH
+    hash = (TT_KernHash)face->kern_hash;
+    if ( hash && left_glyph <= 0xFFFFU && right_glyph <= 0xFFFFU )
+      return tt_kern_hash_lookup( hash, left_glyph, right_glyph );
+#endif
+
+    return tt_kern_search( face, left_glyph, right_glyph );
+  }
+
+
+  FT_LOCAL_DEF( FT_Error )
+  tt_face_get_kerning_run( TT_Face         face,
+                           const FT_UInt*  glyph_indices,
+                           FT_UInt         count,
+                           FT_Vector*      akernings )
+  {
+    FT_UInt  n;
+
+#ifdef TT_CONFIG_KERN_HASH
+    TT_KernHash  hash;
+#endif
+
+
+    FT_MEM_ZERO( akernings, count * sizeof ( FT_Vector ) );
+
+    if ( count < 2 || !tt_kern_prepare( face ) )
+      return FT_Err_Ok;
+
+#ifdef TT_CONFIG_KERN_HASH
+    hash = (TT_KernHash)face->kern_hash;
+    if ( hash )
+    {
+      for ( n = 0; n < count - 1; n++ )
+      {
+        FT_UInt  left  = glyph_indices[n];
+        FT_UInt  right = glyph_indices[n + 1];
+
+
+        if ( left <= 0xFFFFU && right <= 0xFFFFU )
+          akernings[n].x = tt_kern_hash_lookup( hash, left, right );
+        else
+          akernings[n].x = tt_kern_search( face, left, right );
+      }
+
+      return FT_Err_Ok;
+    }
+#endif
+
+    for ( n = 0; n < count - 1; n++ )
+      akernings[n].x = tt_kern_search( face,
+                                       glyph_indices[n],
+                                       glyph_indices[n + 1] );
+
+    return FT_Err_Ok;
+  }
+
 #undef TT_KERN_INDEX
 
 /* END */
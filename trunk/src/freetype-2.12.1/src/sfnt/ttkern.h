@@ -40,6 +40,12 @@ FT_BEGIN_HEADER
                        FT_UInt     left_glyph,
                        FT_UInt     right_glyph );
 
+  FT_LOCAL( FT_Error )
+  tt_face_get_kerning_run( TT_Face         face,
+                           const FT_UInt*  glyph_indices,
+                           FT_UInt         count,
+                           FT_Vector*      akernings );
+
 #define TT_FACE_HAS_KERNING( face )  ( (face)->kern_avail_bits != 0 )
 
 
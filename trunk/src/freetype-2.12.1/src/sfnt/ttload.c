@@ -58,10 +58,7 @@
                         FT_ULong  tag  )
   {
     TT_Table  entry;
-    TT_Table  limit;
-#ifdef FT_DEBUG_LEVEL_TRACE
-    FT_Bool   zero_length = FALSE;
-#endif
+    FT_UInt   min, max;
 
 
     FT_TRACE4(( "tt_face_lookup_table: %p, `%c%c%c%c' -- ",
@@ -71,32 +68,37 @@
                 (FT_Char)( tag >> 8  ),
                 (FT_Char)( tag       ) ));
 
-    entry = face->dir_tables;
-    limit = entry + face->num_tables;
+    /* binary search in the tag-sorted index; there are no duplicates */
+    min = 0;
+    max = face->num_tables;
 
-    for ( ; entry < limit; entry++ )
+    while ( min < max )
     {
-      /* For compatibility with Windows, we consider    */
-      /* zero-length tables the same as missing tables. */
-      if ( entry->Tag == tag )
+      FT_UInt  mid = ( min + max ) >> 1;
+
+
+      entry = face->dir_tables + face->dir_index[mid];
+
+      if ( entry->Tag < tag )
+        min = mid + 1;
+      else if ( entry->Tag > tag )
+        max = mid;
+      else
       {
+        /* For compatibility with Windows, we consider    */
+        /* zero-length tables the same as missing tables. */
         if ( entry->Length != 0 )
         {
           FT_TRACE4(( "found table.\n" ));
           return entry;
         }
-#ifdef FT_DEBUG_LEVEL_TRACE
-        zero_length = TRUE;
-#endif
+
+        FT_TRACE4(( "ignoring empty table\n" ));
+        return NULL;
       }
     }
 
-#ifdef FT_DEBUG_LEVEL_TRACE
-    if ( zero_length )
-      FT_TRACE4(( "ignoring empty table\n" ));
-    else
-      FT_TRACE4(( "could not find table\n" ));
-#endif
+    FT_TRACE4(( "could not find table\n" ));
 
     return NULL;
   }
@@ -408,7 +410,8 @@
     face->num_tables = valid_entries;
     face->format_tag = sfnt.format_tag;
 
-    if ( FT_QNEW_ARRAY( face->dir_tables, face->num_tables ) )
+    if ( FT_QNEW_ARRAY( face->dir_tables, face->num_tables ) ||
+         FT_QNEW_ARRAY( face->dir_index, face->num_tables )  )
       goto Exit;
 
     if ( FT_STREAM_SEEK( sfnt.offset + 12 )      ||
@@ -423,8 +426,7 @@
     for ( nn = 0; nn < sfnt.num_tables; nn++ )
     {
       TT_TableRec  entry;
-      FT_UShort    i;
-      FT_Bool      duplicate;
+      FT_UShort    min, max;
 
 
       entry.Tag      = FT_GET_TAG4();
@@ -475,28 +477,40 @@
                     entry.CheckSum ));
 #endif
 
-      /* ignore duplicate tables – the first one wins */
-      duplicate = 0;
-      for ( i = 0; i < valid_entries; i++ )
+      /* ignore duplicate tables -- the first one wins; */
+      /* otherwise insert the entry into the sorted index */
+      min = 0;
+      max = valid_entries;
+
+      while ( min < max )
       {
-        if ( face->dir_tables[i].Tag == entry.Tag )
-        {
-          duplicate = 1;
+        FT_UShort  mid = (FT_UShort)( ( min + max ) >> 1 );
+        FT_ULong   mid_tag = face->dir_tables[face->dir_index[mid]].Tag;
+
+
+        if ( mid_tag < entry.Tag )
+          min = (FT_UShort)( mid + 1 );
+        else if ( mid_tag > entry.Tag )
+          max = mid;
+        else
           break;
-        }
       }
-      if ( duplicate )
+
+      if ( min < max )
       {
         FT_TRACE2(( "  (duplicate, ignored)\n" ));
         continue;
       }
-      else
-      {
-        FT_TRACE2(( "\n" ));
 
-        /* we finally have a valid entry */
-        face->dir_tables[valid_entries++] = entry;
-      }
+      FT_TRACE2(( "\n" ));
+
+      /* we finally have a valid entry */
+      ft_memmove( face->dir_index + min + 1,
+                  face->dir_index + min,
+                  ( valid_entries - min ) * sizeof ( FT_UShort ) );
+      face->dir_index[min] = valid_entries;
+
+      face->dir_tables[valid_entries++] = entry;
     }
 
     /* final adjustment to number of tables */
@@ -285,6 +285,7 @@ typedef ptrdiff_t  FT_PtrDist;
 #include <freetype/internal/ftdebug.h>
 #include <freetype/internal/ftcalc.h>
 #include <freetype/ftoutln.h>
+#include <freetype/ftdriver.h>
 
 #include "ftsmerrs.h"
 
@@ -501,6 +502,10 @@ typedef ptrdiff_t  FT_PtrDist;
 
     PCell*      ycells;      /* array of cell linked-lists; one per      */
                              /* vertical coordinate in the current band  */
+    int         channels;    /* coverage channels; 3 in LCD mode         */
+
+    TCoord      cull_min_ey; /* vertical limits used to skip Bézier      */
+    TCoord      cull_max_ey; /* arcs that cross the current band         */
 
     TPos        x,  y;       /* last point position */
 
@@ -510,6 +515,22 @@ typedef ptrdiff_t  FT_PtrDist;
     FT_Raster_Span_Func  render_span;
     void*                render_span_data;
 
+    /* LCD mode only, see `FT_GRAY_FLAG_LCD' */
+    const FT_Vector*  lcd_shift;   /* outline shift for each channel      */
+    FT_Vector         lcd_delta;   /* shift currently applied to outline  */
+    int               lcd_shared;  /* decompose once for all channels     */
+    TPos              lcd_dx[3];   /* upscaled channel shifts             */
+    TPos              lcd_dy[3];
+    TCoord            lcd_pad;     /* vertical reach of channel shifts    */
+    PCell*            lcd_ycells;  /* cell lists of all channels          */
+    PCell             lcd_cell[3]; /* current cell of each channel        */
+    int               lcd_xstep;   /* byte distance between pixels        */
+    int               lcd_cstep;   /* byte distance between channels      */
+
+    int            pool_grow;    /* the caller can enlarge the cell pool */
+    unsigned long  bands;        /* bands rendered                       */
+    unsigned long  band_splits;  /* bands bisected after pool overflow   */
+
   } gray_TWorker, *gray_PWorker;
 
 #if defined( _MSC_VER )
@@ -536,6 +557,15 @@ typedef ptrdiff_t  FT_PtrDist;
   {
     void*  memory;
 
+#ifndef STANDALONE_
+    PCell     pool;         /* heap cell pool, see `cell-pool-budget' */
+    FT_ULong  pool_size;    /* its size in cells                       */
+    FT_ULong  pool_budget;  /* its size limit in bytes; 0 if disabled  */
+
+    FT_Prop_CellPoolStats   stats;
+    FT_Prop_ParallelRaster  parallel;  /* see `parallel-raster' */
+#endif
+
   } gray_TRaster, *gray_PRaster;
 
 
@@ -996,6 +1026,48 @@ typedef ptrdiff_t  FT_PtrDist;
 
 #endif
 
+  /**************************************************************************
+   *
+   * Render a line for each LCD channel in shared mode.  The outline is
+   * decomposed and flattened only once, and every segment is shifted to
+   * each channel before being converted into the channel's own cells.
+   */
+  static void
+  gray_render_line_lcd( RAS_ARG_ TPos  to_x,
+                                 TPos  to_y )
+  {
+    TPos  x = ras.x;
+    TPos  y = ras.y;
+    int   c;
+
+
+    for ( c = 0; c < 3; c++ )
+    {
+      ras.ycells = ras.lcd_ycells + c * ras.count_ey;
+      ras.cell   = ras.lcd_cell[c];
+      ras.x      = x + ras.lcd_dx[c];
+      ras.y      = y + ras.lcd_dy[c];
+
+      gray_render_line( RAS_VAR_ to_x + ras.lcd_dx[c],
+                                 to_y + ras.lcd_dy[c] );
+
+      ras.lcd_cell[c] = ras.cell;
+    }
+
+    ras.x = to_x;
+    ras.y = to_y;
+  }
+
+
+#define GRAY_RENDER_LINE( to_x, to_y )                   \
+  FT_BEGIN_STMNT                                         \
+    if ( ras.lcd_shared )                                \
+      gray_render_line_lcd( RAS_VAR_ (to_x), (to_y) );   \
+    else                                                 \
+      gray_render_line( RAS_VAR_ (to_x), (to_y) );       \
+  FT_END_STMNT
+
+
   /*
    * Benchmarking shows that using DDA to flatten the quadratic Bézier arcs
    * is slightly faster in the following cases:
@@ -1066,12 +1138,12 @@ typedef ptrdiff_t  FT_PtrDist;
     p2.y = UPSCALE( to->y );
 
     /* short-cut the arc that crosses the current band */
-    if ( ( TRUNC( p0.y ) >= ras.max_ey &&
-           TRUNC( p1.y ) >= ras.max_ey &&
-           TRUNC( p2.y ) >= ras.max_ey ) ||
-         ( TRUNC( p0.y ) <  ras.min_ey &&
-           TRUNC( p1.y ) <  ras.min_ey &&
-           TRUNC( p2.y ) <  ras.min_ey ) )
+    if ( ( TRUNC( p0.y ) >= ras.cull_max_ey &&
+           TRUNC( p1.y ) >= ras.cull_max_ey &&
+           TRUNC( p2.y ) >= ras.cull_max_ey ) ||
+         ( TRUNC( p0.y ) <  ras.cull_min_ey &&
+           TRUNC( p1.y ) <  ras.cull_min_ey &&
+           TRUNC( p2.y ) <  ras.cull_min_ey ) )
     {
       ras.x = p2.x;
       ras.y = p2.y;
@@ -1090,7 +1162,7 @@ typedef ptrdiff_t  FT_PtrDist;
 
     if ( dx <= ONE_PIXEL / 4 )
     {
-      gray_render_line( RAS_VAR_ p2.x, p2.y );
+      GRAY_RENDER_LINE( p2.x, p2.y );
       return;
     }
 
@@ -1201,7 +1273,7 @@ typedef ptrdiff_t  FT_PtrDist;
 
         _mm_store_si128( &v.vec, p );
 
-        gray_render_line( RAS_VAR_ v.i.px_hi, v.i.py_hi );
+        GRAY_RENDER_LINE( v.i.px_hi, v.i.py_hi );
       }
 
       return;
@@ -1224,8 +1296,7 @@ typedef ptrdiff_t  FT_PtrDist;
       qx += rx;
       qy += ry;
 
-      gray_render_line( RAS_VAR_ (FT_Pos)( px >> 32 ),
-                                 (FT_Pos)( py >> 32 ) );
+      GRAY_RENDER_LINE( (FT_Pos)( px >> 32 ), (FT_Pos)( py >> 32 ) );
     }
   }
 
@@ -1276,12 +1347,12 @@ typedef ptrdiff_t  FT_PtrDist;
     arc[2].y = ras.y;
 
     /* short-cut the arc that crosses the current band */
-    if ( ( TRUNC( arc[0].y ) >= ras.max_ey &&
-           TRUNC( arc[1].y ) >= ras.max_ey &&
-           TRUNC( arc[2].y ) >= ras.max_ey ) ||
-         ( TRUNC( arc[0].y ) <  ras.min_ey &&
-           TRUNC( arc[1].y ) <  ras.min_ey &&
-           TRUNC( arc[2].y ) <  ras.min_ey ) )
+    if ( ( TRUNC( arc[0].y ) >= ras.cull_max_ey &&
+           TRUNC( arc[1].y ) >= ras.cull_max_ey &&
+           TRUNC( arc[2].y ) >= ras.cull_max_ey ) ||
+         ( TRUNC( arc[0].y ) <  ras.cull_min_ey &&
+           TRUNC( arc[1].y ) <  ras.cull_min_ey &&
+           TRUNC( arc[2].y ) <  ras.cull_min_ey ) )
     {
       ras.x = arc[0].x;
       ras.y = arc[0].y;
@@ -1317,7 +1388,7 @@ typedef ptrdiff_t  FT_PtrDist;
         arc += 2;
       }
 
-      gray_render_line( RAS_VAR_ arc[0].x, arc[0].y );
+      GRAY_RENDER_LINE( arc[0].x, arc[0].y );
       arc -= 2;
 
     } while ( --draw );
@@ -1385,14 +1456,14 @@ typedef ptrdiff_t  FT_PtrDist;
     arc[3].y = ras.y;
 
     /* short-cut the arc that crosses the current band */
-    if ( ( TRUNC( arc[0].y ) >= ras.max_ey &&
-           TRUNC( arc[1].y ) >= ras.max_ey &&
-           TRUNC( arc[2].y ) >= ras.max_ey &&
-           TRUNC( arc[3].y ) >= ras.max_ey ) ||
-         ( TRUNC( arc[0].y ) <  ras.min_ey &&
-           TRUNC( arc[1].y ) <  ras.min_ey &&
-           TRUNC( arc[2].y ) <  ras.min_ey &&
-           TRUNC( arc[3].y ) <  ras.min_ey ) )
+    if ( ( TRUNC( arc[0].y ) >= ras.cull_max_ey &&
+           TRUNC( arc[1].y ) >= ras.cull_max_ey &&
+           TRUNC( arc[2].y ) >= ras.cull_max_ey &&
+           TRUNC( arc[3].y ) >= ras.cull_max_ey ) ||
+         ( TRUNC( arc[0].y ) <  ras.cull_min_ey &&
+           TRUNC( arc[1].y ) <  ras.cull_min_ey &&
+           TRUNC( arc[2].y ) <  ras.cull_min_ey &&
+           TRUNC( arc[3].y ) <  ras.cull_min_ey ) )
     {
       ras.x = arc[0].x;
       ras.y = arc[0].y;
@@ -1410,7 +1481,7 @@ typedef ptrdiff_t  FT_PtrDist;
            FT_ABS( arc[0].y - 3 * arc[2].y + 2 * arc[3].y ) > ONE_PIXEL / 2 )
         goto Split;
 
-      gray_render_line( RAS_VAR_ arc[0].x, arc[0].y );
+      GRAY_RENDER_LINE( arc[0].x, arc[0].y );
 
       if ( arc == bez_stack )
         return;
@@ -1436,7 +1507,23 @@ typedef ptrdiff_t  FT_PtrDist;
     x = UPSCALE( to->x );
     y = UPSCALE( to->y );
 
-    gray_set_cell( RAS_VAR_ TRUNC( x ), TRUNC( y ) );
+    if ( ras.lcd_shared )
+    {
+      int  c;
+
+
+      for ( c = 0; c < 3; c++ )
+      {
+        ras.ycells = ras.lcd_ycells + c * ras.count_ey;
+
+        gray_set_cell( RAS_VAR_ TRUNC( x + ras.lcd_dx[c] ),
+                                TRUNC( y + ras.lcd_dy[c] ) );
+
+        ras.lcd_cell[c] = ras.cell;
+      }
+    }
+    else
+      gray_set_cell( RAS_VAR_ TRUNC( x ), TRUNC( y ) );
 
     ras.x = x;
     ras.y = y;
@@ -1448,7 +1535,7 @@ typedef ptrdiff_t  FT_PtrDist;
   gray_line_to( const FT_Vector*  to,
                 gray_PWorker      worker )
   {
-    gray_render_line( RAS_VAR_ UPSCALE( to->x ), UPSCALE( to->y ) );
+    GRAY_RENDER_LINE( UPSCALE( to->x ), UPSCALE( to->y ) );
     return 0;
   }
 
@@ -1492,6 +1579,13 @@ typedef ptrdiff_t  FT_PtrDist;
       unsigned char*  line = ras.target.origin - ras.target.pitch * y;
 
 
+      /* only the leading cell can be clipped at `min_ex - 1' */
+      if ( cell->x < ras.min_ex )
+      {
+        cover = (TArea)cell->cover * ( ONE_PIXEL * 2 );
+        cell  = cell->next;
+      }
+
       for ( ; cell != ras.cell_null; cell = cell->next )
       {
         TArea  area;
@@ -1506,7 +1600,7 @@ typedef ptrdiff_t  FT_PtrDist;
         cover += (TArea)cell->cover * ( ONE_PIXEL * 2 );
         area   = cover - cell->area;
 
-        if ( area != 0 && cell->x >= ras.min_ex )
+        if ( area != 0 )
         {
           FT_FILL_RULE( coverage, area, fill );
           line[cell->x] = (unsigned char)coverage;
@@ -1543,6 +1637,13 @@ typedef ptrdiff_t  FT_PtrDist;
       TArea   cover = 0;
 
 
+      /* only the leading cell can be clipped at `min_ex - 1' */
+      if ( cell->x < ras.min_ex )
+      {
+        cover = (TArea)cell->cover * ( ONE_PIXEL * 2 );
+        cell  = cell->next;
+      }
+
       for ( ; cell != ras.cell_null; cell = cell->next )
       {
         TArea  area;
@@ -1567,7 +1668,7 @@ typedef ptrdiff_t  FT_PtrDist;
         cover += (TArea)cell->cover * ( ONE_PIXEL * 2 );
         area   = cover - cell->area;
 
-        if ( area != 0 && cell->x >= ras.min_ex )
+        if ( area != 0 )
         {
           FT_FILL_RULE( coverage, area, fill );
 
@@ -1607,6 +1708,71 @@ typedef ptrdiff_t  FT_PtrDist;
   }
 
 
+  static void
+  gray_sweep_lcd( RAS_ARG )
+  {
+    int  fill = ( ras.outline.flags & FT_OUTLINE_EVEN_ODD_FILL ) ? 0x100
+                                                                 : INT_MIN;
+    int  xstep = ras.lcd_xstep;
+    int  coverage;
+    int  y, c;
+
+
+    for ( y = ras.min_ey; y < ras.max_ey; y++ )
+    {
+      unsigned char*  line = ras.target.origin - ras.target.pitch * y;
+
+
+      /* each channel is written to every `xstep' byte */
+      for ( c = 0; c < 3; c++, line += ras.lcd_cstep )
+      {
+        PCell   cell  = ras.lcd_ycells[c * ras.count_ey + y - ras.min_ey];
+        TCoord  x     = ras.min_ex;
+        TArea   cover = 0;
+        TCoord  i;
+
+
+        if ( cell->x < ras.min_ex )
+        {
+          cover = (TArea)cell->cover * ( ONE_PIXEL * 2 );
+          cell  = cell->next;
+        }
+
+        for ( ; cell != ras.cell_null; cell = cell->next )
+        {
+          TArea  area;
+
+
+          if ( cover != 0 && cell->x > x )
+          {
+            FT_FILL_RULE( coverage, cover, fill );
+            for ( i = x; i < cell->x; i++ )
+              line[i * xstep] = (unsigned char)coverage;
+          }
+
+          cover += (TArea)cell->cover * ( ONE_PIXEL * 2 );
+          area   = cover - cell->area;
+
+          if ( area != 0 )
+          {
+            FT_FILL_RULE( coverage, area, fill );
+            line[cell->x * xstep] = (unsigned char)coverage;
+          }
+
+          x = cell->x + 1;
+        }
+
+        if ( cover != 0 )  /* only if cropped */
+        {
+          FT_FILL_RULE( coverage, cover, fill );
+          for ( i = x; i < ras.max_ex; i++ )
+            line[i * xstep] = (unsigned char)coverage;
+        }
+      }
+    }
+  }
+
+
 #ifdef STANDALONE_
 
   /**************************************************************************
@@ -1908,6 +2074,69 @@ typedef ptrdiff_t  FT_PtrDist;
   )
 
 
+  /* Shift the outline points in place so that the total shift */
+  /* applied to the source outline becomes `(dx,dy)'.            */
+  static void
+  gray_lcd_shift( RAS_ARG_ TPos  dx,
+                           TPos  dy )
+  {
+    FT_Vector*  vec   = ras.outline.points;
+    FT_Vector*  limit = vec + ras.outline.n_points;
+
+
+    dx -= ras.lcd_delta.x;
+    dy -= ras.lcd_delta.y;
+
+    if ( !dx && !dy )
+      return;
+
+    for ( ; vec < limit; vec++ )
+    {
+      vec->x += dx;
+      vec->y += dy;
+    }
+
+    ras.lcd_delta.x += dx;
+    ras.lcd_delta.y += dy;
+  }
+
+
+  /* Decompose the outline for all LCD channels.  Unless the outline */
+  /* can be shared, each channel is decomposed separately after      */
+  /* shifting the outline points.                                    */
+  static int
+  gray_decompose_lcd( RAS_ARG )
+  {
+    int  error = 0;
+    int  c;
+
+
+    if ( ras.lcd_shared )
+    {
+      for ( c = 0; c < 3; c++ )
+        ras.lcd_cell[c] = ras.cell_null;
+
+      return FT_Outline_Decompose( &ras.outline, &func_interface, &ras );
+    }
+
+    for ( c = 0; c < 3; c++ )
+    {
+      gray_lcd_shift( RAS_VAR_ ras.lcd_shift[c].x, ras.lcd_shift[c].y );
+
+      ras.ycells = ras.lcd_ycells + c * ras.count_ey;
+      ras.cell   = ras.cell_null;
+
+      error = FT_Outline_Decompose( &ras.outline, &func_interface, &ras );
+      if ( error )
+        break;
+    }
+
+    gray_lcd_shift( RAS_VAR_ 0, 0 );
+
+    return error;
+  }
+
+
   static int
   gray_convert_glyph_inner( RAS_ARG,
                             int  continued )
@@ -1919,7 +2148,10 @@ typedef ptrdiff_t  FT_PtrDist;
     {
       if ( continued )
         FT_Trace_Disable();
-      error = FT_Outline_Decompose( &ras.outline, &func_interface, &ras );
+      if ( ras.lcd_shift )
+        error = gray_decompose_lcd( RAS_VAR );
+      else
+        error = FT_Outline_Decompose( &ras.outline, &func_interface, &ras );
       if ( continued )
         FT_Trace_Enable();
 
@@ -1935,6 +2167,10 @@ typedef ptrdiff_t  FT_PtrDist;
 
       FT_TRACE7(( "band [%d..%d]: to be bisected\n",
                   ras.min_ey, ras.max_ey ));
+
+      /* undo the outline shift interrupted by the overflow */
+      if ( ras.lcd_shift )
+        gray_lcd_shift( RAS_VAR_ 0, 0 );
     }
 
     return error;
@@ -1942,23 +2178,24 @@ typedef ptrdiff_t  FT_PtrDist;
 
 
   static int
-  gray_convert_glyph( RAS_ARG )
+  gray_convert_glyph( RAS_ARG_ PCell   buffer,
+                               size_t  pool_size )
   {
     const TCoord  yMin = ras.min_ey;
     const TCoord  yMax = ras.max_ey;
 
-    TCell    buffer[FT_MAX_GRAY_POOL];
     size_t   height = (size_t)( yMax - yMin );
-    size_t   n = FT_MAX_GRAY_POOL / 8;
+    size_t   n = pool_size / 8 / (size_t)ras.channels;
     TCoord   y;
     TCoord   bands[32];  /* enough to accommodate bisections */
     TCoord*  band;
 
     int  continued = 0;
+    int  swept     = 0;
 
 
     /* Initialize the null cell at the end of the poll. */
-    ras.cell_null        = buffer + FT_MAX_GRAY_POOL - 1;
+    ras.cell_null        = buffer + pool_size - 1;
     ras.cell_null->x     = CELL_MAX_X_VALUE;
     ras.cell_null->area  = 0;
     ras.cell_null->cover = 0;
@@ -1966,6 +2203,7 @@ typedef ptrdiff_t  FT_PtrDist;
 
     /* set up vertical bands */
     ras.ycells     = (PCell*)buffer;
+    ras.lcd_ycells = ras.ycells;
 
     if ( height > n )
     {
@@ -1991,12 +2229,14 @@ typedef ptrdiff_t  FT_PtrDist;
         int     error;
 
 
-        for ( w = 0; w < width; ++w )
+        /* one set of cell lists per channel */
+        ras.ycells = ras.lcd_ycells;
+        for ( w = 0; w < width * ras.channels; ++w )
           ras.ycells[w] = ras.cell_null;
 
         /* memory management: skip ycells */
-        n = ( (size_t)width * sizeof ( PCell ) + sizeof ( TCell ) - 1 ) /
-              sizeof ( TCell );
+        n = ( (size_t)( width * ras.channels ) * sizeof ( PCell ) +
+              sizeof ( TCell ) - 1 ) / sizeof ( TCell );
 
         ras.cell_free = buffer + n;
         ras.cell      = ras.cell_null;
@@ -2004,6 +2244,14 @@ typedef ptrdiff_t  FT_PtrDist;
         ras.max_ey    = band[0];
         ras.count_ey  = width;
 
+        ras.cull_min_ey = ras.min_ey;
+        ras.cull_max_ey = ras.max_ey;
+        if ( ras.lcd_shared )
+        {
+          ras.cull_min_ey -= ras.lcd_pad;
+          ras.cull_max_ey += ras.lcd_pad;
+        }
+
         error     = gray_convert_glyph_inner( RAS_VAR, continued );
         continued = 1;
 
@@ -2011,14 +2259,25 @@ typedef ptrdiff_t  FT_PtrDist;
         {
           if ( ras.render_span )  /* for FT_RASTER_FLAG_DIRECT only */
             gray_sweep_direct( RAS_VAR );
+          else if ( ras.lcd_shift )
+            gray_sweep_lcd( RAS_VAR );
           else
             gray_sweep( RAS_VAR );
+          ras.bands++;
+          swept = 1;
           band--;
           continue;
         }
         else if ( error != Smooth_Err_Raster_Overflow )
           return error;
 
+        /* let the caller enlarge the pool and start over */
+        /* unless some coverage has been already emitted  */
+        if ( ras.pool_grow && !swept )
+          return error;
+
+        ras.band_splits++;
+
         /* render pool overflow; we will reduce the render band by half */
         width >>= 1;
 
@@ -2039,6 +2298,252 @@ typedef ptrdiff_t  FT_PtrDist;
   }
 
 
+  /* Set up LCD mode; see `FT_GRAY_FLAG_LCD' for details. */
+  static int
+  gray_lcd_setup( RAS_ARG_ const FT_Raster_Params*  params )
+  {
+    const FT_Bitmap*  target_map = params->target;
+    const FT_Vector*  shift      = (const FT_Vector*)params->user;
+
+    FT_Vector*  vec;
+    FT_Vector*  limit;
+    TPos        min_x, min_y, dy;
+    int         c;
+
+
+    if ( !shift )
+      return FT_THROW( Invalid_Argument );
+
+    if ( target_map->pixel_mode == FT_PIXEL_MODE_LCD )
+    {
+      /* three horizontally adjacent bytes per pixel */
+      ras.max_ex    = (TCoord)( target_map->width / 3 );
+      ras.lcd_xstep = 3;
+      ras.lcd_cstep = 1;
+    }
+    else if ( target_map->pixel_mode == FT_PIXEL_MODE_LCD_V )
+    {
+      /* three vertically adjacent bytes per pixel */
+      ras.max_ey    = (TCoord)( target_map->rows / 3 );
+      ras.lcd_xstep = 1;
+      ras.lcd_cstep = target_map->pitch;
+
+      ras.target.pitch *= 3;
+      if ( target_map->pitch > 0 && ras.max_ey > 0 )
+        ras.target.origin = target_map->buffer +
+                              ( ras.max_ey - 1 ) *
+                                (unsigned int)ras.target.pitch;
+    }
+    else
+      return FT_THROW( Invalid_Argument );
+
+    ras.channels    = 3;
+    ras.lcd_shift   = shift;
+    ras.lcd_delta.x = 0;
+    ras.lcd_delta.y = 0;
+
+    /* The outline decomposition rounds conic midpoints towards zero.   */
+    /* It therefore commutes with the channel shifts, and can be shared */
+    /* by all channels, only if no coordinate changes its sign.  This   */
+    /* is always true for the padded bitmaps of the smooth renderer.    */
+    vec   = ras.outline.points;
+    limit = vec + ras.outline.n_points;
+    min_x = vec->x;
+    min_y = vec->y;
+    for ( ; vec < limit; vec++ )
+    {
+      if ( vec->x < min_x )
+        min_x = vec->x;
+      if ( vec->y < min_y )
+        min_y = vec->y;
+    }
+
+    ras.lcd_shared = ( min_x >= 0 && min_y >= 0 );
+    ras.lcd_pad    = 0;
+
+    for ( c = 0; c < 3; c++ )
+    {
+      if ( min_x + shift[c].x < 0 || min_y + shift[c].y < 0 )
+        ras.lcd_shared = 0;
+
+      ras.lcd_dx[c] = UPSCALE( shift[c].x );
+      ras.lcd_dy[c] = UPSCALE( shift[c].y );
+
+      /* how far a shifted arc can reach into the band */
+      dy = FT_ABS( ras.lcd_dy[c] );
+      if ( TRUNC( dy ) + 1 > ras.lcd_pad )
+        ras.lcd_pad = TRUNC( dy ) + 1;
+    }
+
+    return 0;
+  }
+
+
+#ifndef STANDALONE_
+
+  /* Convert the glyph using the heap-allocated cell pool of `raster',   */
+  /* reallocating it within the `cell-pool-budget' limit.  The pool is   */
+  /* sized for a single band and doubled whenever the first band still */
+  /* overflows; bisection is only used after reaching the limit.         */
+  static int
+  gray_convert_pooled( RAS_ARG_ gray_PRaster  raster )
+  {
+    FT_Memory  memory = (FT_Memory)raster->memory;
+    FT_Error   error;
+
+    const TCoord  yMin = ras.min_ey;
+    const TCoord  yMax = ras.max_ey;
+
+    FT_ULong  limit = raster->pool_budget / sizeof ( TCell );
+    FT_ULong  size;
+
+
+    /* `gray_convert_glyph' uses one band if the pool can */
+    /* accommodate eight cells per cell list              */
+    size = 8 * (FT_ULong)( yMax - yMin ) * (FT_ULong)ras.channels;
+    size = FT_MAX( size, FT_MAX_GRAY_POOL * (FT_ULong)ras.channels );
+
+    for (;;)
+    {
+      size = FT_MIN( size, limit );
+
+      if ( raster->pool_size < size )
+      {
+        FT_FREE( raster->pool );
+        raster->pool_size = 0;
+
+        if ( FT_QNEW_ARRAY( raster->pool, size ) )
+          return error;
+
+        raster->pool_size = size;
+        raster->stats.pool_grows++;
+      }
+
+      ras.pool_grow = raster->pool_size < limit;
+      ras.min_ey    = yMin;
+      ras.max_ey    = yMax;
+
+      error = gray_convert_glyph( RAS_VAR_ raster->pool,
+                                  (size_t)raster->pool_size );
+      if ( error != Smooth_Err_Raster_Overflow || !ras.pool_grow )
+        break;
+
+      FT_TRACE7(( "gray_convert_pooled: growing pool beyond %lu cells\n",
+                  raster->pool_size ));
+      size = 2 * raster->pool_size;
+    }
+
+    return error;
+  }
+
+
+#ifndef FT_STATIC_RASTER
+
+  /* minimum height of a band rendered by a parallel job */
+#define GRAY_PARALLEL_MIN_ROWS  64
+
+
+  typedef struct  gray_TJob_
+  {
+    gray_TWorker  worker;
+    PCell         pool;
+    size_t        pool_size;
+    int           error;
+
+  } gray_TJob;
+
+
+  static void
+  gray_parallel_job( void*    job_data,
+                     FT_UInt  index )
+  {
+    gray_TJob*  job = (gray_TJob*)job_data + index;
+
+
+    job->error = gray_convert_glyph( &job->worker,
+                                     job->pool,
+                                     job->pool_size );
+  }
+
+
+  /* Split the target rows into bands and let the client executor */
+  /* convert them concurrently, each band with its own worker and  */
+  /* cell pool.  The outline is only read, and every band writes a */
+  /* disjoint set of rows, so the result equals serial rendering.  */
+  /* Return -1 if the glyph is better rendered serially.           */
+  static int
+  gray_convert_parallel( RAS_ARG_ gray_PRaster  raster )
+  {
+    FT_Memory  memory = (FT_Memory)raster->memory;
+    FT_Error   error;
+
+    TCoord      height = ras.max_ey - ras.min_ey;
+    TCoord      band_height;
+    FT_UInt     count, i;
+    size_t      size;
+    gray_TJob*  jobs = NULL;
+    PCell       pools;
+
+
+    count = (FT_UInt)( height / GRAY_PARALLEL_MIN_ROWS );
+    count = FT_MIN( count, raster->parallel.max_jobs );
+    if ( count < 2 )
+      return -1;
+
+    band_height = ( height + (TCoord)count - 1 ) / (TCoord)count;
+
+    /* room for a single band per job, like `gray_convert_pooled' */
+    size = 8 * (size_t)band_height * (size_t)ras.channels;
+    size = FT_MAX( size, FT_MAX_GRAY_POOL * (size_t)ras.channels );
+
+    /* allocate everything up front; the executor may use any thread */
+    if ( FT_QNEW_ARRAY( jobs, count )           ||
+         FT_QNEW_ARRAY( pools, count * size ) )
+    {
+      FT_FREE( jobs );
+      return error;
+    }
+
+    for ( i = 0; i < count; i++ )
+    {
+      gray_TJob*  job = jobs + i;
+
+
+      job->worker        = ras;
+      job->worker.min_ey = ras.min_ey + (TCoord)i * band_height;
+      job->worker.max_ey = FT_MIN( job->worker.min_ey + band_height,
+                                   ras.max_ey );
+      job->pool          = pools + i * size;
+      job->pool_size     = size;
+      job->error         = 0;
+    }
+
+    raster->parallel.run( raster->parallel.executor_data,
+                          count,
+                          gray_parallel_job,
+                          jobs );
+
+    error = 0;
+    for ( i = 0; i < count; i++ )
+    {
+      if ( !error )
+        error = jobs[i].error;
+
+      ras.bands       += jobs[i].worker.bands;
+      ras.band_splits += jobs[i].worker.band_splits;
+    }
+
+    FT_FREE( pools );
+    FT_FREE( jobs );
+
+    return error;
+  }
+
+#endif /* !FT_STATIC_RASTER */
+
+#endif /* !STANDALONE_ */
+
+
   static int
   gray_raster_render( FT_Raster                raster,
                       const FT_Raster_Params*  params )
@@ -2046,6 +2551,8 @@ typedef ptrdiff_t  FT_PtrDist;
     const FT_Outline*  outline    = (const FT_Outline*)params->source;
     const FT_Bitmap*   target_map = params->target;
 
+    int  error;
+
 #ifndef FT_STATIC_RASTER
     gray_TWorker  worker[1];
 #endif
@@ -2072,7 +2579,10 @@ typedef ptrdiff_t  FT_PtrDist;
            outline->contours[outline->n_contours - 1] + 1 )
       return FT_THROW( Invalid_Outline );
 
-    ras.outline = *outline;
+    ras.outline    = *outline;
+    ras.channels   = 1;
+    ras.lcd_shift  = NULL;
+    ras.lcd_shared = 0;
 
     if ( params->flags & FT_RASTER_FLAG_DIRECT )
     {
@@ -2115,13 +2625,72 @@ typedef ptrdiff_t  FT_PtrDist;
       ras.min_ey = 0;
       ras.max_ex = (FT_Pos)target_map->width;
       ras.max_ey = (FT_Pos)target_map->rows;
+
+      if ( params->flags & FT_GRAY_FLAG_LCD )
+      {
+        error = gray_lcd_setup( RAS_VAR_ params );
+        if ( error )
+          return error;
+      }
     }
 
     /* exit if nothing to do */
     if ( ras.max_ex <= ras.min_ex || ras.max_ey <= ras.min_ey )
       return Smooth_Err_Ok;
 
-    return gray_convert_glyph( RAS_VAR );
+    ras.pool_grow   = 0;
+    ras.bands       = 0;
+    ras.band_splits = 0;
+
+    error = -1;
+
+#if !defined( STANDALONE_ ) && !defined( FT_STATIC_RASTER )
+    /* per-channel outline shifts cannot be shared between threads */
+    if ( ((gray_PRaster)raster)->parallel.run                &&
+         !ras.render_span                                    &&
+         ( !ras.lcd_shift || ras.lcd_shared )                &&
+         ras.max_ey - ras.min_ey >=
+           (TCoord)((gray_PRaster)raster)->parallel.min_rows )
+      error = gray_convert_parallel( RAS_VAR_ (gray_PRaster)raster );
+#endif
+
+    if ( error == -1 )
+    {
+#ifndef STANDALONE_
+      if ( ((gray_PRaster)raster)->pool_budget / sizeof ( TCell ) >
+             FT_MAX_GRAY_POOL * (FT_ULong)ras.channels )
+        error = gray_convert_pooled( RAS_VAR_ (gray_PRaster)raster );
+      else
+#endif
+      if ( ras.lcd_shift )
+      {
+        /* each LCD channel gets a pool of the usual size */
+        TCell  buffer[FT_MAX_GRAY_POOL * 3];
+
+
+        error = gray_convert_glyph( RAS_VAR_ buffer, FT_MAX_GRAY_POOL * 3 );
+      }
+      else
+      {
+        TCell  buffer[FT_MAX_GRAY_POOL];
+
+
+        error = gray_convert_glyph( RAS_VAR_ buffer, FT_MAX_GRAY_POOL );
+      }
+    }
+
+#ifndef STANDALONE_
+    {
+      FT_Prop_CellPoolStats*  stats = &((gray_PRaster)raster)->stats;
+
+
+      stats->renders++;
+      stats->bands       += ras.bands;
+      stats->band_splits += ras.band_splits;
+    }
+#endif
+
+    return error;
   }
 
 
@@ -2178,6 +2747,7 @@ typedef ptrdiff_t  FT_PtrDist;
     FT_Memory  memory = (FT_Memory)((gray_PRaster)raster)->memory;
 
 
+    FT_FREE( ((gray_PRaster)raster)->pool );
     FT_FREE( raster );
   }
 
@@ -2200,12 +2770,58 @@ typedef ptrdiff_t  FT_PtrDist;
                         unsigned long  mode,
                         void*          args )
   {
+#ifndef STANDALONE_
+    gray_PRaster  rast = (gray_PRaster)raster;
+
+
+    switch ( mode )
+    {
+    case FT_GRAY_MODE_SET_POOL_BUDGET:
+      rast->pool_budget = *(FT_ULong*)args;
+
+      /* release a pool that no longer fits */
+      if ( rast->pool_size > rast->pool_budget / sizeof ( TCell ) )
+      {
+        FT_Memory  memory = (FT_Memory)rast->memory;
+
+
+        FT_FREE( rast->pool );
+        rast->pool_size = 0;
+      }
+      break;
+
+    case FT_GRAY_MODE_GET_POOL_BUDGET:
+      *(FT_ULong*)args = rast->pool_budget;
+      break;
+
+    case FT_GRAY_MODE_GET_POOL_STATS:
+      rast->stats.pool_size = rast->pool_size * sizeof ( TCell );
+
+      *(FT_Prop_CellPoolStats*)args = rast->stats;
+      break;
+
+    case FT_GRAY_MODE_RESET_POOL_STATS:
+      FT_ZERO( &rast->stats );
+      break;
+
+    case FT_GRAY_MODE_SET_PARALLEL:
+      rast->parallel = *(FT_Prop_ParallelRaster*)args;
+      break;
+
+    case FT_GRAY_MODE_GET_PARALLEL:
+      *(FT_Prop_ParallelRaster*)args = rast->parallel;
+      break;
+
+    default:
+      break;  /* nothing to do */
+    }
+#else
     FT_UNUSED( raster );
     FT_UNUSED( mode );
     FT_UNUSED( args );
+#endif
 
-
-    return 0; /* nothing to do */
+    return 0;
   }
 
 
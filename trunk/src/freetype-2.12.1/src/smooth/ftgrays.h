@@ -47,6 +47,56 @@
   FT_EXPORT_VAR( const FT_Raster_Funcs )  ft_grays_raster;
 
 
+  /**************************************************************************
+   *
+   * Private extension of `FT_Raster_Params.flags` used by the smooth
+   * renderer to produce all three LCD channels in a single raster call.
+   *
+   * The target must be an @FT_PIXEL_MODE_LCD or @FT_PIXEL_MODE_LCD_V
+   * bitmap, and `params->user` must point to an array of three vectors,
+   * giving the outline shift (in 26.6 format) for each channel.  The
+   * outline is decomposed and flattened once whenever this is exact,
+   * each segment is converted into the cells of every channel, and all
+   * channels are swept into interleaved coverage bytes within the same
+   * band.  Otherwise, the source outline is temporarily shifted in place
+   * for each channel and restored before returning.
+   */
+#define FT_GRAY_FLAG_LCD  0x100
+
+
+  /**************************************************************************
+   *
+   * Mode tags understood by the `raster_set_mode` function of the smooth
+   * raster, used to implement the properties of the smooth renderer.
+   *
+   * FT_GRAY_MODE_SET_POOL_BUDGET ::
+   *   `args` points to an `FT_ULong` giving the maximum size in bytes of
+   *   the heap-allocated cell pool; value~0 disables it.
+   *
+   * FT_GRAY_MODE_GET_POOL_BUDGET ::
+   *   `args` points to an `FT_ULong` receiving the current budget.
+   *
+   * FT_GRAY_MODE_GET_POOL_STATS ::
+   *   `args` points to an @FT_Prop_CellPoolStats structure to fill.
+   *
+   * FT_GRAY_MODE_RESET_POOL_STATS ::
+   *   Reset all counters; `args` is ignored.
+   *
+   * FT_GRAY_MODE_SET_PARALLEL ::
+   *   `args` points to an @FT_Prop_ParallelRaster structure to copy, used
+   *   for the @parallel-raster property.
+   *
+   * FT_GRAY_MODE_GET_PARALLEL ::
+   *   `args` points to an @FT_Prop_ParallelRaster structure to fill.
+   */
+#define FT_GRAY_MODE_SET_POOL_BUDGET   1
+#define FT_GRAY_MODE_GET_POOL_BUDGET   2
+#define FT_GRAY_MODE_GET_POOL_STATS    3
+#define FT_GRAY_MODE_RESET_POOL_STATS  4
+#define FT_GRAY_MODE_SET_PARALLEL      5
+#define FT_GRAY_MODE_GET_PARALLEL      6
+
+
 #ifdef __cplusplus
   }
 #endif
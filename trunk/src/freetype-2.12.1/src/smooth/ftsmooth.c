@@ -19,12 +19,24 @@
 #include <freetype/internal/ftdebug.h>
 #include <freetype/internal/ftobjs.h>
 #include <freetype/ftoutln.h>
+#include <freetype/ftdriver.h>
+#include <freetype/internal/services/svprop.h>
 #include "ftsmooth.h"
 #include "ftgrays.h"
 
 #include "ftsmerrs.h"
 
 
+  /**************************************************************************
+   *
+   * The macro FT_COMPONENT is used in trace mode.  It is an implicit
+   * parameter of the FT_TRACE() and FT_ERROR() macros, used to print/log
+   * messages during execution.
+   */
+#undef  FT_COMPONENT
+#define FT_COMPONENT  smooth
+
+
   /* sets render-specific mode */
   static FT_Error
   ft_smooth_set_mode( FT_Renderer  render,
@@ -37,6 +49,116 @@
                                                          data );
   }
 
+  /* property setter function */
+  static FT_Error
+  ft_smooth_property_set( FT_Module    module,         /* FT_Renderer */
+                          const char*  property_name,
+                          const void*  value,
+                          FT_Bool      value_is_string )
+  {
+    FT_Renderer  render = (FT_Renderer)module;
+
+
+    if ( !ft_strcmp( property_name, "cell-pool-budget" ) )
+    {
+      FT_ULong  budget;
+
+
+#ifdef FT_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+        long         b = ft_strtol( s, NULL, 10 );
+
+
+        if ( b < 0 )
+          return FT_THROW( Invalid_Argument );
+
+        budget = (FT_ULong)b;
+      }
+      else
+#endif
+        budget = *(const FT_ULong*)value;
+
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_SET_POOL_BUDGET,
+                                 &budget );
+    }
+
+    if ( !ft_strcmp( property_name, "cell-pool-stats" ) )
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_RESET_POOL_STATS,
+                                 NULL );
+
+    if ( !ft_strcmp( property_name, "parallel-raster" ) )
+    {
+      if ( value_is_string )
+        return FT_THROW( Invalid_Argument );
+
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_SET_PARALLEL,
+                                 (FT_Pointer)value );
+    }
+
+    FT_TRACE2(( "ft_smooth_property_set: missing property `%s'\n",
+                property_name ));
+    return FT_THROW( Missing_Property );
+  }
+
+
+  /* property getter function */
+  static FT_Error
+  ft_smooth_property_get( FT_Module    module,         /* FT_Renderer */
+                          const char*  property_name,
+                          void*        value )
+  {
+    FT_Renderer  render = (FT_Renderer)module;
+
+
+    if ( !ft_strcmp( property_name, "cell-pool-budget" ) )
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_GET_POOL_BUDGET,
+                                 value );
+
+    if ( !ft_strcmp( property_name, "cell-pool-stats" ) )
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_GET_POOL_STATS,
+                                 value );
+
+    if ( !ft_strcmp( property_name, "parallel-raster" ) )
+      return ft_smooth_set_mode( render,
+                                 FT_GRAY_MODE_GET_PARALLEL,
+                                 value );
+
+    FT_TRACE2(( "ft_smooth_property_get: missing property `%s'\n",
+                property_name ));
+    return FT_THROW( Missing_Property );
+  }
+
+
+  FT_DEFINE_SERVICE_PROPERTIESREC(
+    ft_smooth_service_properties,
+
+    (FT_Properties_SetFunc)ft_smooth_property_set,     /* set_property */
+    (FT_Properties_GetFunc)ft_smooth_property_get )    /* get_property */
+
+
+  FT_DEFINE_SERVICEDESCREC1(
+    ft_smooth_services,
+
+    FT_SERVICE_ID_PROPERTIES, &ft_smooth_service_properties )
+
+
+  static FT_Module_Interface
+  ft_smooth_requester( FT_Renderer  render,
+                       const char*  module_interface )
+  {
+    FT_UNUSED( render );
+
+    return ft_service_list_lookup( ft_smooth_services, module_interface );
+  }
+
+
   /* transform a given glyph image */
   static FT_Error
   ft_smooth_transform( FT_Renderer       render,
@@ -109,88 +231,33 @@
   }
 
 
-  /* This function writes every third byte in direct rendering mode */
-  static void
-  ft_smooth_lcd_spans( int             y,
-                       int             count,
-                       const FT_Span*  spans,
-                       TOrigin*        target )
-  {
-    unsigned char*  dst_line = target->origin - y * target->pitch;
-    unsigned char*  dst;
-    unsigned short  w;
-
-
-    for ( ; count--; spans++ )
-      for ( dst = dst_line + spans->x * 3, w = spans->len; w--; dst += 3 )
-        *dst = spans->coverage;
-  }
-
-
   static FT_Error
   ft_smooth_raster_lcd( FT_Renderer  render,
                         FT_Outline*  outline,
                         FT_Bitmap*   bitmap )
   {
-    FT_Error      error = FT_Err_Ok;
-    FT_Vector*    sub   = render->root.library->lcd_geometry;
-    FT_Pos        x, y;
-
-    FT_Raster_Params   params;
-    TOrigin            target;
-
-
-    /* Render 3 separate coverage bitmaps, shifting the outline.  */
-    /* Set up direct rendering to record them on each third byte. */
-    params.source     = outline;
-    params.flags      = FT_RASTER_FLAG_AA | FT_RASTER_FLAG_DIRECT;
-    params.gray_spans = (FT_SpanFunc)ft_smooth_lcd_spans;
-    params.user       = &target;
-
-    params.clip_box.xMin = 0;
-    params.clip_box.yMin = 0;
-    params.clip_box.xMax = bitmap->width;
-    params.clip_box.yMax = bitmap->rows;
-
-    if ( bitmap->pitch < 0 )
-      target.origin = bitmap->buffer;
-    else
-      target.origin = bitmap->buffer
-                      + ( bitmap->rows - 1 ) * (unsigned int)bitmap->pitch;
-
-    target.pitch = bitmap->pitch;
+    FT_Vector*  sub = render->root.library->lcd_geometry;
+    FT_Vector   shift[3];
 
-    FT_Outline_Translate( outline,
-                          -sub[0].x,
-                          -sub[0].y );
-    error = render->raster_render( render->raster, &params );
-    x = sub[0].x;
-    y = sub[0].y;
-    if ( error )
-      goto Exit;
+    FT_Raster_Params  params;
 
-    target.origin++;
-    FT_Outline_Translate( outline,
-                          sub[0].x - sub[1].x,
-                          sub[0].y - sub[1].y );
-    error = render->raster_render( render->raster, &params );
-    x = sub[1].x;
-    y = sub[1].y;
-    if ( error )
-      goto Exit;
 
-    target.origin++;
-    FT_Outline_Translate( outline,
-                          sub[1].x - sub[2].x,
-                          sub[1].y - sub[2].y );
-    error = render->raster_render( render->raster, &params );
-    x = sub[2].x;
-    y = sub[2].y;
+    /* Render 3 coverage channels in a single raster pass, shifting */
+    /* the outline for each of them.  The raster records them on    */
+    /* each third byte.                                             */
+    shift[0].x = -sub[0].x;
+    shift[0].y = -sub[0].y;
+    shift[1].x = -sub[1].x;
+    shift[1].y = -sub[1].y;
+    shift[2].x = -sub[2].x;
+    shift[2].y = -sub[2].y;
 
-  Exit:
-    FT_Outline_Translate( outline, x, y );
+    params.target = bitmap;
+    params.source = outline;
+    params.flags  = FT_RASTER_FLAG_AA | FT_GRAY_FLAG_LCD;
+    params.user   = shift;
 
-    return error;
+    return render->raster_render( render->raster, &params );
   }
 
 
@@ -199,60 +266,29 @@
                          FT_Outline*  outline,
                          FT_Bitmap*   bitmap )
   {
-    FT_Error     error = FT_Err_Ok;
-    int          pitch = bitmap->pitch;
-    FT_Vector*   sub   = render->root.library->lcd_geometry;
-    FT_Pos       x, y;
+    FT_Vector*  sub = render->root.library->lcd_geometry;
+    FT_Vector   shift[3];
 
     FT_Raster_Params  params;
 
 
+    /* Render 3 coverage channels in a single raster pass, shifting */
+    /* the outline for each of them.  Notice that the subpixel      */
+    /* geometry vectors are rotated.  The raster records them on    */
+    /* each third row.                                              */
+    shift[0].x = -sub[0].y;
+    shift[0].y =  sub[0].x;
+    shift[1].x = -sub[1].y;
+    shift[1].y =  sub[1].x;
+    shift[2].x = -sub[2].y;
+    shift[2].y =  sub[2].x;
+
     params.target = bitmap;
     params.source = outline;
-    params.flags  = FT_RASTER_FLAG_AA;
-
-    /* Render 3 separate coverage bitmaps, shifting the outline. */
-    /* Notice that the subpixel geometry vectors are rotated.    */
-    /* Triple the pitch to render on each third row.            */
-    bitmap->pitch *= 3;
-    bitmap->rows  /= 3;
+    params.flags  = FT_RASTER_FLAG_AA | FT_GRAY_FLAG_LCD;
+    params.user   = shift;
 
-    FT_Outline_Translate( outline,
-                          -sub[0].y,
-                          sub[0].x );
-    error = render->raster_render( render->raster, &params );
-    x = sub[0].y;
-    y = -sub[0].x;
-    if ( error )
-      goto Exit;
-
-    bitmap->buffer += pitch;
-    FT_Outline_Translate( outline,
-                          sub[0].y - sub[1].y,
-                          sub[1].x - sub[0].x );
-    error = render->raster_render( render->raster, &params );
-    x = sub[1].y;
-    y = -sub[1].x;
-    bitmap->buffer -= pitch;
-    if ( error )
-      goto Exit;
-
-    bitmap->buffer += 2 * pitch;
-    FT_Outline_Translate( outline,
-                          sub[1].y - sub[2].y,
-                          sub[2].x - sub[1].x );
-    error = render->raster_render( render->raster, &params );
-    x = sub[2].y;
-    y = -sub[2].x;
-    bitmap->buffer -= 2 * pitch;
-
-  Exit:
-    FT_Outline_Translate( outline, x, y );
-
-    bitmap->pitch /= 3;
-    bitmap->rows  *= 3;
-
-    return error;
+    return render->raster_render( render->raster, &params );
   }
 
 #else   /* FT_CONFIG_OPTION_SUBPIXEL_RENDERING */
@@ -580,9 +616,9 @@
 
       NULL,    /* module specific interface */
 
-      (FT_Module_Constructor)ft_smooth_init,  /* module_init   */
-      (FT_Module_Destructor) NULL,            /* module_done   */
-      (FT_Module_Requester)  NULL,            /* get_interface */
+      (FT_Module_Constructor)ft_smooth_init,       /* module_init   */
+      (FT_Module_Destructor) NULL,                 /* module_done   */
+      (FT_Module_Requester)  ft_smooth_requester,  /* get_interface */
 
     FT_GLYPH_FORMAT_OUTLINE,
 
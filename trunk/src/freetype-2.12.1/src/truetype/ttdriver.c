@@ -108,6 +108,50 @@
       return error;
     }
 
+    if ( !ft_strcmp( property_name, "hinted-cache-size" ) )
+    {
+#ifdef FT_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+        long         size;
+
+
+        size = ft_strtol( s, NULL, 10 );
+        if ( size < 0 )
+          return FT_THROW( Invalid_Argument );
+
+        driver->hinted_cache_size = (FT_ULong)size;
+      }
+      else
+#endif
+      {
+        FT_ULong*  cache_size = (FT_ULong*)value;
+
+
+        driver->hinted_cache_size = *cache_size;
+      }
+
+      return error;
+    }
+
+    if ( !ft_strcmp( property_name, "interpreter-profiling" ) )
+    {
+      if ( value_is_string )
+        return FT_THROW( Invalid_Argument );
+
+      return tt_driver_set_profiling(
+               driver,
+               (const FT_Prop_InterpreterProfiling*)value );
+    }
+
+    if ( !ft_strcmp( property_name, "interpreter-profile" ) )
+    {
+      tt_driver_reset_profile( driver );
+
+      return error;
+    }
+
     FT_TRACE2(( "tt_property_set: missing property `%s'\n",
                 property_name ));
     return FT_THROW( Missing_Property );
@@ -135,6 +179,46 @@
       return error;
     }
 
+    if ( !ft_strcmp( property_name, "hinted-cache-size" ) )
+    {
+      FT_ULong*  val = (FT_ULong*)value;
+
+
+      *val = driver->hinted_cache_size;
+
+      return error;
+    }
+
+    if ( !ft_strcmp( property_name, "interpreter-profiling" ) )
+    {
+      FT_Prop_InterpreterProfiling*  val =
+                                       (FT_Prop_InterpreterProfiling*)value;
+
+
+      val->enable     = driver->profile != NULL;
+      val->clock      = driver->profile ? driver->profile->clock : NULL;
+      val->clock_data = driver->profile ? driver->profile->clock_data
+                                        : NULL;
+
+      return error;
+    }
+
+    if ( !ft_strcmp( property_name, "interpreter-profile" ) )
+    {
+      FT_Prop_InterpreterProfile*  val = (FT_Prop_InterpreterProfile*)value;
+
+
+      if ( driver->profile )
+      {
+        *val                 = driver->profile->data;
+        val->function_counts = driver->profile->function_counts;
+      }
+      else
+        FT_ZERO( val );
+
+      return error;
+    }
+
     FT_TRACE2(( "tt_property_get: missing property `%s'\n",
                 property_name ));
     return FT_THROW( Missing_Property );
@@ -455,6 +539,10 @@
 #endif
       return FT_THROW( Invalid_Argument );
 
+    /* glyph data hasn't been set up for a metadata-only face */
+    if ( ( (TT_Face)face )->metadata_only )
+      return FT_THROW( Invalid_Argument );
+
     if ( load_flags & FT_LOAD_NO_HINTING )
     {
       /* both FT_LOAD_NO_HINTING and FT_LOAD_NO_AUTOHINT   */
@@ -2778,6 +2778,405 @@
   }
 
 
+#ifdef TT_USE_BYTECODE_INTERPRETER
+
+  /**************************************************************************
+   *
+   * HINTED OUTLINE CACHE
+   *
+   * If the `hinted-cache-size` property is set, each size object keeps the
+   * hinted outlines and metrics returned by `TT_Load_Glyph`, so that
+   * loading a glyph again doesn't run its bytecode again.  A node is
+   * identified by the glyph index, the load flags, the interpreter version,
+   * and the variation instance; the size is implied.  Switching between
+   * variation instances thus keeps the nodes of all instances, even though
+   * `prep` has to be run again.  All nodes of a size are discarded when
+   * its scale changes.
+   *
+   * The point, contour, and tag arrays are stored right after the node in
+   * the same memory block.
+   */
+
+  /* load flags that don't change the result of `TT_Load_Glyph' */
+#define TT_HINTED_IGNORED_FLAGS  ( FT_LOAD_RENDER         | \
+                                   FT_LOAD_LINEAR_DESIGN  | \
+                                   FT_LOAD_NO_AUTOHINT    )
+
+#define TT_HINTED_MIN_BUCKETS  64
+
+
+  typedef struct  TT_HintedNodeRec_
+  {
+    TT_HintedNode     link;         /* next node in hash bucket */
+    TT_HintedNode     prev;         /* next more recently used  */
+    TT_HintedNode     next;         /* next less recently used  */
+    FT_Offset         node_size;
+
+    FT_UInt           glyph_index;
+    FT_Int32          load_flags;
+    FT_UInt           interpreter_version;
+    FT_ULong          instance;
+
+    FT_Glyph_Metrics  metrics;
+    FT_Fixed          linear_hori_advance;
+    FT_Fixed          linear_vert_advance;
+
+    FT_Outline        outline;
+
+  } TT_HintedNodeRec;
+
+
+  static FT_UInt
+  tt_hinted_hash( FT_UInt   glyph_index,
+                  FT_Int32  load_flags )
+  {
+    return glyph_index ^ ( (FT_UInt32)load_flags * 0x9E3779B1UL >> 16 );
+  }
+
+
+  static void
+  tt_hinted_unlink( TT_HintedCacheRec*  cache,
+                    TT_HintedNode       node )
+  {
+    if ( node->prev )
+      node->prev->next = node->next;
+    else
+      cache->head = node->next;
+
+    if ( node->next )
+      node->next->prev = node->prev;
+    else
+      cache->tail = node->prev;
+
+    node->prev = NULL;
+    node->next = NULL;
+  }
+
+
+  static void
+  tt_hinted_push( TT_HintedCacheRec*  cache,
+                  TT_HintedNode       node )
+  {
+    node->prev = NULL;
+    node->next = cache->head;
+
+    if ( cache->head )
+      cache->head->prev = node;
+    else
+      cache->tail = node;
+
+    cache->head = node;
+  }
+
+
+  static void
+  tt_hinted_remove( TT_HintedCacheRec*  cache,
+                    TT_HintedNode       node,
+                    FT_Memory           memory )
+  {
+    TT_HintedNode*  pnode;
+
+
+    pnode = cache->buckets +
+              ( tt_hinted_hash( node->glyph_index, node->load_flags ) &
+                ( cache->num_buckets - 1 ) );
+
+    while ( *pnode != node )
+      pnode = &(*pnode)->link;
+
+    *pnode = node->link;
+
+    tt_hinted_unlink( cache, node );
+
+    cache->num_nodes--;
+    cache->num_bytes -= node->node_size;
+
+    FT_FREE( node );
+  }
+
+
+  /* documentation is in ttgload.h */
+
+  FT_LOCAL_DEF( void )
+  TT_Done_Hinted_Cache( TT_Size  size )
+  {
+    TT_HintedCacheRec*  cache  = &size->hinted;
+    FT_Memory           memory = size->root.face->memory;
+    TT_HintedNode       node;
+
+
+    node = cache->head;
+    while ( node )
+    {
+      TT_HintedNode  next = node->next;
+
+
+      FT_FREE( node );
+      node = next;
+    }
+
+    FT_FREE( cache->buckets );
+
+    cache->num_buckets = 0;
+    cache->num_nodes   = 0;
+    cache->num_bytes   = 0;
+    cache->head        = NULL;
+    cache->tail        = NULL;
+  }
+
+
+  /* Check whether hinted outlines loaded with `load_flags' can be */
+  /* cached at all.                                                */
+  static FT_Bool
+  tt_hinted_cache_usable( TT_Size   size,
+                          FT_Int32  load_flags )
+  {
+    TT_Face    face   = (TT_Face)size->root.face;
+    TT_Driver  driver = (TT_Driver)FT_FACE_DRIVER( face );
+
+
+    if ( !driver->hinted_cache_size                ||
+         !IS_HINTED( load_flags )                  ||
+         load_flags & ( FT_LOAD_NO_SCALE      |
+                        FT_LOAD_NO_RECURSE    |
+                        FT_LOAD_ADVANCE_ONLY  ) )
+      return FALSE;
+
+#ifdef FT_CONFIG_OPTION_INCREMENTAL
+    if ( face->root.internal->incremental_interface )
+      return FALSE;
+#endif
+
+    /* don't cache anything while `fpgm' or `prep' fail */
+    if ( size->bytecode_ready > 0 || size->cvt_ready > 0 )
+      return FALSE;
+
+    /* everything cached so far is stale if the scale has changed; */
+    /* nodes of other variation instances simply don't match       */
+    if ( size->hinted.num_nodes                                     &&
+         ( size->hinted.x_scale != size->hinted_metrics.x_scale ||
+           size->hinted.y_scale != size->hinted_metrics.y_scale ||
+           size->hinted.x_ppem  != size->hinted_metrics.x_ppem  ||
+           size->hinted.y_ppem  != size->hinted_metrics.y_ppem  ) )
+      TT_Done_Hinted_Cache( size );
+
+    return TRUE;
+  }
+
+
+  static TT_HintedNode
+  tt_hinted_cache_find( TT_Size   size,
+                        FT_UInt   glyph_index,
+                        FT_Int32  load_flags )
+  {
+    TT_HintedCacheRec*  cache  = &size->hinted;
+    TT_Face             face   = (TT_Face)size->root.face;
+    TT_Driver           driver = (TT_Driver)FT_FACE_DRIVER( face );
+    FT_ULong            instance;
+    TT_HintedNode       node;
+
+
+    if ( !cache->num_nodes )
+      return NULL;
+
+    instance = tt_face_get_instance_id( face );
+
+    node = cache->buckets[tt_hinted_hash( glyph_index, load_flags ) &
+                          ( cache->num_buckets - 1 )];
+
+    for ( ; node; node = node->link )
+    {
+      if ( node->glyph_index         == glyph_index                 &&
+           node->load_flags          == load_flags                  &&
+           node->interpreter_version == driver->interpreter_version &&
+           node->instance            == instance                    )
+        return node;
+    }
+
+    return NULL;
+  }
+
+
+  /* Copy a cached outline into `glyph', as `TT_Load_Glyph' would. */
+  static FT_Error
+  tt_hinted_cache_load( TT_Size        size,
+                        TT_GlyphSlot   glyph,
+                        TT_HintedNode  node )
+  {
+    FT_GlyphLoader  gloader = glyph->internal->loader;
+    FT_Outline*     source  = &node->outline;
+    FT_Outline*     target;
+    FT_Error        error;
+
+
+    FT_GlyphLoader_Rewind( gloader );
+
+    error = FT_GLYPHLOADER_CHECK_POINTS( gloader,
+                                         source->n_points,
+                                         source->n_contours );
+    if ( error )
+      return error;
+
+    target = &gloader->current.outline;
+
+    FT_ARRAY_COPY( target->points, source->points, source->n_points );
+    FT_ARRAY_COPY( target->tags, source->tags, source->n_points );
+    FT_ARRAY_COPY( target->contours, source->contours, source->n_contours );
+
+    target->n_points   = source->n_points;
+    target->n_contours = source->n_contours;
+
+    FT_GlyphLoader_Add( gloader );
+
+    glyph->format        = FT_GLYPH_FORMAT_OUTLINE;
+    glyph->num_subglyphs = 0;
+    glyph->control_data  = NULL;
+    glyph->control_len   = 0;
+
+    glyph->outline       = gloader->base.outline;
+    glyph->outline.flags = source->flags;
+
+    glyph->metrics           = node->metrics;
+    glyph->linearHoriAdvance = node->linear_hori_advance;
+    glyph->linearVertAdvance = node->linear_vert_advance;
+
+    /* move to front */
+    tt_hinted_unlink( &size->hinted, node );
+    tt_hinted_push( &size->hinted, node );
+
+    return FT_Err_Ok;
+  }
+
+
+  static FT_Error
+  tt_hinted_cache_resize( TT_HintedCacheRec*  cache,
+                          FT_Memory           memory,
+                          FT_UInt             num_buckets )
+  {
+    FT_Error        error;
+    TT_HintedNode*  buckets;
+    TT_HintedNode   node;
+
+
+    if ( FT_NEW_ARRAY( buckets, num_buckets ) )
+      return error;
+
+    for ( node = cache->head; node; node = node->next )
+    {
+      TT_HintedNode*  bucket;
+
+
+      bucket = buckets +
+                 ( tt_hinted_hash( node->glyph_index, node->load_flags ) &
+                   ( num_buckets - 1 ) );
+
+      node->link = *bucket;
+      *bucket    = node;
+    }
+
+    FT_FREE( cache->buckets );
+
+    cache->buckets     = buckets;
+    cache->num_buckets = num_buckets;
+
+    return FT_Err_Ok;
+  }
+
+
+  /* Store the hinted outline in `glyph'.  Errors are ignored; */
+  /* the glyph simply doesn't get cached then.                 */
+  static void
+  tt_hinted_cache_add( TT_Size       size,
+                       TT_GlyphSlot  glyph,
+                       FT_UInt       glyph_index,
+                       FT_Int32      load_flags )
+  {
+    TT_HintedCacheRec*  cache   = &size->hinted;
+    TT_Face             face    = (TT_Face)size->root.face;
+    TT_Driver           driver  = (TT_Driver)FT_FACE_DRIVER( face );
+    FT_Memory           memory  = face->root.memory;
+    FT_Outline*         outline = &glyph->outline;
+
+    FT_Error        error;
+    FT_Offset       node_size;
+    TT_HintedNode   node;
+    TT_HintedNode*  bucket;
+
+
+    if ( glyph->format != FT_GLYPH_FORMAT_OUTLINE )
+      return;
+
+    node_size = sizeof ( TT_HintedNodeRec )                         +
+                (FT_Offset)outline->n_points * sizeof ( FT_Vector ) +
+                (FT_Offset)outline->n_contours * sizeof ( short )   +
+                (FT_Offset)outline->n_points;
+
+    if ( node_size > driver->hinted_cache_size )
+      return;
+
+    /* discard the least recently used outlines */
+    while ( cache->tail                                              &&
+            cache->num_bytes + node_size > driver->hinted_cache_size )
+      tt_hinted_remove( cache, cache->tail, memory );
+
+    if ( cache->num_nodes >= cache->num_buckets )
+    {
+      if ( tt_hinted_cache_resize( cache,
+                                   memory,
+                                   cache->num_buckets
+                                     ? 2 * cache->num_buckets
+                                     : TT_HINTED_MIN_BUCKETS ) )
+        return;
+    }
+
+    if ( FT_ALLOC( node, node_size ) )
+      return;
+
+    node->node_size           = node_size;
+    node->glyph_index         = glyph_index;
+    node->load_flags          = load_flags;
+    node->interpreter_version = driver->interpreter_version;
+    node->instance            = tt_face_get_instance_id( face );
+
+    node->metrics             = glyph->metrics;
+    node->linear_hori_advance = glyph->linearHoriAdvance;
+    node->linear_vert_advance = glyph->linearVertAdvance;
+
+    node->outline          = *outline;
+    node->outline.points   = (FT_Vector*)( node + 1 );
+    node->outline.contours = (short*)( node->outline.points +
+                                       outline->n_points );
+    node->outline.tags     = (char*)( node->outline.contours +
+                                      outline->n_contours );
+
+    FT_ARRAY_COPY( node->outline.points, outline->points,
+                   outline->n_points );
+    FT_ARRAY_COPY( node->outline.contours, outline->contours,
+                   outline->n_contours );
+    FT_ARRAY_COPY( node->outline.tags, outline->tags,
+                   outline->n_points );
+
+    bucket = cache->buckets +
+               ( tt_hinted_hash( glyph_index, load_flags ) &
+                 ( cache->num_buckets - 1 ) );
+
+    node->link = *bucket;
+    *bucket    = node;
+
+    tt_hinted_push( cache, node );
+
+    cache->num_nodes++;
+    cache->num_bytes += node_size;
+
+    cache->x_scale = size->hinted_metrics.x_scale;
+    cache->y_scale = size->hinted_metrics.y_scale;
+    cache->x_ppem  = size->hinted_metrics.x_ppem;
+    cache->y_ppem  = size->hinted_metrics.y_ppem;
+  }
+
+#endif /* TT_USE_BYTECODE_INTERPRETER */
+
+
   /**************************************************************************
    *
    * @Function:
@@ -2818,6 +3217,9 @@
   {
     FT_Error      error;
     TT_LoaderRec  loader;
+#ifdef TT_USE_BYTECODE_INTERPRETER
+    FT_Int32      cache_flags;
+#endif
 
 
     FT_TRACE1(( "TT_Load_Glyph: glyph index %d\n", glyph_index ));
@@ -3030,6 +3432,28 @@
 
 #endif /* FT_CONFIG_OPTION_SVG */
 
+#ifdef TT_USE_BYTECODE_INTERPRETER
+
+    /* check for a cached hinted outline */
+    cache_flags = load_flags & ~TT_HINTED_IGNORED_FLAGS;
+
+    if ( tt_hinted_cache_usable( size, load_flags ) )
+    {
+      TT_HintedNode  node;
+
+
+      node = tt_hinted_cache_find( size, glyph_index, cache_flags );
+      if ( node )
+      {
+        FT_TRACE3(( "Using cached hinted outline\n" ));
+
+        error = tt_hinted_cache_load( size, glyph, node );
+        goto Exit;
+      }
+    }
+
+#endif /* TT_USE_BYTECODE_INTERPRETER */
+
     error = tt_loader_init( &loader, size, glyph, load_flags, FALSE );
     if ( error )
       goto Exit;
@@ -3121,6 +3545,11 @@
                 glyph->outline.n_points,
                 glyph->outline.flags ));
 
+#ifdef TT_USE_BYTECODE_INTERPRETER
+    if ( !error && tt_hinted_cache_usable( size, load_flags ) )
+      tt_hinted_cache_add( size, glyph, glyph_index, cache_flags );
+#endif
+
   Done:
     tt_loader_done( &loader );
 
@@ -52,6 +52,11 @@ FT_BEGIN_HEADER
                  FT_UInt       glyph_index,
                  FT_Int32      load_flags );
 
+#ifdef TT_USE_BYTECODE_INTERPRETER
+  FT_LOCAL( void )
+  TT_Done_Hinted_Cache( TT_Size  size );
+#endif
+
 
 FT_END_HEADER
 
@@ -1274,6 +1274,9 @@
     FT_ULong   records_offset;
 
 
+    /* MVAR can modify `gasp' values */
+    (void)TT_FACE_LOAD_LAZY( face, TT_LAZY_TABLE_GASP );
+
     FT_TRACE2(( "MVAR " ));
 
     error = face->goto_table( face, TTAG_MVAR, stream, &table_len );
@@ -1878,6 +1881,216 @@
   }
 
 
+  /* Compute the scaling factors of all shared `gvar' tuples for the */
+  /* current blend.  On allocation failure, `tuplescalars_valid'     */
+  /* stays unset and the factors get computed on the fly.            */
+
+  static void
+  ft_var_compute_tuple_scalars( TT_Face  face )
+  {
+    FT_Memory  memory = face->root.memory;
+    FT_Error   error;
+    GX_Blend   blend  = face->blend;
+    FT_UInt    i;
+
+
+    if ( !blend->tuplescalars                                    &&
+         FT_QNEW_ARRAY( blend->tuplescalars, blend->tuplecount ) )
+      return;
+
+    FT_TRACE6(( "gvar: shared tuple scaling factors:\n" ));
+
+    for ( i = 0; i < blend->tuplecount; i++ )
+      blend->tuplescalars[i] =
+        ft_var_apply_tuple( blend,
+                            0,
+                            blend->tuplecoords + i * blend->num_axis,
+                            NULL,
+                            NULL );
+
+    blend->tuplescalars_valid = TRUE;
+  }
+
+
+  /* Discard all cached glyph deltas and shared tuple scaling factors. */
+  /* To be called whenever the blend coordinates change.               */
+
+  static void
+  ft_var_flush_glyph_deltas( TT_Face  face )
+  {
+    FT_Memory  memory = face->root.memory;
+    GX_Blend   blend  = face->blend;
+    FT_UInt    i;
+
+
+    blend->tuplescalars_valid = FALSE;
+
+    if ( !blend->glyphdeltas_size )
+      return;
+
+    for ( i = 0; i < blend->gv_glyphcnt; i++ )
+      FT_FREE( blend->glyphdeltas[i] );
+
+    blend->glyphdeltas_size = 0;
+  }
+
+
+  /* Free all data of an instance record. */
+
+  static void
+  ft_var_done_instance( TT_Face      face,
+                        GX_Instance  instance )
+  {
+    FT_Memory  memory = face->root.memory;
+    GX_Blend   blend  = face->blend;
+    FT_UInt    i;
+
+
+    if ( instance->glyphdeltas )
+    {
+      for ( i = 0; i < blend->gv_glyphcnt; i++ )
+        FT_FREE( instance->glyphdeltas[i] );
+      FT_FREE( instance->glyphdeltas );
+    }
+
+    FT_FREE( instance->tuplescalars );
+    FT_FREE( instance->cvt );
+    FT_FREE( instance->normalizedcoords );
+
+    FT_ZERO( instance );
+  }
+
+
+  /* Move the cached data of the current coordinates into their */
+  /* instance record (if any) so that it can be reused later on. */
+
+  static void
+  ft_var_leave_instance( TT_Face  face )
+  {
+    GX_Blend     blend    = face->blend;
+    GX_Instance  instance = blend->instance;
+
+
+    if ( !instance )
+    {
+      ft_var_flush_glyph_deltas( face );
+      return;
+    }
+
+    instance->tuplescalars       = blend->tuplescalars;
+    instance->tuplescalars_valid = blend->tuplescalars_valid;
+    instance->glyphdeltas        = blend->glyphdeltas;
+    instance->glyphdeltas_size   = blend->glyphdeltas_size;
+
+    blend->tuplescalars       = NULL;
+    blend->tuplescalars_valid = FALSE;
+    blend->glyphdeltas        = NULL;
+    blend->glyphdeltas_size   = 0;
+
+    blend->instance = NULL;
+  }
+
+
+  /* Make `instance' current, taking over its cached data. */
+
+  static void
+  ft_var_enter_instance( TT_Face      face,
+                         GX_Instance  instance )
+  {
+    FT_Memory  memory = face->root.memory;
+    GX_Blend   blend  = face->blend;
+
+
+    /* already empty arrays left over from coordinates without record */
+    FT_FREE( blend->tuplescalars );
+    FT_FREE( blend->glyphdeltas );
+
+    blend->tuplescalars       = instance->tuplescalars;
+    blend->tuplescalars_valid = instance->tuplescalars_valid;
+    blend->glyphdeltas        = instance->glyphdeltas;
+    blend->glyphdeltas_size   = instance->glyphdeltas_size;
+
+    instance->tuplescalars       = NULL;
+    instance->tuplescalars_valid = FALSE;
+    instance->glyphdeltas        = NULL;
+    instance->glyphdeltas_size   = 0;
+
+    instance->age   = ++blend->instance_stamp;
+    blend->serial   = instance->id;
+    blend->instance = instance;
+  }
+
+
+  /* Find the instance record of the current coordinates. */
+
+  static GX_Instance
+  ft_var_find_instance( TT_Face  face )
+  {
+    GX_Blend     blend    = face->blend;
+    GX_Instance  instance = blend->instances;
+    GX_Instance  limit    = instance + blend->num_instances;
+
+
+    for ( ; instance < limit; instance++ )
+    {
+      if ( instance->normalizedcoords                        &&
+           !ft_memcmp( instance->normalizedcoords,
+                       blend->normalizedcoords,
+                       blend->num_axis * sizeof ( FT_Fixed ) ) )
+        return instance;
+    }
+
+    return NULL;
+  }
+
+
+  /* Create an instance record for the current coordinates, replacing */
+  /* the least recently used one if necessary.  Return NULL on        */
+  /* allocation failure.                                              */
+
+  static GX_Instance
+  ft_var_new_instance( TT_Face  face )
+  {
+    FT_Memory    memory = face->root.memory;
+    FT_Error     error;
+    GX_Blend     blend  = face->blend;
+    GX_Instance  instance;
+
+
+    if ( blend->num_instances < GX_MAX_INSTANCES )
+      instance = blend->instances + blend->num_instances;
+    else
+    {
+      GX_Instance  cur   = blend->instances + 1;
+      GX_Instance  limit = blend->instances + GX_MAX_INSTANCES;
+
+
+      instance = blend->instances;
+      for ( ; cur < limit; cur++ )
+        if ( cur->age < instance->age )
+          instance = cur;
+
+      FT_TRACE5(( "ft_var_new_instance: dropping instance %lu\n",
+                  instance->id ));
+      ft_var_done_instance( face, instance );
+    }
+
+    if ( FT_QNEW_ARRAY( instance->normalizedcoords, blend->num_axis ) )
+      return NULL;
+
+    FT_ARRAY_COPY( instance->normalizedcoords,
+                   blend->normalizedcoords,
+                   blend->num_axis );
+
+    instance->id = ++blend->instance_stamp;
+
+    if ( instance == blend->instances + blend->num_instances )
+      blend->num_instances++;
+
+    return instance;
+  }
+
+
   /* convert from design coordinates to normalized coordinates */
 
   static void
@@ -2587,7 +2800,8 @@
 
     FT_Bool     all_design_coords = FALSE;
 
-    FT_Memory   memory = face->root.memory;
+    FT_Memory    memory   = face->root.memory;
+    GX_Instance  instance = NULL;
 
     enum
     {
@@ -2725,6 +2939,7 @@
     }
 
     blend->num_axis = mmvar->num_axis;
+    ft_var_leave_instance( face );
     if ( coords )
       FT_MEM_COPY( blend->normalizedcoords,
                    coords,
@@ -2738,7 +2953,37 @@
 
     face->doblend = TRUE;
 
-    if ( face->cvt )
+    /* switching back to recently used coordinates is cheap */
+    instance = ft_var_find_instance( face );
+    if ( instance )
+      FT_TRACE5(( "TT_Set_MM_Blend: reusing instance %lu\n", instance->id ));
+    else
+      instance = ft_var_new_instance( face );
+
+    if ( instance )
+      ft_var_enter_instance( face, instance );
+    else
+      blend->serial = ++blend->instance_stamp;
+
+    if ( face->cvt                                &&
+         instance                                 &&
+         instance->cvt                            &&
+         instance->cvt_size == face->cvt_size     )
+    {
+      FT_ARRAY_COPY( face->cvt, instance->cvt, face->cvt_size );
+
+#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
+      {
+        FT_ListNode  node;
+
+
+        /* the sizes must run the `prep' program again */
+        for ( node = face->root.sizes_list.head; node; node = node->next )
+          ( (TT_Size)node->data )->cvt_ready = -1;
+      }
+#endif
+    }
+    else if ( face->cvt )
     {
       switch ( manageCvt )
       {
@@ -2760,6 +3005,21 @@
         /* The cvt table is correct for this set of coordinates. */
         break;
       }
+
+      /* keep a copy for the next switch to this instance; */
+      /* failing to do so is not an error                  */
+      if ( !error && instance && face->cvt )
+      {
+        FT_FREE( instance->cvt );
+
+        if ( !FT_QNEW_ARRAY( instance->cvt, face->cvt_size ) )
+        {
+          FT_ARRAY_COPY( instance->cvt, face->cvt, face->cvt_size );
+          instance->cvt_size = face->cvt_size;
+        }
+        else
+          error = FT_Err_Ok;
+      }
     }
 
     /* enforce recomputation of the PostScript name; */
@@ -3605,203 +3865,101 @@
   }
 
 
-  /* Shift the original coordinates of all points between indices `p1' */
-  /* and `p2', using the same difference as given by index `ref'.      */
-
-  /* modeled after `af_iup_shift' */
+  /* Interpolate points without delta values, similar to */
+  /* the `IUP' hinting instruction but with the `gvar'   */
+  /* handling of ill-defined cases.                      */
 
   static void
-  tt_delta_shift( int         p1,
-                  int         p2,
-                  int         ref,
-                  FT_Vector*  in_points,
-                  FT_Vector*  out_points )
+  tt_interpolate_deltas( FT_Outline*  outline,
+                         FT_Vector*   out_points,
+                         FT_Vector*   in_points,
+                         FT_Bool*     has_delta )
   {
-    int        p;
-    FT_Vector  delta;
-
+    int  i;
 
-    delta.x = out_points[ref].x - in_points[ref].x;
-    delta.y = out_points[ref].y - in_points[ref].y;
 
-    if ( delta.x == 0 && delta.y == 0 )
+    /* ignore empty outlines */
+    if ( outline->n_contours <= 0 )
       return;
 
-    for ( p = p1; p < ref; p++ )
-    {
-      out_points[p].x += delta.x;
-      out_points[p].y += delta.y;
-    }
-
-    for ( p = ref + 1; p <= p2; p++ )
-    {
-      out_points[p].x += delta.x;
-      out_points[p].y += delta.y;
-    }
+    /* handle both horizontal and vertical coordinates */
+    for ( i = 0; i <= 1; i++ )
+      tt_interpolate_untouched( (FT_Vector*)( (FT_Pos*)in_points + i ),
+                                (FT_Vector*)( (FT_Pos*)in_points + i ),
+                                (FT_Vector*)( (FT_Pos*)out_points + i ),
+                                has_delta,
+                                1,
+                                (FT_UInt)outline->n_points,
+                                (const FT_UShort*)outline->contours,
+                                (FT_UInt)outline->n_contours,
+                                0,
+                                TRUE );
   }
 
 
-  /* Interpolate the original coordinates of all points with indices */
-  /* between `p1' and `p2', using `ref1' and `ref2' as the reference */
-  /* point indices.                                                  */
+  /* The point deltas of glyphs are cached for the current blend, up to */
+  /* this number of bytes.  The cache gets emptied by `tt_set_mm_blend'. */
+#define GX_GLYPH_DELTAS_MAX_BYTES  0x40000L
+
 
-  /* modeled after `af_iup_interp', `_iup_worker_interpolate', and   */
-  /* `Ins_IUP' with spec differences in handling ill-defined cases.  */
   static void
-  tt_delta_interpolate( int         p1,
-                        int         p2,
-                        int         ref1,
-                        int         ref2,
-                        FT_Vector*  in_points,
-                        FT_Vector*  out_points )
+  ft_var_apply_point_deltas( FT_Outline*  outline,
+                             FT_Vector*   unrounded,
+                             FT_UInt      n_points,
+                             FT_Fixed*    deltas_x,
+                             FT_Fixed*    deltas_y )
   {
-    int  p, i;
-
-    FT_Pos  out, in1, in2, out1, out2, d1, d2;
+    FT_UInt  i;
 
 
-    if ( p1 > p2 )
-      return;
-
-    /* handle both horizontal and vertical coordinates */
-    for ( i = 0; i <= 1; i++ )
+    for ( i = 0; i < n_points; i++ )
     {
-      /* shift array pointers so that we can access `foo.y' as `foo.x' */
-      in_points  = (FT_Vector*)( (FT_Pos*)in_points + i );
-      out_points = (FT_Vector*)( (FT_Pos*)out_points + i );
-
-      if ( in_points[ref1].x > in_points[ref2].x )
-      {
-        p    = ref1;
-        ref1 = ref2;
-        ref2 = p;
-      }
-
-      in1  = in_points[ref1].x;
-      in2  = in_points[ref2].x;
-      out1 = out_points[ref1].x;
-      out2 = out_points[ref2].x;
-      d1   = out1 - in1;
-      d2   = out2 - in2;
-
-      /* If the reference points have the same coordinate but different */
-      /* delta, inferred delta is zero.  Otherwise interpolate.         */
-      if ( in1 != in2 || out1 == out2 )
-      {
-        FT_Fixed  scale = in1 != in2 ? FT_DivFix( out2 - out1, in2 - in1 )
-                                     : 0;
-
-
-        for ( p = p1; p <= p2; p++ )
-        {
-          out = in_points[p].x;
-
-          if ( out <= in1 )
-            out += d1;
-          else if ( out >= in2 )
-            out += d2;
-          else
-            out = out1 + FT_MulFix( out - in1, scale );
+      unrounded[i].x += FT_fixedToFdot6( deltas_x[i] );
+      unrounded[i].y += FT_fixedToFdot6( deltas_y[i] );
 
-          out_points[p].x = out;
-        }
-      }
+      outline->points[i].x += FT_fixedToInt( deltas_x[i] );
+      outline->points[i].y += FT_fixedToInt( deltas_y[i] );
     }
   }
 
 
-  /* Interpolate points without delta values, similar to */
-  /* the `IUP' hinting instruction.                      */
-
-  /* modeled after `Ins_IUP */
-
   static void
-  tt_interpolate_deltas( FT_Outline*  outline,
-                         FT_Vector*   out_points,
-                         FT_Vector*   in_points,
-                         FT_Bool*     has_delta )
+  ft_var_add_glyph_deltas( TT_Face    face,
+                           FT_UInt    glyph_index,
+                           FT_UInt    n_points,
+                           FT_Fixed*  deltas_x,
+                           FT_Fixed*  deltas_y )
   {
-    FT_Int  first_point;
-    FT_Int  end_point;
-
-    FT_Int  first_delta;
-    FT_Int  cur_delta;
-
-    FT_Int    point;
-    FT_Short  contour;
+    FT_Memory       memory = face->root.memory;
+    FT_Error        error;
+    GX_Blend        blend  = face->blend;
+    GX_GlyphDeltas  node;
+    FT_ULong        size;
 
 
-    /* ignore empty outlines */
-    if ( !outline->n_contours )
+    size = sizeof ( GX_GlyphDeltasRec ) + 2 * n_points * sizeof ( FT_Fixed );
+    if ( blend->glyphdeltas_size + size > GX_GLYPH_DELTAS_MAX_BYTES )
       return;
 
-    contour = 0;
-    point   = 0;
-
-    do
-    {
-      end_point   = outline->contours[contour];
-      first_point = point;
-
-      /* search first point that has a delta */
-      while ( point <= end_point && !has_delta[point] )
-        point++;
+    if ( !blend->glyphdeltas                                    &&
+         FT_NEW_ARRAY( blend->glyphdeltas, blend->gv_glyphcnt ) )
+      return;
 
-      if ( point <= end_point )
-      {
-        first_delta = point;
-        cur_delta   = point;
+    if ( blend->glyphdeltas[glyph_index] )
+      return;
 
-        point++;
+    if ( FT_QALLOC( node, size ) )
+      return;
 
-        while ( point <= end_point )
-        {
-          /* search next point that has a delta  */
-          /* and interpolate intermediate points */
-          if ( has_delta[point] )
-          {
-            tt_delta_interpolate( cur_delta + 1,
-                                  point - 1,
-                                  cur_delta,
-                                  point,
-                                  in_points,
-                                  out_points );
-            cur_delta = point;
-          }
+    node->n_points = n_points;
+    node->deltas_x = (FT_Fixed*)( node + 1 );
+    node->deltas_y = node->deltas_x + n_points;
 
-          point++;
-        }
+    FT_ARRAY_COPY( node->deltas_x, deltas_x, n_points );
+    FT_ARRAY_COPY( node->deltas_y, deltas_y, n_points );
 
-        /* shift contour if we only have a single delta */
-        if ( cur_delta == first_delta )
-          tt_delta_shift( first_point,
-                          end_point,
-                          cur_delta,
-                          in_points,
-                          out_points );
-        else
-        {
-          /* otherwise handle remaining points       */
-          /* at the end and beginning of the contour */
-          tt_delta_interpolate( cur_delta + 1,
-                                end_point,
-                                cur_delta,
-                                first_delta,
-                                in_points,
-                                out_points );
-
-          if ( first_delta > 0 )
-            tt_delta_interpolate( first_point,
-                                  first_delta - 1,
-                                  cur_delta,
-                                  first_delta,
-                                  in_points,
-                                  out_points );
-        }
-      }
-      contour++;
-
-    } while ( contour < outline->n_contours );
+    blend->glyphdeltas[glyph_index]  = node;
+    blend->glyphdeltas_size         += size;
   }
 
 
@@ -3878,6 +4036,8 @@
     FT_Fixed*  point_deltas_x = NULL;
     FT_Fixed*  point_deltas_y = NULL;
 
+    FT_Bool  cacheable = TRUE;
+
 
     if ( !face->doblend || !blend )
       return FT_THROW( Invalid_Argument );
@@ -3897,6 +4057,24 @@
       return FT_Err_Ok;
     }
 
+    if ( blend->glyphdeltas                                &&
+         blend->glyphdeltas[glyph_index]                   &&
+         blend->glyphdeltas[glyph_index]->n_points == n_points )
+    {
+      GX_GlyphDeltas  node = blend->glyphdeltas[glyph_index];
+
+
+      FT_TRACE5(( "gvar: using cached deltas for glyph %d\n",
+                  glyph_index ));
+
+      ft_var_apply_point_deltas( outline,
+                                 unrounded,
+                                 n_points,
+                                 node->deltas_x,
+                                 node->deltas_y );
+      return FT_Err_Ok;
+    }
+
     if ( FT_NEW_ARRAY( points_org, n_points ) ||
          FT_NEW_ARRAY( points_out, n_points ) ||
          FT_NEW_ARRAY( has_delta, n_points )  )
@@ -3963,6 +4141,9 @@
       points_org[j].y = FT_intToFixed( outline->points[j].y );
     }
 
+    if ( !blend->tuplescalars_valid )
+      ft_var_compute_tuple_scalars( face );
+
     for ( i = 0; i < ( tupleCount & GX_TC_TUPLE_COUNT_MASK ); i++ )
     {
       FT_UInt   tupleDataSize;
@@ -4003,11 +4184,16 @@
           im_end_coords[j] = FT_fdot14ToFixed( FT_GET_SHORT() );
       }
 
-      apply = ft_var_apply_tuple( blend,
-                                  (FT_UShort)tupleIndex,
-                                  tuple_coords,
-                                  im_start_coords,
-                                  im_end_coords );
+      if ( !( tupleIndex & ( GX_TI_EMBEDDED_TUPLE_COORD |
+                             GX_TI_INTERMEDIATE_TUPLE   ) ) &&
+           blend->tuplescalars_valid                           )
+        apply = blend->tuplescalars[tupleIndex & GX_TI_TUPLE_INDEX_MASK];
+      else
+        apply = ft_var_apply_tuple( blend,
+                                    (FT_UShort)tupleIndex,
+                                    tuple_coords,
+                                    im_start_coords,
+                                    im_end_coords );
 
       if ( apply == 0 )              /* tuple isn't active for our blend */
       {
@@ -4042,7 +4228,7 @@
                                                            : point_count );
 
       if ( !points || !deltas_y || !deltas_x )
-        ; /* failure, ignore it */
+        cacheable = FALSE; /* failure, ignore it */
 
       else if ( points == ALL_POINTS )
       {
@@ -4232,14 +4418,18 @@
 
     FT_TRACE5(( "\n" ));
 
-    for ( i = 0; i < n_points; i++ )
-    {
-      unrounded[i].x += FT_fixedToFdot6( point_deltas_x[i] );
-      unrounded[i].y += FT_fixedToFdot6( point_deltas_y[i] );
+    ft_var_apply_point_deltas( outline,
+                               unrounded,
+                               n_points,
+                               point_deltas_x,
+                               point_deltas_y );
 
-      outline->points[i].x += FT_fixedToInt( point_deltas_x[i] );
-      outline->points[i].y += FT_fixedToInt( point_deltas_y[i] );
-    }
+    if ( cacheable )
+      ft_var_add_glyph_deltas( face,
+                               glyph_index,
+                               n_points,
+                               point_deltas_x,
+                               point_deltas_y );
 
   Fail3:
     FT_FREE( point_deltas_x );
@@ -4398,6 +4588,13 @@
         FT_FREE( blend->mvar_table );
       }
 
+      ft_var_flush_glyph_deltas( face );
+      FT_FREE( blend->glyphdeltas );
+      FT_FREE( blend->tuplescalars );
+
+      for ( i = 0; i < blend->num_instances; i++ )
+        ft_var_done_instance( face, blend->instances + i );
+
       FT_FREE( blend->tuplecoords );
       FT_FREE( blend->glyphoffsets );
       FT_FREE( blend );
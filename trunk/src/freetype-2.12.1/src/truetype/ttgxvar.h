@@ -208,6 +208,100 @@ FT_BEGIN_HEADER
   } GX_MVarTableRec, *GX_MVarTable;
 
 
+  /**************************************************************************
+   *
+   * @Struct:
+   *   GX_GlyphDeltasRec
+   *
+   * @Description:
+   *   The point deltas of a glyph for the current blend, as computed by
+   *   `TT_Vary_Apply_Glyph_Deltas'.  Both delta arrays follow the
+   *   structure in the same memory block.
+   *
+   * @Fields:
+   *   n_points ::
+   *     The number of points, including the four phantom points.
+   *
+   *   deltas_x ::
+   *     The horizontal deltas in 16.16 format.
+   *
+   *   deltas_y ::
+   *     The vertical deltas in 16.16 format.
+   */
+  typedef struct  GX_GlyphDeltasRec_
+  {
+    FT_UInt    n_points;
+    FT_Fixed*  deltas_x;
+    FT_Fixed*  deltas_y;
+
+  } GX_GlyphDeltasRec, *GX_GlyphDeltas;
+
+
+  /**************************************************************************
+   *
+   * @Struct:
+   *   GX_InstanceRec
+   *
+   * @Description:
+   *   A set of normalized coordinates used recently, together with the
+   *   data derived from it.  If the face switches back to these
+   *   coordinates, the data gets reused instead of being computed again.
+   *
+   *   While an instance is current, its glyph deltas and tuple scaling
+   *   factors live in the @GX_BlendRec fields of the same names, and the
+   *   fields here are empty.
+   *
+   * @Fields:
+   *   id ::
+   *     An identifier, unique for the face; it becomes the `serial' field
+   *     of @GX_BlendRec while the instance is current.
+   *
+   *   age ::
+   *     The value of `instance_stamp' in @GX_BlendRec when the instance
+   *     was used last.  Used to find the least recently used instance.
+   *
+   *   normalizedcoords ::
+   *     The normalized coordinates, one per axis.
+   *
+   *   cvt ::
+   *     A copy of the varied control value table; NULL if not available.
+   *
+   *   cvt_size ::
+   *     The number of elements in `cvt'.
+   *
+   *   tuplescalars ::
+   *     See @GX_BlendRec.
+   *
+   *   tuplescalars_valid ::
+   *     See @GX_BlendRec.
+   *
+   *   glyphdeltas ::
+   *     See @GX_BlendRec.
+   *
+   *   glyphdeltas_size ::
+   *     See @GX_BlendRec.
+   */
+  typedef struct  GX_InstanceRec_
+  {
+    FT_ULong         id;
+    FT_ULong         age;
+    FT_Fixed*        normalizedcoords;
+
+    FT_Int32*        cvt;
+    FT_ULong         cvt_size;
+
+    FT_Fixed*        tuplescalars;
+    FT_Bool          tuplescalars_valid;
+    GX_GlyphDeltas*  glyphdeltas;
+    FT_ULong         glyphdeltas_size;
+
+  } GX_InstanceRec, *GX_Instance;
+
+
+  /* the maximum number of instances kept per face */
+#define GX_MAX_INSTANCES  8
+
+
   /**************************************************************************
    *
    * @Struct:
@@ -296,6 +390,40 @@ FT_BEGIN_HEADER
    *
    *   gvar_size ::
    *     The size of the `gvar' table.
+   *
+   *   serial ::
+   *     An identifier of the current normalized coordinates, unique for
+   *     the face.  If the face switches back to coordinates that are
+   *     still in `instances', their identifier gets reused.
+   *
+   *   tuplescalars ::
+   *     The scaling factors of the shared tuples for the current blend,
+   *     used by all glyphs.  Only valid if `tuplescalars_valid' is set.
+   *
+   *   tuplescalars_valid ::
+   *     A Boolean; if set, `tuplescalars' is up to date.
+   *
+   *   glyphdeltas ::
+   *     An array of `gv_glyphcnt' elements, holding the already computed
+   *     point deltas of glyphs for the current blend.  Emptied whenever
+   *     the blend changes.
+   *
+   *   glyphdeltas_size ::
+   *     The number of bytes used by the elements of `glyphdeltas'.
+   *
+   *   instances ::
+   *     The most recently used sets of normalized coordinates.
+   *
+   *   num_instances ::
+   *     The number of used elements in `instances'.
+   *
+   *   instance ::
+   *     The element of `instances' matching the current coordinates, or
+   *     NULL.
+   *
+   *   instance_stamp ::
+   *     A counter incremented whenever the coordinates change, used for
+   *     the `id' and `age' fields of @GX_InstanceRec.
    */
   typedef struct  GX_BlendRec_
   {
@@ -332,6 +460,19 @@ FT_BEGIN_HEADER
 
     FT_ULong        gvar_size;
 
+    FT_ULong        serial;     /* incremented on each coordinate change */
+
+    FT_Fixed*       tuplescalars;            /* tuplescalars[tuplecount] */
+    FT_Bool         tuplescalars_valid;
+
+    GX_GlyphDeltas* glyphdeltas;             /* glyphdeltas[gv_glyphcnt] */
+    FT_ULong        glyphdeltas_size;
+
+    GX_InstanceRec  instances[GX_MAX_INSTANCES];
+    FT_UInt         num_instances;
+    GX_Instance     instance;
+    FT_ULong        instance_stamp;
+
   } GX_BlendRec;
 
 
@@ -6862,140 +6862,6 @@
   }
 
 
-  /* Local variables for Ins_IUP: */
-  typedef struct  IUP_WorkerRec_
-  {
-    FT_Vector*  orgs;   /* original and current coordinate */
-    FT_Vector*  curs;   /* arrays                          */
-    FT_Vector*  orus;
-    FT_UInt     max_points;
-
-  } IUP_WorkerRec, *IUP_Worker;
-
-
-  static void
-  _iup_worker_shift( IUP_Worker  worker,
-                     FT_UInt     p1,
-                     FT_UInt     p2,
-                     FT_UInt     p )
-  {
-    FT_UInt     i;
-    FT_F26Dot6  dx;
-
-
-    dx = SUB_LONG( worker->curs[p].x, worker->orgs[p].x );
-    if ( dx != 0 )
-    {
-      for ( i = p1; i < p; i++ )
-        worker->curs[i].x = ADD_LONG( worker->curs[i].x, dx );
-
-      for ( i = p + 1; i <= p2; i++ )
-        worker->curs[i].x = ADD_LONG( worker->curs[i].x, dx );
-    }
-  }
-
-
-  static void
-  _iup_worker_interpolate( IUP_Worker  worker,
-                           FT_UInt     p1,
-                           FT_UInt     p2,
-                           FT_UInt     ref1,
-                           FT_UInt     ref2 )
-  {
-    FT_UInt     i;
-    FT_F26Dot6  orus1, orus2, org1, org2, cur1, cur2, delta1, delta2;
-
-
-    if ( p1 > p2 )
-      return;
-
-    if ( BOUNDS( ref1, worker->max_points ) ||
-         BOUNDS( ref2, worker->max_points ) )
-      return;
-
-    orus1 = worker->orus[ref1].x;
-    orus2 = worker->orus[ref2].x;
-
-    if ( orus1 > orus2 )
-    {
-      FT_F26Dot6  tmp_o;
-      FT_UInt     tmp_r;
-
-
-      tmp_o = orus1;
-      orus1 = orus2;
-      orus2 = tmp_o;
-
-      tmp_r = ref1;
-      ref1  = ref2;
-      ref2  = tmp_r;
-    }
-
-    org1   = worker->orgs[ref1].x;
-    org2   = worker->orgs[ref2].x;
-    cur1   = worker->curs[ref1].x;
-    cur2   = worker->curs[ref2].x;
-    delta1 = SUB_LONG( cur1, org1 );
-    delta2 = SUB_LONG( cur2, org2 );
-
-    if ( cur1 == cur2 || orus1 == orus2 )
-    {
-
-      /* trivial snap or shift of untouched points */
-      for ( i = p1; i <= p2; i++ )
-      {
-        FT_F26Dot6  x = worker->orgs[i].x;
-
-
-        if ( x <= org1 )
-          x = ADD_LONG( x, delta1 );
-
-        else if ( x >= org2 )
-          x = ADD_LONG( x, delta2 );
-
-        else
-          x = cur1;
-
-        worker->curs[i].x = x;
-      }
-    }
-    else
-    {
-      FT_Fixed  scale       = 0;
-      FT_Bool   scale_valid = 0;
-
-
-      /* interpolation */
-      for ( i = p1; i <= p2; i++ )
-      {
-        FT_F26Dot6  x = worker->orgs[i].x;
-
-
-        if ( x <= org1 )
-          x = ADD_LONG( x, delta1 );
-
-        else if ( x >= org2 )
-          x = ADD_LONG( x, delta2 );
-
-        else
-        {
-          if ( !scale_valid )
-          {
-            scale_valid = 1;
-            scale       = FT_DivFix( SUB_LONG( cur2, cur1 ),
-                                     SUB_LONG( orus2, orus1 ) );
-          }
-
-          x = ADD_LONG( cur1,
-                        FT_MulFix( SUB_LONG( worker->orus[i].x, orus1 ),
-                                   scale ) );
-        }
-        worker->curs[i].x = x;
-      }
-    }
-  }
-
-
   /**************************************************************************
    *
    * IUP[a]:       Interpolate Untouched Points
@@ -7005,17 +6871,10 @@
   static void
   Ins_IUP( TT_ExecContext  exc )
   {
-    IUP_WorkerRec  V;
-    FT_Byte        mask;
-
-    FT_UInt   first_point;   /* first point of contour        */
-    FT_UInt   end_point;     /* end point (last+1) of contour */
-
-    FT_UInt   first_touched; /* first touched point in contour   */
-    FT_UInt   cur_touched;   /* current touched point in contour */
-
-    FT_UInt   point;         /* current point   */
-    FT_Short  contour;       /* current contour */
+    FT_Vector*  orgs;
+    FT_Vector*  curs;
+    FT_Vector*  orus;
+    FT_Byte     mask;
 
 
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_MINIMAL
@@ -7041,22 +6900,19 @@
 
     if ( exc->opcode & 1 )
     {
-      mask   = FT_CURVE_TAG_TOUCH_X;
-      V.orgs = exc->pts.org;
-      V.curs = exc->pts.cur;
-      V.orus = exc->pts.orus;
+      mask = FT_CURVE_TAG_TOUCH_X;
+      orgs = exc->pts.org;
+      curs = exc->pts.cur;
+      orus = exc->pts.orus;
     }
     else
     {
-      mask   = FT_CURVE_TAG_TOUCH_Y;
-      V.orgs = (FT_Vector*)( (FT_Pos*)exc->pts.org + 1 );
-      V.curs = (FT_Vector*)( (FT_Pos*)exc->pts.cur + 1 );
-      V.orus = (FT_Vector*)( (FT_Pos*)exc->pts.orus + 1 );
+      /* shift array pointers so that we can access `foo.y' as `foo.x' */
+      mask = FT_CURVE_TAG_TOUCH_Y;
+      orgs = (FT_Vector*)( (FT_Pos*)exc->pts.org + 1 );
+      curs = (FT_Vector*)( (FT_Pos*)exc->pts.cur + 1 );
+      orus = (FT_Vector*)( (FT_Pos*)exc->pts.orus + 1 );
     }
-    V.max_points = exc->pts.n_points;
-
-    contour = 0;
-    point   = 0;
 
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_INFINALITY
     if ( SUBPIXEL_HINTING_INFINALITY &&
@@ -7068,59 +6924,16 @@
     }
 #endif /* TT_SUPPORT_SUBPIXEL_HINTING_INFINALITY */
 
-    do
-    {
-      end_point   = exc->pts.contours[contour] - exc->pts.first_point;
-      first_point = point;
-
-      if ( BOUNDS( end_point, exc->pts.n_points ) )
-        end_point = exc->pts.n_points - 1;
-
-      while ( point <= end_point && ( exc->pts.tags[point] & mask ) == 0 )
-        point++;
-
-      if ( point <= end_point )
-      {
-        first_touched = point;
-        cur_touched   = point;
-
-        point++;
-
-        while ( point <= end_point )
-        {
-          if ( ( exc->pts.tags[point] & mask ) != 0 )
-          {
-            _iup_worker_interpolate( &V,
-                                     cur_touched + 1,
-                                     point - 1,
-                                     cur_touched,
-                                     point );
-            cur_touched = point;
-          }
-
-          point++;
-        }
-
-        if ( cur_touched == first_touched )
-          _iup_worker_shift( &V, first_point, end_point, cur_touched );
-        else
-        {
-          _iup_worker_interpolate( &V,
-                                   (FT_UShort)( cur_touched + 1 ),
-                                   end_point,
-                                   cur_touched,
-                                   first_touched );
-
-          if ( first_touched > 0 )
-            _iup_worker_interpolate( &V,
-                                     first_point,
-                                     first_touched - 1,
-                                     cur_touched,
-                                     first_touched );
-        }
-      }
-      contour++;
-    } while ( contour < exc->pts.n_contours );
+    tt_interpolate_untouched( orgs,
+                              orus,
+                              curs,
+                              exc->pts.tags,
+                              mask,
+                              exc->pts.n_points,
+                              exc->pts.contours,
+                              (FT_UInt)exc->pts.n_contours,
+                              exc->pts.first_point,
+                              FALSE );
   }
 
 
@@ -7709,6 +7522,107 @@
   }
 
 
+  /**************************************************************************
+   *
+   * PROFILING
+   *
+   * If the `interpreter-profiling' property is set, `TT_RunIns' calls
+   * `Profile_Instruction' for every executed instruction, and
+   * `Profile_Start' and `Profile_Stop' around each run.  The counters are
+   * owned by the driver object.
+   */
+
+
+  static TT_Profile
+  Get_Profile( TT_ExecContext  exc )
+  {
+    if ( exc->iniRange < tt_coderange_font  ||
+         exc->iniRange > tt_coderange_glyph )
+      return NULL;
+
+    return ((TT_Driver)FT_FACE_DRIVER( exc->face ))->profile;
+  }
+
+
+  static FT_ULong
+  Profile_Start( TT_ExecContext  exc,
+                 TT_Profile      profile )
+  {
+    profile->data.program_runs[exc->iniRange - 1]++;
+
+    return profile->clock ? profile->clock( profile->clock_data ) : 0;
+  }
+
+
+  static void
+  Profile_Stop( TT_ExecContext  exc,
+                TT_Profile      profile,
+                FT_ULong        ins_counter,
+                FT_ULong        start )
+  {
+    FT_Int  program = exc->iniRange - 1;
+
+
+    profile->data.program_counts[program] += ins_counter;
+
+    if ( profile->clock )
+    {
+      FT_ULong  elapsed = profile->clock( profile->clock_data ) - start;
+
+
+      profile->data.program_times[program] += elapsed;
+
+      if ( program == TT_PROFILE_PROGRAM_GLYPH &&
+           elapsed > profile->data.max_glyph_time )
+        profile->data.max_glyph_time = elapsed;
+    }
+  }
+
+
+  static void
+  Profile_Instruction( TT_ExecContext  exc,
+                       TT_Profile      profile )
+  {
+    FT_Prop_InterpreterProfile*  data = &profile->data;
+
+
+    data->opcode_counts[exc->opcode]++;
+
+    if ( (FT_ULong)exc->top > data->max_stack_depth )
+      data->max_stack_depth = (FT_UInt)exc->top;
+
+    if ( exc->callTop > 0 )
+    {
+      TT_DefRecord*  def = exc->callStack[exc->callTop - 1].Def;
+
+
+      if ( (FT_UInt)exc->callTop > data->max_call_depth )
+        data->max_call_depth = (FT_UInt)exc->callTop;
+
+      /* only count functions, not instructions defined with IDEF */
+      if ( def < exc->FDefs || def >= exc->FDefs + exc->numFDefs )
+        return;
+
+      if ( def->opc >= data->num_functions )
+      {
+        FT_Memory  memory = exc->memory;
+        FT_Error   error;
+
+
+        /* on allocation failure we simply don't count this function */
+        if ( FT_RENEW_ARRAY( profile->function_counts,
+                             data->num_functions,
+                             def->opc + 1 ) )
+          return;
+
+        data->num_functions = def->opc + 1;
+      }
+
+      profile->function_counts[def->opc]++;
+    }
+  }
+
+
   /**************************************************************************
    *
    * RUN
@@ -7744,9 +7658,12 @@
   FT_EXPORT_DEF( FT_Error )
   TT_RunIns( TT_ExecContext  exc )
   {
-    FT_ULong   ins_counter = 0;  /* executed instructions counter */
-    FT_ULong   num_twilight_points;
-    FT_UShort  i;
+    FT_ULong    ins_counter = 0;  /* executed instructions counter */
+    FT_ULong    num_twilight_points;
+    FT_UShort   i;
+
+    TT_Profile  profile       = NULL;
+    FT_ULong    profile_start = 0;
 
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_INFINALITY
     FT_Byte    opcode_pattern[1][2] = {
@@ -7848,10 +7765,17 @@
     exc->iupy_called = FALSE;
 #endif
 
+    profile = Get_Profile( exc );
+    if ( profile )
+      profile_start = Profile_Start( exc, profile );
+
     do
     {
       exc->opcode = exc->code[exc->IP];
 
+      if ( profile )
+        Profile_Instruction( exc, profile );
+
 #ifdef FT_DEBUG_LEVEL_TRACE
       if ( ft_trace_levels[trace_ttinterp] >= 6 )
       {
@@ -8593,6 +8517,9 @@
                 ins_counter,
                 ins_counter == 1 ? "" : "s" ));
 
+    if ( profile )
+      Profile_Stop( exc, profile, ins_counter, profile_start );
+
     exc->cvt     = exc->origCvt;
     exc->storage = exc->origStorage;
 
@@ -8605,6 +8532,9 @@
     if ( exc->error && !exc->instruction_trap )
       FT_TRACE1(( "  The interpreter returned error 0x%x\n", exc->error ));
 
+    if ( profile )
+      Profile_Stop( exc, profile, ins_counter, profile_start );
+
     exc->cvt     = exc->origCvt;
     exc->storage = exc->origStorage;
 
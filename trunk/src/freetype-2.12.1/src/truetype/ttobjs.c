@@ -45,6 +45,245 @@
 #define FT_COMPONENT  ttobjs
 
 
+#if defined( TT_USE_BYTECODE_INTERPRETER ) || \
+    defined( TT_CONFIG_OPTION_GX_VAR_SUPPORT )
+
+  /**************************************************************************
+   *
+   *                 INTERPOLATION OF UNTOUCHED POINTS
+   *
+   */
+
+
+  /* Shift all points in the range [p1,p2] except `ref' by the */
+  /* displacement of `ref'.                                    */
+  static void
+  tt_iup_shift( FT_Vector*  orgs,
+                FT_Vector*  curs,
+                FT_UInt     p1,
+                FT_UInt     p2,
+                FT_UInt     ref )
+  {
+    FT_UInt  i;
+    FT_Pos   dx;
+
+
+    dx = SUB_LONG( curs[ref].x, orgs[ref].x );
+    if ( dx == 0 )
+      return;
+
+    for ( i = p1; i < ref; i++ )
+      curs[i].x = ADD_LONG( curs[i].x, dx );
+
+    for ( i = ref + 1; i <= p2; i++ )
+      curs[i].x = ADD_LONG( curs[i].x, dx );
+  }
+
+
+  /* Interpolate the points in the range [p1,p2] between the touched */
+  /* points `ref1' and `ref2'.  Points outside of the reference      */
+  /* interval get the displacement of the nearer reference point;    */
+  /* points inside are scaled linearly, using `orus' for the ratio.  */
+  static void
+  tt_iup_interpolate( FT_Vector*  orgs,
+                      FT_Vector*  orus,
+                      FT_Vector*  curs,
+                      FT_UInt     p1,
+                      FT_UInt     p2,
+                      FT_UInt     ref1,
+                      FT_UInt     ref2,
+                      FT_Bool     keep_ambiguous )
+  {
+    FT_UInt   i;
+    FT_Pos    orus1, orus2, org1, org2, cur1, cur2, delta1, delta2;
+    FT_Fixed  scale;
+
+
+    if ( p1 > p2 )
+      return;
+
+    orus1 = orus[ref1].x;
+    orus2 = orus[ref2].x;
+
+    if ( orus1 > orus2 )
+    {
+      FT_Pos   tmp_o;
+      FT_UInt  tmp_r;
+
+
+      tmp_o = orus1;
+      orus1 = orus2;
+      orus2 = tmp_o;
+
+      tmp_r = ref1;
+      ref1  = ref2;
+      ref2  = tmp_r;
+    }
+
+    org1   = orgs[ref1].x;
+    org2   = orgs[ref2].x;
+    cur1   = curs[ref1].x;
+    cur2   = curs[ref2].x;
+    delta1 = SUB_LONG( cur1, org1 );
+    delta2 = SUB_LONG( cur2, org2 );
+
+    /* Coinciding reference points with different displacements are  */
+    /* ill-defined; `IUP' snaps to the first one while `gvar' expects */
+    /* the points to stay untouched.                                  */
+    if ( orus1 == orus2 && cur1 != cur2 && keep_ambiguous )
+      return;
+
+    /* the scaling factor is loop-invariant; it is zero for the */
+    /* degenerate cases, snapping inner points to `cur1'        */
+    if ( cur1 == cur2 || orus1 == orus2 )
+      scale = 0;
+    else
+      scale = FT_DivFix( SUB_LONG( cur2, cur1 ),
+                         SUB_LONG( orus2, orus1 ) );
+
+    for ( i = p1; i <= p2; i++ )
+    {
+      FT_Pos  x = orgs[i].x;
+
+
+      if ( x <= org1 )
+        x = ADD_LONG( x, delta1 );
+      else if ( x >= org2 )
+        x = ADD_LONG( x, delta2 );
+      else
+        x = ADD_LONG( cur1, FT_MulFix( SUB_LONG( orus[i].x, orus1 ),
+                                       scale ) );
+
+      curs[i].x = x;
+    }
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_interpolate_untouched
+   *
+   * @Description:
+   *   Interpolate the untouched points of all contours along one axis.
+   *   This is the common kernel of the `IUP' instruction and of the
+   *   inference of missing `gvar' deltas.
+   *
+   *   Only the `x' fields of the vector arrays are accessed; to process
+   *   the vertical axis, pass the arrays shifted by one `FT_Pos'.
+   *
+   * @Input:
+   *   orgs ::
+   *     The original point positions, used for the range checks.
+   *
+   *   orus ::
+   *     The positions used to compute the interpolation ratio.  Can be
+   *     identical to `orgs'.
+   *
+   *   tags ::
+   *     The point flags.  A point is touched if its flag ANDed with
+   *     `mask' is non-zero.
+   *
+   *   mask ::
+   *     The flag mask.
+   *
+   *   n_points ::
+   *     The number of points.
+   *
+   *   contours ::
+   *     The contour end points.
+   *
+   *   n_contours ::
+   *     The number of contours.
+   *
+   *   first_point ::
+   *     The offset to subtract from the contour end points.
+   *
+   *   keep_ambiguous ::
+   *     If set, leave points between two touched points with identical
+   *     original but different current positions alone instead of
+   *     snapping them (`gvar' semantics).
+   *
+   * @InOut:
+   *   curs ::
+   *     The current point positions; untouched points get updated.
+   */
+  FT_LOCAL_DEF( void )
+  tt_interpolate_untouched( FT_Vector*        orgs,
+                            FT_Vector*        orus,
+                            FT_Vector*        curs,
+                            const FT_Byte*    tags,
+                            FT_Byte           mask,
+                            FT_UInt           n_points,
+                            const FT_UShort*  contours,
+                            FT_UInt           n_contours,
+                            FT_UInt           first_point,
+                            FT_Bool           keep_ambiguous )
+  {
+    FT_UInt  contour;
+    FT_UInt  point;
+    FT_UInt  start_point;    /* first point of contour           */
+    FT_UInt  end_point;      /* last point of contour            */
+    FT_UInt  first_touched;  /* first touched point in contour   */
+    FT_UInt  cur_touched;    /* current touched point in contour */
+
+
+    if ( !n_points )
+      return;
+
+    point = 0;
+
+    for ( contour = 0; contour < n_contours; contour++ )
+    {
+      end_point   = (FT_UInt)contours[contour] - first_point;
+      start_point = point;
+
+      if ( end_point >= n_points )
+        end_point = n_points - 1;
+
+      while ( point <= end_point && ( tags[point] & mask ) == 0 )
+        point++;
+
+      if ( point > end_point )
+        continue;
+
+      first_touched = point;
+      cur_touched   = point;
+
+      for ( point++; point <= end_point; point++ )
+      {
+        if ( ( tags[point] & mask ) != 0 )
+        {
+          tt_iup_interpolate( orgs, orus, curs,
+                              cur_touched + 1, point - 1,
+                              cur_touched, point,
+                              keep_ambiguous );
+          cur_touched = point;
+        }
+      }
+
+      if ( cur_touched == first_touched )
+        tt_iup_shift( orgs, curs, start_point, end_point, cur_touched );
+      else
+      {
+        /* handle remaining points at the end and beginning of contour */
+        tt_iup_interpolate( orgs, orus, curs,
+                            cur_touched + 1, end_point,
+                            cur_touched, first_touched,
+                            keep_ambiguous );
+
+        if ( first_touched > start_point )
+          tt_iup_interpolate( orgs, orus, curs,
+                              start_point, first_touched - 1,
+                              cur_touched, first_touched,
+                              keep_ambiguous );
+      }
+    }
+  }
+
+#endif /* TT_USE_BYTECODE_INTERPRETER || TT_CONFIG_OPTION_GX_VAR_SUPPORT */
+
+
 #ifdef TT_USE_BYTECODE_INTERPRETER
 
   /**************************************************************************
@@ -713,6 +952,15 @@
     if ( face_index < 0 )
       return FT_Err_Ok;
 
+    {
+      FT_Int  i;
+
+
+      for ( i = 0; i < num_params; i++ )
+        if ( params[i].tag == FT_PARAM_TAG_METADATA_ONLY )
+          face->metadata_only = TRUE;
+    }
+
     /* Load font directory */
     error = sfnt->load_face( stream, face, face_index, num_params, params );
     if ( error )
@@ -723,6 +971,13 @@
       ttface->face_flags |= FT_FACE_FLAG_TRICKY;
 #endif
 
+    /* the remaining tables are only needed for loading glyphs */
+    if ( face->metadata_only )
+    {
+      FT_TRACE2(( "  metadata only, skipping glyph data setup\n" ));
+      goto Instance;
+    }
+
     error = tt_face_load_hdmx( face, stream );
     if ( error )
       goto Exit;
@@ -776,6 +1031,7 @@
       }
     }
 
+  Instance:
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
 
     {
@@ -807,6 +1063,403 @@
   }
 
 
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_face_get_instance_id
+   *
+   * @Description:
+   *   Return a number identifying the current variation instance of a
+   *   face.  It changes whenever the variation coordinates change and is
+   *   zero if the face is not varied.
+   *
+   * @Input:
+   *   face ::
+   *     A handle to the face object.
+   *
+   * @Return:
+   *   The instance identifier.
+   */
+  FT_LOCAL_DEF( FT_ULong )
+  tt_face_get_instance_id( TT_Face  face )
+  {
+#ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
+    if ( face->doblend && face->blend )
+      return face->blend->serial;
+#else
+    FT_UNUSED( face );
+#endif
+
+    return 0;
+  }
+
+
+#ifdef TT_USE_BYTECODE_INTERPRETER
+
+  /**************************************************************************
+   *
+   * SIZE STATES
+   *
+   * The results of running `fpgm` and `prep` only depend on the size
+   * metrics, the variation instance, and the few interpreter settings
+   * visible to the bytecode.  A face thus keeps the state of the most
+   * recently prepared sizes; a size with the same parameters gets the
+   * saved state copied instead of running the programs again.
+   *
+   * The state after `fpgm` consists of the function and instruction
+   * definitions.  The state after `prep` adds the scaled CVT, the storage
+   * area, the twilight zone, and the default graphics state.  All arrays
+   * are stored right after the record in the same memory block.
+   *
+   * The Infinality interpreter and the debugger hook are excluded: the
+   * former applies font-specific tweaks depending on more state, and the
+   * latter must see the programs being executed.
+   */
+
+#define TT_MAX_SIZE_STATES  16
+
+
+  typedef struct  TT_SizeStateKeyRec_
+  {
+    FT_UInt    interpreter_version;
+    FT_Bool    pedantic;
+    FT_Bool    prep;             /* FALSE for the state after `fpgm' */
+    FT_Byte    mode;             /* rendering flags seen by `GETINFO' */
+    FT_ULong   instance;
+
+    FT_UShort  x_ppem;
+    FT_UShort  y_ppem;
+    FT_Fixed   x_scale;
+    FT_Fixed   y_scale;
+    FT_Long    point_size;
+
+    FT_UShort  ppem;
+    FT_Fixed   scale;
+    FT_Long    x_ratio;
+    FT_Long    y_ratio;
+    FT_Bool    rotated;
+    FT_Bool    stretched;
+
+  } TT_SizeStateKeyRec;
+
+
+  typedef struct TT_SizeStateRec_*  TT_SizeState;
+
+  typedef struct  TT_SizeStateRec_
+  {
+    TT_SizeState        next;           /* next less recently used */
+    TT_SizeStateKeyRec  key;
+
+    FT_UInt             num_function_defs;
+    FT_UInt             num_instruction_defs;
+    FT_UInt             max_func;
+    FT_UInt             max_ins;
+    TT_DefArray         function_defs;
+    TT_DefArray         instruction_defs;
+    TT_CodeRangeTable   codeRangeTable;
+
+    /* only used for the state after `prep' */
+    TT_GraphicsState    GS;
+    FT_Long*            cvt;
+    FT_Long*            storage;
+    FT_Vector*          twilight_org;
+    FT_Vector*          twilight_cur;
+    FT_Vector*          twilight_orus;
+    FT_Byte*            twilight_tags;
+
+  } TT_SizeStateRec;
+
+
+  typedef struct  TT_SizeStatesRec_
+  {
+    FT_UInt       num_states;
+    TT_SizeState  head;                 /* most recently used */
+
+  } TT_SizeStatesRec, *TT_SizeStates;
+
+
+  static void
+  tt_face_done_size_states( TT_Face  face )
+  {
+    FT_Memory      memory = face->root.memory;
+    TT_SizeStates  states = (TT_SizeStates)face->size_states;
+    TT_SizeState   state;
+
+
+    if ( !states )
+      return;
+
+    state = states->head;
+    while ( state )
+    {
+      TT_SizeState  next = state->next;
+
+
+      FT_FREE( state );
+      state = next;
+    }
+
+    FT_FREE( face->size_states );
+  }
+
+
+  /* Compute the key for the `fpgm' (if `prep' is FALSE) or `prep' state */
+  /* of `size'.  Return FALSE if the state mustn't be shared.            */
+  static FT_Bool
+  tt_size_state_key( TT_Size              size,
+                     FT_Bool              pedantic,
+                     FT_Bool              prep,
+                     TT_SizeStateKeyRec*  key )
+  {
+    TT_Face         face   = (TT_Face)size->root.face;
+    TT_Driver       driver = (TT_Driver)FT_FACE_DRIVER( face );
+    TT_ExecContext  exec   = size->context;
+
+
+    if ( !exec                                                      ||
+         face->interpreter != (TT_Interpreter)TT_RunIns             ||
+         driver->interpreter_version == TT_INTERPRETER_VERSION_38 )
+      return FALSE;
+
+    FT_ZERO( key );
+
+    key->interpreter_version = driver->interpreter_version;
+    key->pedantic            = pedantic;
+    key->prep                = prep;
+    key->instance            = tt_face_get_instance_id( face );
+
+    key->mode = exec->grayscale ? 1 : 0;
+#ifdef TT_SUPPORT_SUBPIXEL_HINTING_MINIMAL
+    if ( exec->subpixel_hinting_lean )
+      key->mode |= 2;
+    if ( exec->grayscale_cleartype )
+      key->mode |= 4;
+    if ( exec->vertical_lcd_lean )
+      key->mode |= 8;
+#endif
+
+    /* `fpgm' is run with zero metrics */
+    if ( prep )
+    {
+      key->x_ppem     = size->metrics->x_ppem;
+      key->y_ppem     = size->metrics->y_ppem;
+      key->x_scale    = size->metrics->x_scale;
+      key->y_scale    = size->metrics->y_scale;
+      key->point_size = size->point_size;
+
+      key->ppem      = size->ttmetrics.ppem;
+      key->scale     = size->ttmetrics.scale;
+      key->x_ratio   = size->ttmetrics.x_ratio;
+      key->y_ratio   = size->ttmetrics.y_ratio;
+      key->rotated   = size->ttmetrics.rotated;
+      key->stretched = size->ttmetrics.stretched;
+    }
+
+    return TRUE;
+  }
+
+
+  /* Copy a saved state into `size' if there is one for `key'. */
+  static FT_Bool
+  tt_size_state_restore( TT_Size              size,
+                         TT_SizeStateKeyRec*  key )
+  {
+    TT_Face        face   = (TT_Face)size->root.face;
+    TT_SizeStates  states = (TT_SizeStates)face->size_states;
+    TT_SizeState*  pstate;
+    TT_SizeState   state;
+
+
+    if ( !states )
+      return FALSE;
+
+    pstate = &states->head;
+    for ( ;; )
+    {
+      state = *pstate;
+      if ( !state )
+        return FALSE;
+
+      if ( !ft_memcmp( &state->key, key, sizeof ( *key ) ) )
+        break;
+
+      pstate = &state->next;
+    }
+
+    /* move to front */
+    *pstate       = state->next;
+    state->next   = states->head;
+    states->head  = state;
+
+    size->num_function_defs    = state->num_function_defs;
+    size->num_instruction_defs = state->num_instruction_defs;
+    size->max_func             = state->max_func;
+    size->max_ins              = state->max_ins;
+
+    /* the arrays are NULL if their size is zero */
+    if ( size->max_function_defs )
+      FT_ARRAY_COPY( size->function_defs, state->function_defs,
+                     size->max_function_defs );
+    if ( size->max_instruction_defs )
+      FT_ARRAY_COPY( size->instruction_defs, state->instruction_defs,
+                     size->max_instruction_defs );
+    FT_ARRAY_COPY( size->codeRangeTable, state->codeRangeTable,
+                   TT_MAX_CODE_RANGES );
+
+    if ( key->prep )
+    {
+      TT_GlyphZone  twilight = &size->twilight;
+
+
+      size->GS = state->GS;
+
+      if ( size->cvt_size )
+        FT_ARRAY_COPY( size->cvt, state->cvt, size->cvt_size );
+      if ( size->storage_size )
+        FT_ARRAY_COPY( size->storage, state->storage, size->storage_size );
+
+      if ( twilight->n_points )
+      {
+        FT_ARRAY_COPY( twilight->org, state->twilight_org,
+                       twilight->n_points );
+        FT_ARRAY_COPY( twilight->cur, state->twilight_cur,
+                       twilight->n_points );
+        FT_ARRAY_COPY( twilight->orus, state->twilight_orus,
+                       twilight->n_points );
+        FT_ARRAY_COPY( twilight->tags, state->twilight_tags,
+                       twilight->n_points );
+      }
+
+      size->cvt_ready = FT_Err_Ok;
+    }
+    else
+      size->bytecode_ready = FT_Err_Ok;
+
+    FT_TRACE4(( "tt_size_state_restore: reusing `%s' state\n",
+                key->prep ? "prep" : "fpgm" ));
+
+    return TRUE;
+  }
+
+
+  /* Save the state of `size' for `key'.  Errors are ignored; */
+  /* the programs simply get run again next time.             */
+  static void
+  tt_size_state_save( TT_Size              size,
+                      TT_SizeStateKeyRec*  key )
+  {
+    TT_Face        face     = (TT_Face)size->root.face;
+    FT_Memory      memory   = face->root.memory;
+    TT_SizeStates  states   = (TT_SizeStates)face->size_states;
+    TT_GlyphZone   twilight = &size->twilight;
+
+    FT_Error      error;
+    FT_Offset     state_size;
+    TT_SizeState  state;
+    FT_Byte*      p;
+
+
+    if ( !states )
+    {
+      if ( FT_NEW( states ) )
+        return;
+
+      face->size_states = states;
+    }
+
+    state_size = sizeof ( TT_SizeStateRec )                           +
+                 size->max_function_defs * sizeof ( TT_DefRecord )    +
+                 size->max_instruction_defs * sizeof ( TT_DefRecord );
+    if ( key->prep )
+      state_size += size->cvt_size * sizeof ( FT_Long )              +
+                    size->storage_size * sizeof ( FT_Long )          +
+                    3 * twilight->n_points * sizeof ( FT_Vector )    +
+                    twilight->n_points;
+
+    if ( FT_ALLOC( state, state_size ) )
+      return;
+
+    state->key = *key;
+
+    state->num_function_defs    = size->num_function_defs;
+    state->num_instruction_defs = size->num_instruction_defs;
+    state->max_func             = size->max_func;
+    state->max_ins              = size->max_ins;
+
+    FT_ARRAY_COPY( state->codeRangeTable, size->codeRangeTable,
+                   TT_MAX_CODE_RANGES );
+
+    /* the arrays of largest alignment come first */
+    p = (FT_Byte*)( state + 1 );
+
+    state->function_defs = (TT_DefArray)p;
+    p                   += size->max_function_defs * sizeof ( TT_DefRecord );
+    if ( size->max_function_defs )
+      FT_ARRAY_COPY( state->function_defs, size->function_defs,
+                     size->max_function_defs );
+
+    state->instruction_defs = (TT_DefArray)p;
+    p += size->max_instruction_defs * sizeof ( TT_DefRecord );
+    if ( size->max_instruction_defs )
+      FT_ARRAY_COPY( state->instruction_defs, size->instruction_defs,
+                     size->max_instruction_defs );
+
+    if ( key->prep )
+    {
+      state->GS = size->GS;
+
+      state->cvt = (FT_Long*)p;
+      p         += size->cvt_size * sizeof ( FT_Long );
+      if ( size->cvt_size )
+        FT_ARRAY_COPY( state->cvt, size->cvt, size->cvt_size );
+
+      state->storage = (FT_Long*)p;
+      p             += size->storage_size * sizeof ( FT_Long );
+      if ( size->storage_size )
+        FT_ARRAY_COPY( state->storage, size->storage, size->storage_size );
+
+      state->twilight_org  = (FT_Vector*)p;
+      p                   += twilight->n_points * sizeof ( FT_Vector );
+      state->twilight_cur  = (FT_Vector*)p;
+      p                   += twilight->n_points * sizeof ( FT_Vector );
+      state->twilight_orus = (FT_Vector*)p;
+      p                   += twilight->n_points * sizeof ( FT_Vector );
+      state->twilight_tags = p;
+
+      if ( twilight->n_points )
+      {
+        FT_ARRAY_COPY( state->twilight_org, twilight->org,
+                       twilight->n_points );
+        FT_ARRAY_COPY( state->twilight_cur, twilight->cur,
+                       twilight->n_points );
+        FT_ARRAY_COPY( state->twilight_orus, twilight->orus,
+                       twilight->n_points );
+        FT_ARRAY_COPY( state->twilight_tags, twilight->tags,
+                       twilight->n_points );
+      }
+    }
+
+    state->next  = states->head;
+    states->head = state;
+    states->num_states++;
+
+    /* discard the least recently used state */
+    if ( states->num_states > TT_MAX_SIZE_STATES )
+    {
+      TT_SizeState*  pstate = &states->head;
+
+
+      while ( (*pstate)->next )
+        pstate = &(*pstate)->next;
+
+      FT_FREE( *pstate );
+      states->num_states--;
+    }
+  }
+
+#endif /* TT_USE_BYTECODE_INTERPRETER */
+
+
   /**************************************************************************
    *
    * @Function:
@@ -857,6 +1510,10 @@
     face->font_program_size = 0;
     face->cvt_program_size  = 0;
 
+#ifdef TT_USE_BYTECODE_INTERPRETER
+    tt_face_done_size_states( face );
+#endif
+
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
     tt_done_blend( face );
     face->blend = NULL;
@@ -1110,6 +1767,8 @@
 
     size->bytecode_ready = -1;
     size->cvt_ready      = -1;
+
+    TT_Done_Hinted_Cache( size );
   }
 
 
@@ -1124,8 +1783,9 @@
     TT_Face    face = (TT_Face)ftsize->face;
     FT_Memory  memory = face->root.memory;
 
-    FT_UShort       n_twilight;
-    TT_MaxProfile*  maxp = &face->max_profile;
+    FT_UShort           n_twilight;
+    TT_MaxProfile*      maxp = &face->max_profile;
+    TT_SizeStateKeyRec  key;
 
 
     /* clean up bytecode related data */
@@ -1216,7 +1876,18 @@
     /* to be executed just once; calling it again is completely useless   */
     /* and might even lead to extremely slow behaviour if it is malformed */
     /* (containing an infinite loop, for example).                        */
-    error = tt_size_run_fpgm( size, pedantic );
+    if ( tt_size_state_key( size, pedantic, FALSE, &key ) )
+    {
+      if ( tt_size_state_restore( size, &key ) )
+        return FT_Err_Ok;
+
+      error = tt_size_run_fpgm( size, pedantic );
+      if ( !error )
+        tt_size_state_save( size, &key );
+    }
+    else
+      error = tt_size_run_fpgm( size, pedantic );
+
     return error;
 
   Exit:
@@ -1231,7 +1902,8 @@
   tt_size_ready_bytecode( TT_Size  size,
                           FT_Bool  pedantic )
   {
-    FT_Error  error = FT_Err_Ok;
+    FT_Error            error = FT_Err_Ok;
+    TT_SizeStateKeyRec  key;
 
 
     if ( size->bytecode_ready < 0 )
@@ -1263,7 +1935,17 @@
 
       size->GS = tt_default_graphics_state;
 
-      error = tt_size_run_prep( size, pedantic );
+      if ( tt_size_state_key( size, pedantic, TRUE, &key ) )
+      {
+        if ( tt_size_state_restore( size, &key ) )
+          goto Exit;
+
+        error = tt_size_run_prep( size, pedantic );
+        if ( !error )
+          tt_size_state_save( size, &key );
+      }
+      else
+        error = tt_size_run_prep( size, pedantic );
     }
     else
       error = size->cvt_ready;
@@ -1504,7 +2186,87 @@
   FT_LOCAL_DEF( void )
   tt_driver_done( FT_Module  ttdriver )     /* TT_Driver */
   {
-    FT_UNUSED( ttdriver );
+    TT_Driver  driver = (TT_Driver)ttdriver;
+    FT_Memory  memory = ttdriver->memory;
+
+
+    if ( driver->profile )
+    {
+      FT_FREE( driver->profile->function_counts );
+      FT_FREE( driver->profile );
+    }
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_driver_reset_profile
+   *
+   * @Description:
+   *   Reset all counters of the bytecode interpreter's profile, if any.
+   *
+   * @Input:
+   *   driver ::
+   *     A handle to the target TrueType driver.
+   */
+  FT_LOCAL_DEF( void )
+  tt_driver_reset_profile( TT_Driver  driver )
+  {
+    FT_Memory   memory  = driver->root.root.memory;
+    TT_Profile  profile = driver->profile;
+
+
+    if ( !profile )
+      return;
+
+    FT_FREE( profile->function_counts );
+    FT_ZERO( &profile->data );
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_driver_set_profiling
+   *
+   * @Description:
+   *   Switch profiling of the bytecode interpreter on or off.  Switching
+   *   it on resets all counters.
+   *
+   * @Input:
+   *   driver ::
+   *     A handle to the target TrueType driver.
+   *
+   *   profiling ::
+   *     The new settings.
+   *
+   * @Return:
+   *   FreeType error code.  0 means success.
+   */
+  FT_LOCAL_DEF( FT_Error )
+  tt_driver_set_profiling( TT_Driver                            driver,
+                           const FT_Prop_InterpreterProfiling*  profiling )
+  {
+    FT_Error   error  = FT_Err_Ok;
+    FT_Memory  memory = driver->root.root.memory;
+
+
+    if ( !profiling->enable )
+    {
+      tt_driver_done( (FT_Module)driver );
+      return FT_Err_Ok;
+    }
+
+    if ( !driver->profile && FT_NEW( driver->profile ) )
+      return error;
+
+    driver->profile->clock      = profiling->clock;
+    driver->profile->clock_data = profiling->clock_data;
+
+    tt_driver_reset_profile( driver );
+
+    return FT_Err_Ok;
   }
 
 
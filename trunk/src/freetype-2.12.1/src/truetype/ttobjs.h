@@ -22,6 +22,7 @@
 
 #include <freetype/internal/ftobjs.h>
 #include <freetype/internal/tttypes.h>
+#include <freetype/ftdriver.h>
 
 
 FT_BEGIN_HEADER
@@ -110,6 +111,23 @@ FT_BEGIN_HEADER
 
 #endif /* TT_USE_BYTECODE_INTERPRETER */
 
+#if defined( TT_USE_BYTECODE_INTERPRETER ) || \
+    defined( TT_CONFIG_OPTION_GX_VAR_SUPPORT )
+
+  FT_LOCAL( void )
+  tt_interpolate_untouched( FT_Vector*        orgs,
+                            FT_Vector*        orus,
+                            FT_Vector*        curs,
+                            const FT_Byte*    tags,
+                            FT_Byte           mask,
+                            FT_UInt           n_points,
+                            const FT_UShort*  contours,
+                            FT_UInt           n_contours,
+                            FT_UInt           first_point,
+                            FT_Bool           keep_ambiguous );
+
+#endif /* TT_USE_BYTECODE_INTERPRETER || TT_CONFIG_OPTION_GX_VAR_SUPPORT */
+
 
 
   /**************************************************************************
@@ -267,6 +285,33 @@ FT_BEGIN_HEADER
   } TT_Size_Metrics;
 
 
+  /**************************************************************************
+   *
+   * A cache of hinted outlines, see `TT_Load_Glyph`.  Nodes are kept in a
+   * hash table and in a list ordered by last use.  All nodes have been
+   * hinted with the scaling values stored in `x_scale`, `y_scale`,
+   * `x_ppem`, and `y_ppem`.
+   */
+  typedef struct TT_HintedNodeRec_*  TT_HintedNode;
+
+  typedef struct  TT_HintedCacheRec_
+  {
+    TT_HintedNode*  buckets;
+    FT_UInt         num_buckets;
+    FT_UInt         num_nodes;
+    FT_Offset       num_bytes;
+
+    TT_HintedNode   head;          /* most recently used  */
+    TT_HintedNode   tail;          /* least recently used */
+
+    FT_Fixed        x_scale;
+    FT_Fixed        y_scale;
+    FT_UShort       x_ppem;
+    FT_UShort       y_ppem;
+
+  } TT_HintedCacheRec;
+
+
   /**************************************************************************
    *
    * TrueType size class.
@@ -320,11 +365,31 @@ FT_BEGIN_HEADER
     FT_Error           bytecode_ready;
     FT_Error           cvt_ready;
 
+    TT_HintedCacheRec  hinted;       /* outlines of hinted glyphs */
+
 #endif /* TT_USE_BYTECODE_INTERPRETER */
 
   } TT_SizeRec;
 
 
+  /**************************************************************************
+   *
+   * Counters of the bytecode interpreter, see the `interpreter-profiling'
+   * property.  `data.function_counts' is only set when the data gets
+   * returned to the client; the interpreter updates `function_counts',
+   * which grows as higher function numbers are seen.
+   */
+  typedef struct  TT_ProfileRec_
+  {
+    FT_Profile_ClockFunc        clock;
+    void*                       clock_data;
+
+    FT_Prop_InterpreterProfile  data;
+    FT_ULong*                   function_counts;
+
+  } TT_ProfileRec, *TT_Profile;
+
+
   /**************************************************************************
    *
    * TrueType driver class.
@@ -335,7 +400,10 @@ FT_BEGIN_HEADER
 
     TT_GlyphZoneRec  zone;     /* glyph loader points zone */
 
-    FT_UInt  interpreter_version;
+    FT_UInt   interpreter_version;
+    FT_ULong  hinted_cache_size;   /* per size, in bytes; 0 means off */
+
+    TT_Profile  profile;           /* NULL unless profiling */
 
   } TT_DriverRec;
 
@@ -363,6 +431,9 @@ FT_BEGIN_HEADER
   FT_LOCAL( void )
   tt_face_done( FT_Face  ttface );          /* TT_Face */
 
+  FT_LOCAL( FT_ULong )
+  tt_face_get_instance_id( TT_Face  face );
+
 
   /**************************************************************************
    *
@@ -405,6 +476,13 @@ FT_BEGIN_HEADER
   FT_LOCAL( void )
   tt_driver_done( FT_Module  ttdriver );    /* TT_Driver */
 
+  FT_LOCAL( FT_Error )
+  tt_driver_set_profiling( TT_Driver                            driver,
+                           const FT_Prop_InterpreterProfiling*  profiling );
+
+  FT_LOCAL( void )
+  tt_driver_reset_profile( TT_Driver  driver );
+
 
   /**************************************************************************
    *
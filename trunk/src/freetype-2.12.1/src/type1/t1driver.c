@@ -633,6 +633,7 @@
   static const FT_Service_KerningRec  t1_service_kerning =
   {
     T1_Get_Track_Kerning,       /* get_track */
+    NULL                        /* get_pairs */
   };
 #endif
 
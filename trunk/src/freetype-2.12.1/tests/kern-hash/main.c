@@ -0,0 +1,205 @@
+#include <stdio.h>
+
+#include <freetype/freetype.h>
+#include <ft2build.h>
+
+
+  /*
+   * A TrueType font with glyphs 1 to 7 and a 'kern' table of three
+   * subtables:
+   *
+   * - unordered, additive: (3,4) -10, (1,2) -20, (2,3) -30, (1,2) -99,
+   *   (5,6) 15; the second (1,2) pair is a duplicate and never found;
+   * - ordered, overriding: (1,2) -5, (4,5) -40, (5,6) 7;
+   * - unordered, additive: (5,6) 3, (2,3) -1, (6,7) 12, (2,3) 50.
+   *
+   * The pair values must be the same as a search of all subtables would
+   * give, whether or not the face builds a hash table of the pairs.
+   */
+  static const unsigned char  font_data[] =
+  {
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x0B, 0x00, 0x80, 0x00, 0x03, 0x00, 0x30,
+    0x4F, 0x53, 0x2F, 0x32, 0x41, 0x38, 0x41, 0xE3, 0x00, 0x00, 0x01, 0x38,
+    0x00, 0x00, 0x00, 0x60, 0x63, 0x6D, 0x61, 0x70, 0x00, 0x0C, 0x00, 0x9A,
+    0x00, 0x00, 0x01, 0xAC, 0x00, 0x00, 0x00, 0x34, 0x67, 0x6C, 0x79, 0x66,
+    0x38, 0xF1, 0x38, 0xE8, 0x00, 0x00, 0x01, 0xF4, 0x00, 0x00, 0x00, 0xD0,
+    0x68, 0x65, 0x61, 0x64, 0x2F, 0x5F, 0x25, 0xA4, 0x00, 0x00, 0x00, 0xBC,
+    0x00, 0x00, 0x00, 0x36, 0x68, 0x68, 0x65, 0x61, 0x05, 0x7A, 0x01, 0xF6,
+    0x00, 0x00, 0x00, 0xF4, 0x00, 0x00, 0x00, 0x24, 0x68, 0x6D, 0x74, 0x78,
+    0x03, 0xE8, 0x01, 0x90, 0x00, 0x00, 0x01, 0x98, 0x00, 0x00, 0x00, 0x12,
+    0x6B, 0x65, 0x72, 0x6E, 0xFF, 0xDE, 0x00, 0xA3, 0x00, 0x00, 0x02, 0xC4,
+    0x00, 0x00, 0x00, 0x76, 0x6C, 0x6F, 0x63, 0x61, 0x01, 0x04, 0x00, 0xD0,
+    0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x00, 0x12, 0x6D, 0x61, 0x78, 0x70,
+    0x00, 0x0A, 0x00, 0x06, 0x00, 0x00, 0x01, 0x18, 0x00, 0x00, 0x00, 0x20,
+    0x6E, 0x61, 0x6D, 0x65, 0xA6, 0xCF, 0x81, 0xDB, 0x00, 0x00, 0x03, 0x3C,
+    0x00, 0x00, 0x00, 0x63, 0x70, 0x6F, 0x73, 0x74, 0xD6, 0x25, 0x40, 0x47,
+    0x00, 0x00, 0x03, 0xA0, 0x00, 0x00, 0x00, 0x47, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0xD8, 0x83, 0x52, 0x7F, 0x5F, 0x0F, 0x3C, 0xF5,
+    0x00, 0x03, 0x03, 0xE8, 0x00, 0x00, 0x00, 0x00, 0xE6, 0xF8, 0x71, 0x04,
+    0x00, 0x00, 0x00, 0x00, 0xE6, 0xF8, 0x71, 0x04, 0x00, 0x64, 0x00, 0x00,
+    0x01, 0xF4, 0x02, 0xBC, 0x00, 0x00, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x03, 0x20, 0xFF, 0x38,
+    0x00, 0x00, 0x02, 0x58, 0x00, 0x64, 0x00, 0x64, 0x01, 0xF4, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0x02, 0x58, 0x01, 0x90, 0x00, 0x05, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x00, 0x00, 0x00, 0x41, 0x00, 0x47, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,
+    0x02, 0x58, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64,
+    0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x14, 0x00, 0x03, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x14, 0x00, 0x04, 0x00, 0x20, 0x00, 0x00, 0x00, 0x04,
+    0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x47, 0xFF, 0xFF, 0x00, 0x00,
+    0x00, 0x41, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0D, 0x00, 0x1A, 0x00, 0x27, 0x00, 0x34, 0x00, 0x41,
+    0x00, 0x4E, 0x00, 0x5B, 0x00, 0x68, 0x00, 0x00, 0x00, 0x01, 0x00, 0x64,
+    0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11,
+    0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00, 0x00, 0x01,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03, 0x00, 0x00,
+    0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00,
+    0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03,
+    0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD,
+    0x44, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC,
+    0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02,
+    0xBC, 0xFD, 0x44, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xF4,
+    0x02, 0xBC, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01,
+    0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00,
+    0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11,
+    0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00, 0x00, 0x01, 0x00, 0x64,
+    0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11,
+    0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00, 0x00, 0x01,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03, 0x00, 0x00,
+    0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x01, 0x00, 0x05,
+    0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x04, 0xFF, 0xF6,
+    0x00, 0x01, 0x00, 0x02, 0xFF, 0xEC, 0x00, 0x02, 0x00, 0x03, 0xFF, 0xE2,
+    0x00, 0x01, 0x00, 0x02, 0xFF, 0x9D, 0x00, 0x05, 0x00, 0x06, 0x00, 0x0F,
+    0x00, 0x00, 0x00, 0x20, 0x00, 0x09, 0x00, 0x03, 0x00, 0x06, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0xFF, 0xFB, 0x00, 0x04, 0x00, 0x05,
+    0xFF, 0xD8, 0x00, 0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x00, 0x00, 0x26,
+    0x00, 0x01, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+    0x00, 0x06, 0x00, 0x03, 0x00, 0x02, 0x00, 0x03, 0xFF, 0xFF, 0x00, 0x06,
+    0x00, 0x07, 0x00, 0x0C, 0x00, 0x02, 0x00, 0x03, 0x00, 0x32, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x36, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x07, 0x00, 0x08, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09,
+    0x00, 0x01, 0x00, 0x10, 0x00, 0x0F, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09,
+    0x00, 0x02, 0x00, 0x0E, 0x00, 0x1F, 0x4B, 0x65, 0x72, 0x6E, 0x54, 0x65,
+    0x73, 0x74, 0x52, 0x65, 0x67, 0x75, 0x6C, 0x61, 0x72, 0x00, 0x4B, 0x00,
+    0x65, 0x00, 0x72, 0x00, 0x6E, 0x00, 0x54, 0x00, 0x65, 0x00, 0x73, 0x00,
+    0x74, 0x00, 0x52, 0x00, 0x65, 0x00, 0x67, 0x00, 0x75, 0x00, 0x6C, 0x00,
+    0x61, 0x00, 0x72, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0x00, 0x00, 0x01, 0x02, 0x01, 0x03, 0x01, 0x04, 0x01, 0x05,
+    0x01, 0x06, 0x01, 0x07, 0x01, 0x08, 0x02, 0x67, 0x31, 0x02, 0x67, 0x32,
+    0x02, 0x67, 0x33, 0x02, 0x67, 0x34, 0x02, 0x67, 0x35, 0x02, 0x67, 0x36,
+    0x02, 0x67, 0x37, 0x00
+  };
+
+
+  static const struct
+  {
+    FT_UInt  left;
+    FT_UInt  right;
+    FT_Pos   value;
+
+  } expected[] =
+  {
+    { 1, 2,  -5 },
+    { 2, 3, -31 },
+    { 3, 4, -10 },
+    { 4, 5, -40 },
+    { 5, 6,  10 },
+    { 6, 7,  12 }
+  };
+
+
+static FT_Pos
+expected_kerning( FT_UInt  left,
+                  FT_UInt  right )
+{
+  size_t  i;
+
+
+  for ( i = 0; i < sizeof ( expected ) / sizeof ( expected[0] ); i++ )
+    if ( expected[i].left == left && expected[i].right == right )
+      return expected[i].value;
+
+  return 0;
+}
+
+
+int
+main( void )
+{
+  static const FT_UInt  run[] = { 1, 2, 3, 4, 5, 6, 7, 6, 5, 0, 2, 3 };
+
+  FT_Library  library;
+  FT_Face     face;
+  FT_Vector   kerning;
+  FT_Vector   kernings[sizeof ( run ) / sizeof ( run[0] )];
+  FT_UInt     left, right;
+  size_t      i;
+  int         result = 0;
+
+
+  if ( FT_Init_FreeType( &library ) )
+    return 1;
+
+  if ( FT_New_Memory_Face( library, font_data, sizeof ( font_data ),
+                           0, &face ) )
+  {
+    fprintf( stderr, "Could not open the test font\n" );
+    return 1;
+  }
+
+  for ( left = 0; left < 9; left++ )
+    for ( right = 0; right < 9; right++ )
+    {
+      if ( FT_Get_Kerning( face, left, right,
+                           FT_KERNING_UNSCALED, &kerning ) )
+        return 1;
+
+      if ( kerning.x != expected_kerning( left, right ) || kerning.y )
+      {
+        printf( "pair (%u,%u): got %ld, expected %ld\n",
+                left, right, kerning.x, expected_kerning( left, right ) );
+        result = 1;
+      }
+    }
+
+  if ( FT_Get_Kerning_Run( face, run, sizeof ( run ) / sizeof ( run[0] ),
+                           FT_KERNING_UNSCALED, kernings ) )
+    return 1;
+
+  for ( i = 0; i < sizeof ( run ) / sizeof ( run[0] ); i++ )
+  {
+    FT_Pos  value = 0;
+
+
+    if ( i + 1 < sizeof ( run ) / sizeof ( run[0] ) )
+      value = expected_kerning( run[i], run[i + 1] );
+
+    if ( kernings[i].x != value || kernings[i].y )
+    {
+      printf( "run element %u: got %ld, expected %ld\n",
+              (unsigned int)i, kernings[i].x, value );
+      result = 1;
+    }
+  }
+
+  FT_Done_Face( face );
+  FT_Done_FreeType( library );
+
+  return result;
+}
+
+/* EOF */
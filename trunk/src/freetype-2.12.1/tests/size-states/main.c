@@ -0,0 +1,151 @@
+#include <stdio.h>
+
+#include <freetype/freetype.h>
+#include <ft2build.h>
+
+
+  /*
+   * A minimal TrueType font with one glyph.  The `fpgm` table defines a
+   * single function that is called from both `prep` and the glyph program;
+   * `maxp` declares no instruction definitions, no storage area, and no
+   * twilight points, and there is no `cvt ` table.  The corresponding
+   * arrays of a size object are thus NULL, which must not confuse the
+   * saving and restoring of the `fpgm` and `prep` states across sizes.
+   */
+  static const unsigned char  font_data[] =
+  {
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x80, 0x00, 0x03, 0x00, 0x40,
+    0x4F, 0x53, 0x2F, 0x32, 0x41, 0x38, 0x41, 0xDD, 0x00, 0x00, 0x01, 0x48,
+    0x00, 0x00, 0x00, 0x60, 0x63, 0x6D, 0x61, 0x70, 0x00, 0x0C, 0x00, 0x94,
+    0x00, 0x00, 0x01, 0xB0, 0x00, 0x00, 0x00, 0x34, 0x66, 0x70, 0x67, 0x6D,
+    0xB1, 0x2F, 0x59, 0xB0, 0x00, 0x00, 0x01, 0xE4, 0x00, 0x00, 0x00, 0x07,
+    0x67, 0x6C, 0x79, 0x66, 0xA1, 0x6F, 0xD8, 0xEC, 0x00, 0x00, 0x01, 0xF8,
+    0x00, 0x00, 0x00, 0x3A, 0x68, 0x65, 0x61, 0x64, 0x2F, 0x5F, 0x19, 0x60,
+    0x00, 0x00, 0x00, 0xCC, 0x00, 0x00, 0x00, 0x36, 0x68, 0x68, 0x65, 0x61,
+    0x05, 0x7A, 0x01, 0xF6, 0x00, 0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x24,
+    0x68, 0x6D, 0x74, 0x78, 0x02, 0xBC, 0x00, 0x64, 0x00, 0x00, 0x01, 0xA8,
+    0x00, 0x00, 0x00, 0x06, 0x6C, 0x6F, 0x63, 0x61, 0x00, 0x1D, 0x00, 0x0D,
+    0x00, 0x00, 0x01, 0xF0, 0x00, 0x00, 0x00, 0x06, 0x6D, 0x61, 0x78, 0x70,
+    0x00, 0x0D, 0x00, 0x0D, 0x00, 0x00, 0x01, 0x28, 0x00, 0x00, 0x00, 0x20,
+    0x6E, 0x61, 0x6D, 0x65, 0xA6, 0x79, 0x8D, 0x0A, 0x00, 0x00, 0x02, 0x34,
+    0x00, 0x00, 0x00, 0x66, 0x70, 0x6F, 0x73, 0x74, 0x00, 0x28, 0x00, 0x00,
+    0x00, 0x00, 0x02, 0x9C, 0x00, 0x00, 0x00, 0x26, 0x70, 0x72, 0x65, 0x70,
+    0xB0, 0x00, 0x2B, 0x00, 0x00, 0x00, 0x01, 0xEC, 0x00, 0x00, 0x00, 0x03,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x8A, 0x2B, 0x38, 0x4E,
+    0x5F, 0x0F, 0x3C, 0xF5, 0x00, 0x03, 0x03, 0xE8, 0x00, 0x00, 0x00, 0x00,
+    0xE6, 0xF8, 0x6A, 0xE2, 0x00, 0x00, 0x00, 0x00, 0xE6, 0xF8, 0x6A, 0xE2,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x00, 0x00, 0x03,
+    0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x03, 0x20, 0xFF, 0x38, 0x00, 0x00, 0x02, 0x58, 0x00, 0x64, 0x00, 0x64,
+    0x01, 0xF4, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x08,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x02, 0x58, 0x01, 0x90, 0x00, 0x05,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x3F, 0x3F, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x41, 0x00, 0x41,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x20, 0x00, 0x00, 0x02, 0x58, 0x00, 0x64, 0x00, 0x64, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x14,
+    0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x14, 0x00, 0x04, 0x00, 0x20,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x41,
+    0xFF, 0xFF, 0x00, 0x00, 0x00, 0x41, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0xB0, 0x00, 0x2C, 0xB0, 0x01, 0x2F, 0x2D, 0x00,
+    0xB0, 0x00, 0x2B, 0x00, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x1D, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC, 0x00, 0x03,
+    0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD,
+    0x44, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xF4, 0x02, 0xBC,
+    0x00, 0x03, 0x00, 0x06, 0xB0, 0x00, 0x2B, 0xB0, 0x02, 0x2F, 0x33, 0x11,
+    0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xBC, 0xFD, 0x44, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x36, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x07, 0x00, 0x09, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09,
+    0x00, 0x01, 0x00, 0x12, 0x00, 0x10, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09,
+    0x00, 0x02, 0x00, 0x0E, 0x00, 0x22, 0x53, 0x69, 0x7A, 0x65, 0x53, 0x74,
+    0x61, 0x74, 0x65, 0x52, 0x65, 0x67, 0x75, 0x6C, 0x61, 0x72, 0x00, 0x53,
+    0x00, 0x69, 0x00, 0x7A, 0x00, 0x65, 0x00, 0x53, 0x00, 0x74, 0x00, 0x61,
+    0x00, 0x74, 0x00, 0x65, 0x00, 0x52, 0x00, 0x65, 0x00, 0x67, 0x00, 0x75,
+    0x00, 0x6C, 0x00, 0x61, 0x00, 0x72, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00
+  };
+
+
+static int
+load_x( FT_Face   face,
+        FT_UInt   ppem,
+        FT_Pos   *x )
+{
+  FT_Error  error;
+
+
+  error = FT_Set_Pixel_Sizes( face, 0, ppem );
+  if ( !error )
+    error = FT_Load_Glyph( face, 1, FT_LOAD_NO_BITMAP );
+  if ( error )
+  {
+    fprintf( stderr, "error %d at %u ppem\n", error, ppem );
+    return 1;
+  }
+
+  *x = face->glyph->outline.points[0].x;
+  return 0;
+}
+
+
+int
+main( void )
+{
+  static const FT_UInt  sizes[] = { 12, 16, 12, 16, 23, 12 };
+
+  FT_Library  library;
+  FT_Face     face;
+  FT_Face     fresh;
+  FT_Pos      x, expected;
+  size_t      i;
+  int         result = 0;
+
+
+  if ( FT_Init_FreeType( &library ) )
+    return 1;
+
+  if ( FT_New_Memory_Face( library, font_data, sizeof ( font_data ),
+                           0, &face ) )
+  {
+    fprintf( stderr, "Could not open the test font\n" );
+    return 1;
+  }
+
+  /* switching back to a known size reuses its saved states; */
+  /* the result must match that of a newly opened face        */
+  for ( i = 0; i < sizeof ( sizes ) / sizeof ( sizes[0] ); i++ )
+  {
+    if ( FT_New_Memory_Face( library, font_data, sizeof ( font_data ),
+                             0, &fresh ) )
+      return 1;
+
+    if ( load_x( face, sizes[i], &x )         ||
+         load_x( fresh, sizes[i], &expected ) )
+      result = 1;
+    else if ( x != expected )
+    {
+      printf( "%u ppem: got x = %ld, expected %ld\n",
+              sizes[i], x, expected );
+      result = 1;
+    }
+
+    FT_Done_Face( fresh );
+  }
+
+  FT_Done_Face( face );
+  FT_Done_FreeType( library );
+
+  return result;
+}
+
+/* EOF */
@@ -33,6 +33,7 @@
 #include <freetype/ftoutln.h>
 #include <freetype/ftstroke.h>
 #include <freetype/ftsynth.h>
+#include <freetype/internal/ftobjs.h>   /* for `lcd_geometry' */
 
 #ifdef UNIX
 #include <unistd.h>
@@ -121,6 +122,7 @@
     FT_BENCH_GET_BBOX,
     FT_BENCH_GET_CBOX,
     FT_BENCH_NEW_FACE_AND_LOAD_GLYPH,
+    FT_BENCH_RENDER_LCD_CHECK,
     N_FT_BENCH
   };
 
@@ -140,6 +142,7 @@
     "get glyph cbox      (FT_Glyph_Get_CBox)",
 
     "open face and load glyphs",
+    "compare LCD rendering with three-pass reference",
     NULL
   };
 
@@ -170,6 +173,14 @@
   static char  ps_hinting_engine_names[2][10] = { "freetype",
                                                   "adobe" };
 
+  /* the default subpixel geometry of the smooth renderer */
+  static FT_Vector  lcd_geometry[3] = { { -18, -11 },
+                                        {   2,  22 },
+                                        {  16, -11 } };
+  static int        lcd_mismatches;
+
+  static int  profile_interpreter;
+
 
   /*
    * Dummy face requester (the face object is already loaded)
@@ -306,6 +317,122 @@
   }
 
 
+  /*
+   * TrueType interpreter profile
+   */
+
+#define PROFILE_TOP  16
+
+  static FT_ULong
+  profile_clock( void*  clock_data )
+  {
+    FT_UNUSED( clock_data );
+
+    return (FT_ULong)get_time();
+  }
+
+
+  /* print the indices of the `PROFILE_TOP' largest non-zero counts */
+  static void
+  print_profile_top( const char*      title,
+                     const char*      format,
+                     const FT_ULong*  counts,
+                     unsigned int     num_counts )
+  {
+    unsigned int  shown[PROFILE_TOP];
+    unsigned int  num_shown, i, j;
+
+
+    printf( "\n"
+            "  %s:\n", title );
+
+    for ( num_shown = 0; num_shown < PROFILE_TOP; num_shown++ )
+    {
+      unsigned int  best = num_counts;
+
+
+      for ( i = 0; i < num_counts; i++ )
+      {
+        if ( !counts[i] )
+          continue;
+
+        for ( j = 0; j < num_shown; j++ )
+          if ( shown[j] == i )
+            break;
+        if ( j < num_shown )
+          continue;
+
+        if ( best == num_counts || counts[i] > counts[best] )
+          best = i;
+      }
+
+      if ( best == num_counts )
+        break;
+
+      shown[num_shown] = best;
+
+      printf( "    " );
+      printf( format, best );
+      printf( " %12lu\n", counts[best] );
+    }
+
+    if ( !num_shown )
+      printf( "    none\n" );
+  }
+
+
+  static void
+  print_interpreter_profile( void )
+  {
+    FT_Prop_InterpreterProfile  prof;
+
+    static const char*  program_names[TT_PROFILE_PROGRAM_MAX] =
+    {
+      "fpgm",
+      "prep",
+      "glyph"
+    };
+    int  i;
+
+
+    if ( FT_Property_Get( lib, "truetype", "interpreter-profile", &prof ) )
+      return;
+
+    printf( "\n"
+            "TrueType interpreter profile:\n"
+            "\n"
+            "  program        runs  instructions     time (us)   us/run\n" );
+
+    for ( i = 0; i < TT_PROFILE_PROGRAM_MAX; i++ )
+      printf( "  %-7s %11lu  %12lu  %12lu  %7.3f\n",
+              program_names[i],
+              prof.program_runs[i],
+              prof.program_counts[i],
+              prof.program_times[i],
+              prof.program_runs[i]
+                ? (double)prof.program_times[i] /
+                    (double)prof.program_runs[i]
+                : 0.0 );
+
+    printf( "\n"
+            "  longest glyph program: %luus\n"
+            "  maximum stack depth: %u\n"
+            "  maximum call depth: %u\n",
+            prof.max_glyph_time,
+            prof.max_stack_depth,
+            prof.max_call_depth );
+
+    print_profile_top( "most frequent opcodes",
+                       "0x%02X    ",
+                       prof.opcode_counts,
+                       256 );
+    print_profile_top( "most busy functions",
+                       "FDEF %-5u",
+                       prof.function_counts,
+                       prof.num_functions );
+  }
+
+
   /*
    * Various tests
    */
@@ -772,6 +899,200 @@
   }
 
 
+  /*
+   * Reference LCD rendering: rasterize the outline three times with
+   * shifts given by the subpixel geometry, as the smooth renderer did
+   * before it handled all channels in a single raster pass.
+   */
+
+  typedef struct  blcd_target_
+  {
+    unsigned char*  origin;
+    int             pitch;
+
+  } blcd_target;
+
+
+  static void
+  lcd_spans( int             y,
+             int             count,
+             const FT_Span*  spans,
+             void*           user )
+  {
+    blcd_target*    target   = (blcd_target*)user;
+    unsigned char*  dst_line = target->origin - y * target->pitch;
+    unsigned char*  dst;
+    unsigned short  w;
+
+
+    for ( ; count--; spans++ )
+      for ( dst = dst_line + spans->x * 3, w = spans->len; w--; dst += 3 )
+        *dst = spans->coverage;
+  }
+
+
+  static FT_Error
+  render_lcd_three_pass( FT_Outline*  outline,
+                         FT_Bitmap*   bitmap )
+  {
+    FT_Vector*  sub   = lcd_geometry;
+    FT_Error    error = FT_Err_Ok;
+    FT_Bitmap   map   = *bitmap;
+    FT_Pos      x = 0, y = 0;
+    int         c;
+
+    FT_Raster_Params  params;
+    blcd_target       target;
+
+
+    params.source = outline;
+
+    if ( bitmap->pixel_mode == FT_PIXEL_MODE_LCD )
+    {
+      params.flags      = FT_RASTER_FLAG_AA   |
+                          FT_RASTER_FLAG_DIRECT |
+                          FT_RASTER_FLAG_CLIP;
+      params.gray_spans = lcd_spans;
+      params.user       = &target;
+
+      params.clip_box.xMin = 0;
+      params.clip_box.yMin = 0;
+      params.clip_box.xMax = bitmap->width / 3;
+      params.clip_box.yMax = bitmap->rows;
+
+      target.origin = bitmap->buffer;
+      if ( bitmap->pitch > 0 )
+        target.origin += ( bitmap->rows - 1 ) * (unsigned int)bitmap->pitch;
+      target.pitch  = bitmap->pitch;
+
+      for ( c = 0; c < 3 && !error; c++ )
+      {
+        FT_Outline_Translate( outline, x - sub[c].x, y - sub[c].y );
+        x = sub[c].x;
+        y = sub[c].y;
+
+        error = FT_Outline_Render( lib, outline, &params );
+
+        target.origin++;
+      }
+    }
+    else
+    {
+      /* render on each third row, rotating the geometry */
+      params.flags  = FT_RASTER_FLAG_AA;
+      params.target = &map;
+
+      map.pitch *= 3;
+      map.rows  /= 3;
+
+      for ( c = 0; c < 3 && !error; c++ )
+      {
+        FT_Outline_Translate( outline, x - sub[c].y, y + sub[c].x );
+        x = sub[c].y;
+        y = -sub[c].x;
+
+        error = FT_Outline_Render( lib, outline, &params );
+
+        map.buffer += bitmap->pitch;
+      }
+    }
+
+    FT_Outline_Translate( outline, x, y );
+
+    return error;
+  }
+
+
+  /* there is no public function to retrieve the current geometry */
+  static void
+  get_lcd_geometry( FT_Vector*  sub )
+  {
+#ifndef FT_CONFIG_OPTION_SUBPIXEL_RENDERING
+    memcpy( sub, lib->lcd_geometry, 3 * sizeof ( FT_Vector ) );
+#else
+    /* `FT_Library_SetLcdGeometry' is not available */
+    memset( sub, 0, 3 * sizeof ( FT_Vector ) );
+#endif
+  }
+
+
+  static int
+  test_render_lcd_check( btimer_t*  timer,
+                         FT_Face    face,
+                         void*      user_data )
+  {
+    FT_Render_Mode  mode = render_mode == FT_RENDER_MODE_LCD_V
+                             ? FT_RENDER_MODE_LCD_V
+                             : FT_RENDER_MODE_LCD;
+    FT_Outline      outline;
+    FT_Bitmap       bitmap;
+    FT_GlyphSlot    slot = face->glyph;
+    FT_Error        error;
+
+    int  i, done = 0;
+
+    FT_UNUSED( user_data );
+
+
+    FOREACH( i )
+    {
+      FT_Pos  x_shift, y_shift;
+      size_t  size;
+
+
+      if ( FT_Load_Glyph( face, (FT_UInt)i, load_flags ) ||
+           slot->format != FT_GLYPH_FORMAT_OUTLINE      )
+        continue;
+
+      if ( FT_Outline_New( lib,
+                           (FT_UInt)slot->outline.n_points,
+                           slot->outline.n_contours,
+                           &outline ) )
+        continue;
+
+      FT_Outline_Copy( &slot->outline, &outline );
+
+      if ( FT_Render_Glyph( slot, mode ) )
+        goto Next;
+
+      bitmap        = slot->bitmap;
+      size          = (size_t)bitmap.rows * (size_t)bitmap.pitch;
+      bitmap.buffer = (unsigned char*)calloc( 1, size ? size : 1 );
+      if ( !bitmap.buffer )
+        goto Next;
+
+      /* place the outline as `ft_smooth_render' does */
+      x_shift = -64 * slot->bitmap_left;
+      y_shift = -64 * slot->bitmap_top;
+      if ( mode == FT_RENDER_MODE_LCD_V )
+        y_shift += 64 * (FT_Int)bitmap.rows / 3;
+      else
+        y_shift += 64 * (FT_Int)bitmap.rows;
+
+      FT_Outline_Translate( &outline, x_shift, y_shift );
+
+      TIMER_START( timer );
+      error = render_lcd_three_pass( &outline, &bitmap );
+      TIMER_STOP( timer );
+
+      if ( !error )
+      {
+        if ( !size || !memcmp( bitmap.buffer, slot->bitmap.buffer, size ) )
+          done++;
+        else
+          lcd_mismatches++;
+      }
+
+      free( bitmap.buffer );
+
+    Next:
+      FT_Outline_Done( lib, &outline );
+    }
+
+    return done;
+  }
+
+
   /*
    * main
    */
@@ -945,6 +1266,8 @@
              dflt_tt_interpreter_version,
              CACHE_SIZE );
     fprintf( stderr,
+      "  -P        Profile the TrueType bytecode interpreter and print\n"
+      "            the results after all tests.\n"
       "  -p        Preload font file in memory.\n"
       "  -r N      Set render mode to N\n"
       "              0: normal, 1: light, 2: mono, 3: LCD, 4: LCD vertical\n"
@@ -1067,7 +1390,7 @@
       int  opt;
 
 
-      opt = getopt( argc, argv, "b:Cc:f:H:I:i:l:m:pr:s:t:v" );
+      opt = getopt( argc, argv, "b:Cc:f:H:I:i:l:m:pPr:s:t:v" );
 
       if ( opt == -1 )
         break;
@@ -1179,6 +1502,10 @@
         preload = 1;
         break;
 
+      case 'P':
+        profile_interpreter = 1;
+        break;
+
       case 'r':
         {
           int  rm = atoi( optarg );
@@ -1239,6 +1566,25 @@
 
     filename = *argv;
 
+    if ( profile_interpreter )
+    {
+      FT_Prop_InterpreterProfiling  profiling;
+
+
+      profiling.enable     = 1;
+      profiling.clock      = profile_clock;
+      profiling.clock_data = NULL;
+
+      if ( FT_Property_Set( lib,
+                            "truetype",
+                            "interpreter-profiling", &profiling ) )
+      {
+        fprintf( stderr,
+                 "warning: couldn't enable TT interpreter profiling\n" );
+        profile_interpreter = 0;
+      }
+    }
+
     if ( get_face( &face ) )
       goto Exit;
 
@@ -1477,9 +1823,40 @@
         test.bench = test_new_face_and_load_glyph;
         benchmark( face, &test, max_iter, max_time );
         break;
+
+      case FT_BENCH_RENDER_LCD_CHECK:
+        test.title = "Render LCD (3-pass)";
+        test.bench = test_render_lcd_check;
+        if ( !size )
+          printf( "  %-25s disabled (size = 0)\n", test.title );
+        else
+        {
+          FT_Vector  saved_geometry[3];
+
+
+          get_lcd_geometry( saved_geometry );
+
+          if ( FT_Library_SetLcdGeometry( lib, lcd_geometry ) )
+            printf( "  %-25s disabled (no LCD geometry)\n", test.title );
+          else
+          {
+            lcd_mismatches = 0;
+            benchmark( face, &test, max_iter, max_time );
+            if ( lcd_mismatches )
+              printf( "  %-25s %d glyph bitmaps differ\n",
+                      "", lcd_mismatches );
+
+            /* don't let the following tests see our geometry */
+            FT_Library_SetLcdGeometry( lib, saved_geometry );
+          }
+        }
+        break;
       }
     }
 
+    if ( profile_interpreter )
+      print_interpreter_profile();
+
   Exit:
     /* The following is a bit subtle: When we call FTC_Manager_Done, this
      * normally destroys all FT_Face objects that the cache might have